@@ -9,10 +9,12 @@
 #include "nlohmann/json.hpp"
 #include "utils.hpp"
 
+#include <cassert>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <regex>
 #include <unordered_map>
 #include <unordered_set>
@@ -33,8 +35,6 @@ constexpr std::uint32_t COST_TELEPORTATION =
     2 * COST_CNOT_GATE + COST_MEASUREMENT + 4 * COST_SINGLE_QUBIT_GATE;
 constexpr std::uint32_t COST_DIRECTION_REVERSE = 4 * COST_SINGLE_QUBIT_GATE;
 
-constexpr std::uint16_t MAX_DEVICE_QUBITS = 128;
-
 class Architecture {
 public:
   class Properties {
@@ -254,17 +254,60 @@ public:
            couplingMap.find({edge.second, edge.first}) != couplingMap.end();
   }
 
-  CouplingMap& getCurrentTeleportations() { return currentTeleportations; }
-  std::vector<std::pair<std::int16_t, std::int16_t>>& getTeleportationQubits() {
-    return teleportationQubits;
+  /**
+   * @brief contiguous range of edges of the coupling map
+   */
+  struct EdgeRange {
+    const Edge* first = nullptr;
+    const Edge* last  = nullptr;
+
+    [[nodiscard]] const Edge* begin() const { return first; }
+    [[nodiscard]] const Edge* end() const { return last; }
+    [[nodiscard]] bool        empty() const { return first == last; }
+    [[nodiscard]] std::size_t size() const {
+      return static_cast<std::size_t>(last - first);
+    }
+  };
+
+  /**
+   * @brief all edges of the coupling map incident to the given physical qubit
+   * (in either direction), in the same order as in the coupling map
+   *
+   * The lists of all qubits are precomputed whenever the coupling map changes
+   * and stored contiguously (compressed sparse row format), so that the
+   * neighborhood of a qubit can be enumerated in O(degree).
+   */
+  [[nodiscard]] EdgeRange getIncidentEdges(const std::uint16_t q) const {
+    if (static_cast<std::size_t>(q) + 1U >= incidentEdgeOffsets.size()) {
+      return {};
+    }
+    return {incidentEdges.data() + incidentEdgeOffsets[q],
+            incidentEdges.data() + incidentEdgeOffsets[q + 1U]};
   }
 
+  /**
+   * @brief computes the distances between all pairs of qubits if the given
+   * teleportations (i.e. edges between qubits which are not coupled, but can
+   * exchange states via teleportation qubits) are available in addition to
+   * the coupling map (by a BFS from every qubit over the adjacency lists)
+   *
+   * The distance is based on the shortest paths (in the number of edges, where
+   * coupled and teleportation edges may be used in either direction). With
+   * `n` edges on the shortest paths, it is
+   * - `(n - 1) * 7` if any shortest path traverses an edge of the coupling map
+   *   in its direction,
+   * - `7` if the qubits are only connected by a teleportation,
+   * - `(n - 1) * 7 + 4` otherwise.
+   */
+  [[nodiscard]] Matrix
+  createTeleportationDistanceTable(const CouplingMap& teleportations) const;
+
   [[nodiscard]] const Matrix&
   getDistanceTable(bool includeReversalCost = true) const {
     if (includeReversalCost) {
-      return distanceTableReversals;
+      return distances->distanceTableReversals;
     }
-    return distanceTable;
+    return distances->distanceTable;
   }
 
   [[nodiscard]] const Properties& getProperties() const { return properties; }
@@ -276,13 +319,27 @@ public:
     createFidelityTable();
   }
 
+  /**
+   * @brief applies a calibration update, i.e. overwrites the given properties
+   * (keeping all properties not contained in `changes`)
+   *
+   * Instead of rebuilding all fidelity tables, only the costs of edges whose
+   * error rates (or those of their qubits) changed are recomputed, and only
+   * the rows of the fidelity distance tables which may be affected by these
+   * edges are repaired (see `Dijkstra::updateEdgeSkipTable`). The resulting
+   * tables are the same as after `setProperties` with the merged properties.
+   *
+   * @param changes changed error rates (and other calibration data)
+   */
+  void updateProperties(const Properties& changes);
+
   [[nodiscard]] bool isFidelityAvailable() const { return fidelityAvailable; }
 
   [[nodiscard]] const std::vector<Matrix>& getFidelityDistanceTables() const {
     if (!fidelityAvailable) {
       throw QMAPException("No fidelity data available.");
     }
-    return fidelityDistanceTables;
+    return fidelities->fidelityDistanceTables;
   }
 
   [[nodiscard]] const Matrix&
@@ -290,12 +347,11 @@ public:
     if (!fidelityAvailable) {
       throw QMAPException("No fidelity data available.");
     }
-    if (skipEdges >= fidelityDistanceTables.size()) {
-      const static Matrix DEFAULT_MATRIX(nqubits,
-                                         std::vector<double>(nqubits, 0.0));
+    if (skipEdges >= fidelities->fidelityDistanceTables.size()) {
+      const static Matrix DEFAULT_MATRIX(nqubits, nqubits, 0.0);
       return DEFAULT_MATRIX;
     }
-    return fidelityDistanceTables.at(skipEdges);
+    return fidelities->fidelityDistanceTables.at(skipEdges);
   }
 
   [[nodiscard]] const Matrix& getFidelityDistanceTable() const {
@@ -313,10 +369,10 @@ public:
     if (q2 >= nqubits) {
       throw QMAPException("Qubit out of range.");
     }
-    if (skipEdges >= fidelityDistanceTables.size()) {
+    if (skipEdges >= fidelities->fidelityDistanceTables.size()) {
       return 0.;
     }
-    return fidelityDistanceTables.at(skipEdges).at(q1).at(q2);
+    return fidelities->fidelityDistanceTables[skipEdges](q1, q2);
   }
 
   [[nodiscard]] double fidelityDistance(std::uint16_t q1,
@@ -328,21 +384,21 @@ public:
     if (!fidelityAvailable) {
       throw QMAPException("No fidelity data available.");
     }
-    return fidelityTable;
+    return fidelities->fidelityTable;
   }
 
   [[nodiscard]] const std::vector<double>& getSingleQubitFidelities() const {
     if (!fidelityAvailable) {
       throw QMAPException("No fidelity data available.");
     }
-    return singleQubitFidelities;
+    return fidelities->singleQubitFidelities;
   }
 
   [[nodiscard]] const std::vector<double>& getSingleQubitFidelityCosts() const {
     if (!fidelityAvailable) {
       throw QMAPException("No fidelity data available.");
     }
-    return singleQubitFidelityCosts;
+    return fidelities->singleQubitFidelityCosts;
   }
 
   [[nodiscard]] double getSingleQubitFidelityCost(std::uint16_t qbit) const {
@@ -352,14 +408,14 @@ public:
     if (qbit >= nqubits) {
       throw QMAPException("Qubit out of range.");
     }
-    return singleQubitFidelityCosts.at(qbit);
+    return fidelities->singleQubitFidelityCosts[qbit];
   }
 
   [[nodiscard]] const Matrix& getTwoQubitFidelityCosts() const {
     if (!fidelityAvailable) {
       throw QMAPException("No fidelity data available.");
     }
-    return twoQubitFidelityCosts;
+    return fidelities->twoQubitFidelityCosts;
   }
 
   [[nodiscard]] double getTwoQubitFidelityCost(std::uint16_t q1,
@@ -373,14 +429,14 @@ public:
     if (q2 >= nqubits) {
       throw QMAPException("Qubit out of range.");
     }
-    return twoQubitFidelityCosts.at(q1).at(q2);
+    return fidelities->twoQubitFidelityCosts(q1, q2);
   }
 
   [[nodiscard]] const Matrix& getSwapFidelityCosts() const {
     if (!fidelityAvailable) {
       throw QMAPException("No fidelity data available.");
     }
-    return swapFidelityCosts;
+    return fidelities->swapFidelityCosts;
   }
 
   [[nodiscard]] double getSwapFidelityCost(std::uint16_t q1,
@@ -394,7 +450,7 @@ public:
     if (q2 >= nqubits) {
       throw QMAPException("Qubit out of range.");
     }
-    return swapFidelityCosts.at(q1).at(q2);
+    return fidelities->swapFidelityCosts(q1, q2);
   }
 
   /** true if the coupling map contains no unidirectional edges */
@@ -410,33 +466,56 @@ public:
     return !(name.empty()) && !properties.empty();
   }
 
+  /**
+   * @brief version of the binary format of the table cache (entries of other
+   * versions are ignored and overwritten)
+   */
+  static constexpr std::uint32_t TABLE_CACHE_VERSION = 1;
+
+  /**
+   * @brief enables a persistent cache of the derived tables of all
+   * architectures in the given directory (an empty path disables it)
+   *
+   * Whenever the distance tables of a coupling map, the fidelity tables of a
+   * coupling map with calibration data, or the coupling limit are computed,
+   * they are looked up in the directory first and stored there afterwards, so
+   * that later architectures (in this or other processes) with the same
+   * coupling map and error rates load them instead of recomputing them.
+   * Entries are binary files named by a hash of the coupling map and error
+   * rates, which are stored in the entry and compared on loading; unreadable
+   * or mismatching entries are recomputed.
+   */
+  static void setTableCacheDirectory(const std::string& directory);
+  [[nodiscard]] static std::string getTableCacheDirectory();
+
+  /**
+   * @brief number of threads computing the rows of the distance and fidelity
+   * tables of this architecture whenever they are (re)built afterwards (1 by
+   * default, i.e. sequentially; see `Dijkstra::PARALLEL_MIN_ROWS`)
+   */
+  void setTableThreads(const std::size_t nThreads) { tableThreads = nThreads; }
+  [[nodiscard]] std::size_t getTableThreads() const { return tableThreads; }
+
   void reset() {
     name    = "";
     nqubits = 0;
     couplingMap.clear();
-    distanceTable.clear();
-    distanceTableReversals.clear();
+    incidentEdgeOffsets.clear();
+    incidentEdges.clear();
+    distances        = std::make_shared<const DistanceTables>();
     isBidirectional  = true;
     isUnidirectional = true;
     properties.clear();
     fidelityAvailable = false;
-    fidelityTable.clear();
-    singleQubitFidelities.clear();
-    singleQubitFidelityCosts.clear();
-    twoQubitFidelityCosts.clear();
-    swapFidelityCosts.clear();
-    fidelityDistanceTables.clear();
+    fidelities        = std::make_shared<const FidelityTables>();
   }
 
   [[nodiscard]] double distance(std::uint16_t control, std::uint16_t target,
                                 bool includeReversalCost = true) const {
-    if (currentTeleportations.empty()) {
-      if (includeReversalCost) {
-        return distanceTableReversals.at(control).at(target);
-      }
-      return distanceTable.at(control).at(target);
-    }
-    return static_cast<double>(bfs(control, target, currentTeleportations));
+    const auto& table = includeReversalCost ? distances->distanceTableReversals
+                                            : distances->distanceTable;
+    assert(control < table.rows() && target < table.cols());
+    return table(control, target);
   }
 
   [[nodiscard]] std::set<std::uint16_t> getQubitSet() const {
@@ -449,9 +528,9 @@ public:
   }
 
   std::uint64_t minimumNumberOfSwaps(std::vector<std::uint16_t>& permutation,
-                                     std::int64_t                limit = -1);
+                                     std::int64_t limit = -1) const;
   void          minimumNumberOfSwaps(std::vector<std::uint16_t>& permutation,
-                                     std::vector<Edge>&          swaps);
+                                     std::vector<Edge>& swaps) const;
 
   struct Node {
     std::uint64_t                                    nswaps = 0U;
@@ -502,9 +581,13 @@ public:
 
 protected:
   std::string   name;
-  std::uint16_t nqubits               = 0;
-  CouplingMap   couplingMap           = {};
-  CouplingMap   currentTeleportations = {};
+  std::uint16_t nqubits     = 0;
+  CouplingMap   couplingMap = {};
+
+  /** `incidentEdges[incidentEdgeOffsets[q]:incidentEdgeOffsets[q + 1]]` are
+   * the edges incident to physical qubit `q` */
+  std::vector<std::size_t> incidentEdgeOffsets{};
+  std::vector<Edge>        incidentEdges{};
 
   /** true if the coupling map contains no unidirectional edges */
   bool isBidirectional = true;
@@ -514,27 +597,62 @@ protected:
   // unidirectional, and coupling maps containing both bidirectional and
   // unidirectional edges are neither bidirectional nor unidirectional
 
-  Matrix distanceTable          = {};
-  Matrix distanceTableReversals = {};
-  std::vector<std::pair<std::int16_t, std::int16_t>> teleportationQubits{};
-  Properties                                         properties        = {};
-  bool                                               fidelityAvailable = false;
-  Matrix                                             fidelityTable     = {};
-  std::vector<double>                                singleQubitFidelities = {};
-  std::vector<double> singleQubitFidelityCosts                             = {};
-  Matrix              twoQubitFidelityCosts                                = {};
-  Matrix              swapFidelityCosts                                    = {};
-  std::vector<Matrix> fidelityDistanceTables                               = {};
+  /**
+   * The tables derived from the coupling map and from the properties are
+   * immutable once they are computed, and every change of the coupling map or
+   * the properties replaces them by new tables. Hence, copies of an
+   * architecture share their tables (instead of copying them), and any number
+   * of mappers can read them concurrently without locking.
+   */
+  struct DistanceTables {
+    Matrix distanceTable          = {};
+    Matrix distanceTableReversals = {};
+  };
+  struct FidelityTables {
+    Matrix              fidelityTable            = {};
+    std::vector<double> singleQubitFidelities    = {};
+    std::vector<double> singleQubitFidelityCosts = {};
+    Matrix              twoQubitFidelityCosts    = {};
+    Matrix              swapFidelityCosts        = {};
+    std::vector<Matrix> fidelityDistanceTables   = {};
+  };
+
+  std::shared_ptr<const DistanceTables> distances =
+      std::make_shared<const DistanceTables>();
+  Properties                            properties        = {};
+  bool                                  fidelityAvailable = false;
+  std::shared_ptr<const FidelityTables> fidelities =
+      std::make_shared<const FidelityTables>();
+  /** see `setTableThreads` */
+  std::size_t tableThreads = 1;
 
   void createDistanceTable();
+  void createIncidentEdges();
   void createFidelityTable();
-
-  // added for teleportation
-  static bool contains(const std::vector<int>& v, const int e) {
-    return std::find(v.begin(), v.end(), e) != v.end();
-  }
-  [[nodiscard]] std::uint64_t bfs(std::uint16_t start, std::uint16_t goal,
-                                  const std::set<Edge>& teleportations) const;
+  /**
+   * @brief computes the fidelity costs of executing a 2Q-gate and a SWAP on
+   * an edge of the coupling map (from its error rate and, for unidirectional
+   * edges, those of its qubits)
+   */
+  void createEdgeFidelityCosts(FidelityTables& tables, std::uint16_t first,
+                               std::uint16_t second) const;
+
+  /**
+   * @brief the coupling map (and the error rates, if `includeProperties`)
+   * identifying an entry of the table cache
+   */
+  [[nodiscard]] std::string tableCacheKey(bool includeProperties) const;
+  /**
+   * @brief loads the distance tables (or fidelity tables) from the table
+   * cache
+   *
+   * @return false if there is no valid entry, in which case the tables have
+   * to be computed
+   */
+  bool loadDistanceTables(const std::string& directory);
+  bool loadFidelityTables(const std::string& directory);
+  void storeDistanceTables(const std::string& directory) const;
+  void storeFidelityTables(const std::string& directory) const;
 
   static std::size_t findCouplingLimit(const CouplingMap& cm,
                                        std::uint16_t      nQubits);
@@ -15,7 +15,8 @@
 
 class DataLogger {
 public:
-  DataLogger(std::string path, Architecture& arch, qc::QuantumComputation qc)
+  DataLogger(std::string path, const Architecture& arch,
+             qc::QuantumComputation qc)
       : dataLoggingPath(std::move(path)), architecture(&arch),
         nqubits(arch.getNqubits()), inputCircuit(std::move(qc)) {
     initLog();
@@ -35,7 +36,7 @@ public:
   void logSearchNode(std::size_t layer, std::size_t nodeId,
                      std::size_t parentId, double costFixed, double costHeur,
                      double lookaheadPenalty,
-                     const std::array<std::int16_t, MAX_DEVICE_QUBITS>& qubits,
+                     const std::vector<std::int16_t>& qubits,
                      bool validMapping, const std::vector<Exchange>& swaps,
                      std::size_t depth);
   void logFinalizeLayer(
@@ -43,11 +44,10 @@ public:
       const std::vector<std::uint16_t>& singleQubitMultiplicity,
       const std::map<std::pair<std::uint16_t, std::uint16_t>,
                      std::pair<std::uint16_t, std::uint16_t>>&
-                                                         twoQubitMultiplicity,
-      const std::array<std::int16_t, MAX_DEVICE_QUBITS>& initialLayout,
-      std::size_t finalNodeId, double finalCostFixed, double finalCostHeur,
-      double                                             finalLookaheadPenalty,
-      const std::array<std::int16_t, MAX_DEVICE_QUBITS>& finalLayout,
+                                       twoQubitMultiplicity,
+      const std::vector<std::int16_t>& initialLayout, std::size_t finalNodeId,
+      double finalCostFixed, double finalCostHeur, double finalLookaheadPenalty,
+      const std::vector<std::int16_t>& finalLayout,
       const std::vector<Exchange>& finalSwaps, std::size_t finalSearchDepth);
   void splitLayer();
   void logMappingResult(MappingResults& result);
@@ -67,7 +67,7 @@ public:
 
 protected:
   std::string                dataLoggingPath;
-  Architecture*              architecture;
+  const Architecture*        architecture;
   std::uint16_t              nqubits;
   qc::QuantumComputation     inputCircuit;
   qc::RegisterNames          qregs{};
@@ -11,6 +11,7 @@
 #include "configuration/Configuration.hpp"
 
 #include <array>
+#include <bitset>
 #include <chrono>
 #include <fstream>
 #include <iostream>
@@ -41,6 +42,47 @@ using TwoQubitMultiplicity =
  */
 using SingleQubitMultiplicity = std::vector<std::uint16_t>;
 
+/**
+ * set of logical qubits with one bit per qubit (e.g., the qubits acted on by
+ * gates in some layer)
+ *
+ * The set grows as needed, qubits beyond its current size are not contained.
+ */
+class QubitSet {
+public:
+  QubitSet() = default;
+  explicit QubitSet(const std::size_t nQubits)
+      : words((nQubits + WORD_BITS - 1) / WORD_BITS, 0U) {}
+
+  [[nodiscard]] bool test(const std::size_t q) const {
+    return q / WORD_BITS < words.size() &&
+           ((words[q / WORD_BITS] >> (q % WORD_BITS)) & 1U) != 0U;
+  }
+  void set(const std::size_t q) {
+    if (q / WORD_BITS >= words.size()) {
+      words.resize(q / WORD_BITS + 1, 0U);
+    }
+    words[q / WORD_BITS] |= std::uint64_t{1} << (q % WORD_BITS);
+  }
+  void reset(const std::size_t q) {
+    if (q / WORD_BITS < words.size()) {
+      words[q / WORD_BITS] &= ~(std::uint64_t{1} << (q % WORD_BITS));
+    }
+  }
+  void reset() { std::fill(words.begin(), words.end(), 0U); }
+  [[nodiscard]] std::size_t count() const {
+    std::size_t result = 0;
+    for (const auto word : words) {
+      result += std::bitset<WORD_BITS>(word).count();
+    }
+    return result;
+  }
+
+private:
+  static constexpr std::size_t WORD_BITS = 64;
+  std::vector<std::uint64_t>   words{};
+};
+
 constexpr std::int16_t DEFAULT_POSITION = -1;
 
 class Mapper {
@@ -66,14 +108,49 @@ protected:
     [[nodiscard]] bool singleQubit() const { return control == -1; }
   };
 
+  /**
+   * @brief Compact structure-of-arrays view of the gates in one layer
+   *
+   * Holds the same information as the corresponding entries of
+   * `twoQubitMultiplicities`, `activeQubits`, `activeQubits1QGates` and
+   * `activeQubits2QGates`, but in contiguous memory, so that the inner loops
+   * of the mapping heuristics do not need to walk node-based trees.
+   */
+  struct LayerView {
+    /**
+     * logical qubit pairs acted on by 2Q-gates in the layer in ascending order
+     * (i.e., in the iteration order of `TwoQubitMultiplicity`)
+     */
+    std::vector<Edge> edges{};
+    /**
+     * number of 2Q-gates acting on the corresponding pair in `edges` in each
+     * direction (see `TwoQubitMultiplicity`)
+     */
+    std::vector<std::pair<std::uint16_t, std::uint16_t>> multiplicities{};
+    /**
+     * fidelity cost of executing the gates on the corresponding pair in
+     * `edges` on the best physical edge of the architecture (only if fidelity
+     * data is available)
+     */
+    std::vector<double> bestEdgeCosts{};
+
+    QubitSet activeQubits{};
+    QubitSet activeQubits1QGates{};
+    QubitSet activeQubits2QGates{};
+  };
+
   /**
    * @brief The quantum circuit to be mapped
    */
   qc::QuantumComputation qc;
   /**
    * @brief The quantum architecture on which to map the circuit
+   *
+   * The architecture is only read by the mapper (all state of a mapping run is
+   * owned by the mapper), so that one architecture may be used by several
+   * mappers at the same time.
    */
-  Architecture* architecture;
+  const Architecture* architecture;
 
   /**
    * @brief The resulting quantum circuit after mapping
@@ -116,20 +193,37 @@ protected:
    */
   std::vector<std::set<std::uint16_t>> activeQubits2QGates{};
 
+  /**
+   * @brief For each layer a compact view of its 2Q-gates and active qubits
+   * (derived from the multiplicities and sets above by `updateLayerView`)
+   */
+  std::vector<LayerView> layerViews{};
+
+  /**
+   * @brief Index of the layer whose data is stored first in
+   * `singleQubitMultiplicities`, `twoQubitMultiplicities`, `activeQubits`,
+   * `activeQubits1QGates`, `activeQubits2QGates` and `layerViews`
+   *
+   * By default, the data of all layers is created with the layers, i.e. the
+   * index is 0. If the layers are streamed (see `Configuration::layerWindow`),
+   * only the data of a window of layers is held at a time (see `loadLayers`).
+   */
+  std::size_t layerWindowBegin = 0;
+
   /**
    * @brief containing the logical qubit currently mapped to each physical
    * qubit. `qubits[physical_qubit] = logical_qubit`
    *
    * The inverse of `locations`
    */
-  std::array<std::int16_t, MAX_DEVICE_QUBITS> qubits{};
+  std::vector<std::int16_t> qubits{};
   /**
    * @brief containing the logical qubit currently mapped to each physical
    * qubit. `locations[logical_qubit] = physical_qubit`
    *
    * The inverse of `qubits`
    */
-  std::array<std::int16_t, MAX_DEVICE_QUBITS> locations{};
+  std::vector<std::int16_t> locations{};
 
   MappingResults results{};
 
@@ -159,6 +253,65 @@ protected:
    */
   virtual void createLayers();
 
+  /**
+   * @brief Appends the multiplicities, active qubit sets and view of the layer
+   * at the given index (which has to directly follow the layers whose data is
+   * stored) to the data of the layers
+   *
+   * @param index the index of the layer
+   */
+  void appendLayerData(std::size_t index);
+
+  /**
+   * @brief Makes the data of the layers in `[first, last)` available (if the
+   * layers are streamed, see `Configuration::layerWindow`)
+   *
+   * The data of a window of at least `Configuration::layerWindow` layers
+   * containing the given ones is kept, and the data of all other layers is
+   * released. The window is moved into the direction of the given layers, so
+   * that the data of subsequent layers in the same direction is created in
+   * batches. Without streaming, the data of all layers is available anyway.
+   *
+   * @param first the index of the first layer
+   * @param last the index after the last layer (bounded by the number of
+   * layers)
+   */
+  void loadLayers(std::size_t first, std::size_t last);
+
+  /**
+   * @brief (Re-)builds the view of the layer at the given index from the
+   * multiplicities and active qubit sets of the layer
+   *
+   * @param index the index of the layer
+   */
+  void updateLayerView(std::size_t index);
+
+  /**
+   * @brief The number of 1Q-gates acting on each logical qubit in the layer
+   * at the given index (which has to be loaded, see `loadLayers`)
+   */
+  [[nodiscard]] const SingleQubitMultiplicity&
+  getSingleQubitMultiplicity(const std::size_t index) const {
+    return singleQubitMultiplicities.at(index - layerWindowBegin);
+  }
+
+  /**
+   * @brief The number of 2Q-gates acting on each pair of logical qubits in the
+   * layer at the given index (which has to be loaded, see `loadLayers`)
+   */
+  [[nodiscard]] const TwoQubitMultiplicity&
+  getTwoQubitMultiplicity(const std::size_t index) const {
+    return twoQubitMultiplicities.at(index - layerWindowBegin);
+  }
+
+  /**
+   * @brief The compact view of the layer at the given index (which has to be
+   * loaded, see `loadLayers`)
+   */
+  [[nodiscard]] const LayerView& getLayerView(const std::size_t index) const {
+    return layerViews.at(index - layerWindowBegin);
+  }
+
   /**
    * @brief Returns true if the layer at the given index can be split into two
    * without resulting in an empty layer (assuming the original layer only has
@@ -177,7 +330,7 @@ protected:
    * @param index the index of the layer to be split
    * @param arch architecture on which the circuit is mapped
    */
-  virtual void splitLayer(std::size_t index, Architecture& arch);
+  virtual void splitLayer(std::size_t index, const Architecture& arch);
 
   /**
    * gates are put in the last layer (from the back of the circuit) in which
@@ -193,7 +346,7 @@ protected:
    * layering is performed on these blocks
    */
   void processDisjointQubitLayer(
-      std::array<std::optional<std::size_t>, MAX_DEVICE_QUBITS>& lastLayer,
+      std::vector<std::optional<std::size_t>>& lastLayer,
       const std::optional<std::uint16_t>& control, std::uint16_t target,
       qc::Operation* gate);
 
@@ -208,7 +361,7 @@ protected:
    * @param gate the gate to be added to the layer
    */
   void processDisjoint2qBlockLayer(
-      std::array<std::optional<std::size_t>, MAX_DEVICE_QUBITS>& lastLayer,
+      std::vector<std::optional<std::size_t>>& lastLayer,
       const std::optional<std::uint16_t>& control, std::uint16_t target,
       qc::Operation* gate);
 
@@ -266,7 +419,8 @@ protected:
   virtual void postMappingOptimizations(const Configuration& config);
 
 public:
-  Mapper(qc::QuantumComputation quantumComputation, Architecture& architecture);
+  Mapper(qc::QuantumComputation quantumComputation,
+         const Architecture&    architecture);
   virtual ~Mapper() = default;
 
   /**
@@ -316,6 +470,11 @@ public:
 
   virtual MappingResults& getResults() { return results; }
 
+  /**
+   * @brief the circuit resulting from the last call of `map`
+   */
+  virtual qc::QuantumComputation& getMappedCircuit() { return qcMapped; }
+
   virtual nlohmann::json json() { return results.json(); }
 
   virtual std::string csv() { return results.csv(); }
@@ -354,11 +513,17 @@ public:
   }
 
   virtual void reset() {
-    architecture->reset();
     qc.reset();
     layers.clear();
-    qubits.fill(DEFAULT_POSITION);
-    locations.fill(DEFAULT_POSITION);
+    singleQubitMultiplicities.clear();
+    twoQubitMultiplicities.clear();
+    activeQubits.clear();
+    activeQubits1QGates.clear();
+    activeQubits2QGates.clear();
+    layerViews.clear();
+    layerWindowBegin = 0;
+    qubits.clear();
+    locations.clear();
 
     results = MappingResults();
   }
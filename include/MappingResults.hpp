@@ -38,6 +38,14 @@ struct MappingResults {
     double      secondsPerNode           = 0.;
     double      averageBranchingFactor   = 0.;
     double      effectiveBranchingFactor = 0.;
+    // maximum memory (in bytes) used by the search nodes of any layer
+    std::size_t peakMemory = 0;
+    // number of layers routed per second (including layers split during the
+    // search)
+    double layersPerSecond = 0.;
+    // number of layers which were satisfied by the mapping of the previous
+    // layer without any search (see `Configuration::warmStartSearch`)
+    std::size_t skippedLayers = 0;
 
     [[nodiscard]] nlohmann::json json() const {
       nlohmann::json resultJSON{};
@@ -46,6 +54,9 @@ struct MappingResults {
       resultJSON["seconds_per_node"]           = secondsPerNode;
       resultJSON["average_branching_factor"]   = averageBranchingFactor;
       resultJSON["effective_branching_factor"] = effectiveBranchingFactor;
+      resultJSON["peak_memory"]                = peakMemory;
+      resultJSON["layers_per_second"]          = layersPerSecond;
+      resultJSON["skipped_layers"]             = skippedLayers;
       return resultJSON;
     }
   };
@@ -62,6 +73,10 @@ struct MappingResults {
     double      averageBranchingFactor            = 0.;
     double      effectiveBranchingFactor          = 0.;
     bool        earlyTermination                  = false;
+    // maximum memory (in bytes) used by the search nodes of this layer
+    std::size_t peakMemory = 0;
+    // number of times the search was pruned to stay within the memory budget
+    std::size_t prunings = 0;
 
     [[nodiscard]] nlohmann::json json() const {
       nlohmann::json resultJSON{};
@@ -79,6 +94,48 @@ struct MappingResults {
       resultJSON["average_branching_factor"]   = averageBranchingFactor;
       resultJSON["effective_branching_factor"] = effectiveBranchingFactor;
       resultJSON["early_termination"]          = earlyTermination;
+      resultJSON["peak_memory"]                = peakMemory;
+      resultJSON["prunings"]                   = prunings;
+      return resultJSON;
+    }
+  };
+
+  struct PortfolioInfo {
+    // outcome of the run: "finished", "cancelled" (it could no longer beat a
+    // finished run) or "failed"
+    std::string status{};
+    // wall-clock time (in seconds) until the run finished or was stopped
+    double time = 0.;
+    // whether the result of this run was selected
+    bool selected = false;
+
+    // costs of the result (only meaningful for finished runs)
+    std::size_t swaps            = 0;
+    std::size_t teleportations   = 0;
+    std::size_t gates            = 0;
+    double      totalLogFidelity = 0.;
+    // whether the run hit the shared budget and returned a degraded result
+    // (see `MappingResults::timeout`)
+    bool timeout = false;
+
+    // reason why the run failed
+    std::string error{};
+
+    [[nodiscard]] nlohmann::json json() const {
+      nlohmann::json resultJSON{};
+      resultJSON["status"]   = status;
+      resultJSON["time"]     = time;
+      resultJSON["selected"] = selected;
+      if (status == "finished") {
+        resultJSON["swaps"]              = swaps;
+        resultJSON["teleportations"]     = teleportations;
+        resultJSON["gates"]              = gates;
+        resultJSON["total_log_fidelity"] = totalLogFidelity;
+        resultJSON["timeout"]            = timeout;
+      }
+      if (!error.empty()) {
+        resultJSON["error"] = error;
+      }
       return resultJSON;
     }
   };
@@ -98,6 +155,12 @@ struct MappingResults {
 
   HeuristicBenchmarkInfo                   heuristicBenchmark{};
   std::vector<LayerHeuristicBenchmarkInfo> layerHeuristicBenchmark{};
+  // one entry per configuration of the portfolio mapper
+  std::vector<PortfolioInfo> portfolio{};
+  // layers of the heuristic mapper whose search was stopped by the deadline
+  // (see `Configuration::timeout`) before any valid mapping was found, i.e.
+  // which were routed greedily along shortest paths
+  std::vector<std::size_t> degradedLayers{};
 
   MappingResults()          = default;
   virtual ~MappingResults() = default;
@@ -110,6 +173,8 @@ struct MappingResults {
     wcnf                    = mappingResults.wcnf;
     heuristicBenchmark      = mappingResults.heuristicBenchmark;
     layerHeuristicBenchmark = mappingResults.layerHeuristicBenchmark;
+    portfolio               = mappingResults.portfolio;
+    degradedLayers          = mappingResults.degradedLayers;
   }
 
   [[nodiscard]] std::string toString() const { return json().dump(2); }
@@ -149,9 +214,20 @@ struct MappingResults {
       if (config.includeWCNF && !wcnf.empty()) {
         stats["WCNF"] = wcnf;
       }
-    } else if (config.method == Method::Heuristic) {
-      stats["teleportations"] = output.teleportations;
-      stats["benchmark"]      = heuristicBenchmark.json();
+    } else if (config.method == Method::Heuristic ||
+               config.method == Method::Sabre) {
+      stats["teleportations"]  = output.teleportations;
+      stats["benchmark"]       = heuristicBenchmark.json();
+      stats["degraded_layers"] = degradedLayers;
+    } else if (config.method == Method::Portfolio) {
+      stats["teleportations"]  = output.teleportations;
+      stats["benchmark"]       = heuristicBenchmark.json();
+      stats["degraded_layers"] = degradedLayers;
+      auto& members           = stats["portfolio"];
+      members                 = nlohmann::json::array();
+      for (const auto& member : portfolio) {
+        members.push_back(member.json());
+      }
     }
     stats["additional_gates"] =
         static_cast<std::make_signed_t<decltype(output.gates)>>(output.gates) -
@@ -13,10 +13,12 @@
 #include "Layering.hpp"
 #include "LookaheadHeuristic.hpp"
 #include "Method.hpp"
+#include "SearchEngine.hpp"
 #include "SwapReduction.hpp"
 #include "nlohmann/json.hpp"
 
 #include <set>
+#include <vector>
 
 // NOLINTNEXTLINE(clang-analyzer-optin.performance.Padding)
 struct Configuration {
@@ -45,6 +47,9 @@ struct Configuration {
 
   // initial layout to use for heuristic approach
   InitialLayout initialLayout = InitialLayout::Dynamic;
+  // time budget (in ms) of the embedding search of
+  // `InitialLayout::GraphIsomorphism` (also bounded by `timeout`)
+  std::size_t initialLayoutTimeout = 1000;
 
   // iterative bidirectional routing, i.e. after an initial layout is found,
   // the circuit is routed multiple times back and forth (using settings
@@ -58,6 +63,12 @@ struct Configuration {
   // https://arxiv.org/abs/1809.02573
   bool        iterativeBidirectionalRouting       = false;
   std::size_t iterativeBidirectionalRoutingPasses = 0;
+  // number of independent chains of iterative bidirectional routing passes,
+  // each starting from a different initial layout (the configured one and
+  // random ones) and running concurrently on `nThreads` threads; a chain stops
+  // early once the number of swaps estimated for its layout stops improving,
+  // and the best layout of all chains is used for the final routing
+  std::size_t iterativeBidirectionalRoutingChains = 1;
 
   // lookahead scheme settings
   LookaheadHeuristic lookaheadHeuristic =
@@ -72,9 +83,19 @@ struct Configuration {
   std::uint64_t teleportationSeed   = 0;
   bool          teleportationFake   = false;
 
-  // timeout merely affects exact mapper
+  // timeout (in ms) of the exact mapper, and the wall-clock budget shared by
+  // all configurations of the portfolio mapper; the heuristic mapper stops the
+  // search of each layer once it has been running for this long and routes
+  // the remaining layers with the best solution found so far or greedily
+  // along shortest paths (see `MappingResults::degradedLayers`)
   std::size_t timeout = 3600000; // 60min timeout
 
+  // configurations raced against each other by the portfolio mapper (each
+  // using the heuristic or SABRE method); the best result is kept, and runs
+  // which can no longer beat a finished one are cancelled early; if empty, a
+  // default portfolio of variants of this configuration is used
+  std::vector<Configuration> portfolio{};
+
   // if layers should be automatically split after a certain number of expanded
   // nodes, thereby reducing the search space (but potentially eliminating
   // opportunities for cost savings); acts as a control between runtime and
@@ -82,6 +103,48 @@ struct Configuration {
   bool        automaticLayerSplits          = true;
   std::size_t automaticLayerSplitsNodeLimit = 5000;
 
+  // if the heuristic search should be memory-bounded, i.e. once the search
+  // nodes of a layer exceed the given budget (in bytes), all but the best
+  // `memoryBoundedSearchBeamWidth` nodes are discarded and the search continues
+  // from the remaining ones (as in a beam search); this caps the memory needed
+  // for mapping, but the optimality of each layer is no longer guaranteed
+  bool        memoryBoundedSearch          = false;
+  std::size_t memoryBoundedSearchBudget    = 1ULL << 30U; // 1 GiB
+  std::size_t memoryBoundedSearchBeamWidth = 1000;
+
+  // if the layers of the circuit should be streamed through the heuristic
+  // mapper, i.e. the gate multiplicities and active qubits of the layers are
+  // only created for a sliding window of (at least) this many layers around
+  // the layer being routed (and its lookahead), and released once the window
+  // has moved on; this bounds the memory needed for the layers of huge
+  // circuits, at the cost of creating the data again in each routing pass
+  // (0 to create the data of all layers up front)
+  std::size_t layerWindow = 0;
+
+  // if the heuristic mapper should warm-start the search of each layer from the
+  // state of the previous one, i.e. return the current mapping right away if
+  // it already satisfies all gates of the layer (instead of searching for swaps
+  // which only lower the lookahead penalty or direction reversal costs, or
+  // improve the fidelity of the layer); greatly increases the layer throughput
+  // for circuits with many layers, at the cost of some lookahead quality
+  bool warmStartSearch = false;
+
+  // number of threads used to evaluate the children of a search node in the
+  // heuristic mapper concurrently (1 for sequential expansion, 0 to use all
+  // available hardware threads); the search itself, and thereby the result,
+  // is identical for any number of threads
+  std::size_t nThreads = 1;
+
+  // search engine used by the heuristic mapper for each layer; with
+  // hash-distributed A*, the search nodes themselves are distributed among
+  // `nThreads` workers (instead of only the evaluation of children), which
+  // scales to more threads, but may choose a different solution of equal cost
+  //
+  // A. Kishimoto, A. Fukunaga, and A. Botea, "Evaluation of a simple, scalable,
+  // parallel best-first search strategy", Artificial Intelligence 195 (2013)
+  // https://arxiv.org/abs/1201.3204
+  SearchEngine searchEngine = SearchEngine::AStar;
+
   // strategy for terminating the heuristic search early (i.e. once a goal node
   // has been found, but before it is guaranteed that the optimal solution has
   // been found)
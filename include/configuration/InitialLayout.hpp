@@ -10,7 +10,10 @@
 /// Identity: q_i -> Q_i
 /// Static: first layer is mapped q_c -> Q_c and q_t -> Q_t
 /// Dynamic: Layout is generated on demand upon encountering a specific gate
-enum class InitialLayout { Identity, Static, Dynamic };
+/// GraphIsomorphism: the interaction graph of the circuit is embedded into the
+/// coupling graph such that frequently interacting qubits are close (and, for
+/// fidelity-aware heuristics, gates are executed on reliable qubits)
+enum class InitialLayout { Identity, Static, Dynamic, GraphIsomorphism };
 
 [[maybe_unused]] static inline std::string
 toString(const InitialLayout strategy) {
@@ -21,6 +24,8 @@ toString(const InitialLayout strategy) {
     return "static";
   case InitialLayout::Dynamic:
     return "dynamic";
+  case InitialLayout::GraphIsomorphism:
+    return "graph_isomorphism";
   }
   return " ";
 }
@@ -36,5 +41,8 @@ initialLayoutFromString(const std::string& initialLayout) {
   if (initialLayout == "dynamic" || initialLayout == "2") {
     return InitialLayout::Dynamic;
   }
+  if (initialLayout == "graph_isomorphism" || initialLayout == "3") {
+    return InitialLayout::GraphIsomorphism;
+  }
   throw std::invalid_argument("Invalid initial layout value: " + initialLayout);
 }
@@ -15,7 +15,12 @@ enum class LookaheadHeuristic {
   GateCountMaxDistance,
   /** sum over all distances between any virtual qubit pair in the given layer;
      optimizing gate-count */
-  GateCountSumDistance
+  GateCountSumDistance,
+  /** sum over all virtual qubit pairs in the given layer of the fidelity cost
+     of moving the pair next to each other plus the cost of executing its
+     gates on the physical edge with the highest fidelity; optimizing
+     fidelity */
+  FidelityBestLocation
 };
 
 /**
@@ -29,6 +34,8 @@ isFidelityAware(const LookaheadHeuristic heuristic) {
   case LookaheadHeuristic::GateCountMaxDistance:
   case LookaheadHeuristic::GateCountSumDistance:
     return false;
+  case LookaheadHeuristic::FidelityBestLocation:
+    return true;
   }
   return false;
 }
@@ -42,6 +49,8 @@ toString(const LookaheadHeuristic heuristic) {
     return "gate_count_max_distance";
   case LookaheadHeuristic::GateCountSumDistance:
     return "gate_count_sum_distance";
+  case LookaheadHeuristic::FidelityBestLocation:
+    return "fidelity_best_location";
   }
   return " ";
 }
@@ -57,6 +66,9 @@ lookaheadHeuristicFromString(const std::string& heuristic) {
   if (heuristic == "gate_count_sum_distance" || heuristic == "2") {
     return LookaheadHeuristic::GateCountSumDistance;
   }
+  if (heuristic == "fidelity_best_location" || heuristic == "3") {
+    return LookaheadHeuristic::FidelityBestLocation;
+  }
   throw std::invalid_argument("Invalid lookahead heuristic value: " +
                               heuristic);
 }
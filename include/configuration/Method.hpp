@@ -7,7 +7,7 @@
 
 #include <iostream>
 
-enum class Method { None, Exact, Heuristic };
+enum class Method { None, Exact, Heuristic, Portfolio, Sabre };
 
 [[maybe_unused]] static inline std::string toString(const Method method) {
   switch (method) {
@@ -17,6 +17,10 @@ enum class Method { None, Exact, Heuristic };
     return "exact";
   case Method::Heuristic:
     return "heuristic";
+  case Method::Portfolio:
+    return "portfolio";
+  case Method::Sabre:
+    return "sabre";
   }
   return " ";
 }
@@ -31,5 +35,11 @@ enum class Method { None, Exact, Heuristic };
   if (method == "heuristic" || method == "2") {
     return Method::Heuristic;
   }
+  if (method == "portfolio" || method == "3") {
+    return Method::Portfolio;
+  }
+  if (method == "sabre" || method == "4") {
+    return Method::Sabre;
+  }
   throw std::invalid_argument("Invalid method value: " + method);
 }
@@ -0,0 +1,32 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#pragma once
+
+#include <iostream>
+
+enum class SearchEngine { AStar, HashDistributedAStar };
+
+[[maybe_unused]] static inline std::string
+toString(const SearchEngine searchEngine) {
+  switch (searchEngine) {
+  case SearchEngine::AStar:
+    return "astar";
+  case SearchEngine::HashDistributedAStar:
+    return "hash_distributed_astar";
+  }
+  return " ";
+}
+
+[[maybe_unused]] static SearchEngine
+searchEngineFromString(const std::string& searchEngine) {
+  if (searchEngine == "astar" || searchEngine == "0") {
+    return SearchEngine::AStar;
+  }
+  if (searchEngine == "hash_distributed_astar" || searchEngine == "1") {
+    return SearchEngine::HashDistributedAStar;
+  }
+  throw std::invalid_argument("Invalid search engine value: " + searchEngine);
+}
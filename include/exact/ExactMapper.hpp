@@ -14,6 +14,7 @@
 #include <functional>
 #include <set>
 #include <unordered_set>
+#include <utility>
 
 using Swap        = std::pair<std::uint16_t, std::uint16_t>;
 using Swaps       = std::vector<Swap>;
@@ -21,9 +22,17 @@ using QubitChoice = std::set<std::uint16_t>;
 
 /// Main structure representing the circuit and mapping functionality
 class ExactMapper : public Mapper {
-  using Mapper::Mapper;
+public:
+  ExactMapper(qc::QuantumComputation quantumComputation,
+              const Architecture&    arch)
+      : Mapper(std::move(quantumComputation), arch), fullArchitecture(&arch) {}
 
 protected:
+  // architecture passed to the mapper and (private) copy of it reduced to the
+  // configured subgraph, `architecture` points to the one used by a run
+  const Architecture* fullArchitecture;
+  Architecture        subgraphArchitecture{};
+
   // inputs
   std::vector<std::size_t> reducedLayerIndices{};
   std::vector<Swaps>       mappingSwaps{};
@@ -0,0 +1,157 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#pragma once
+
+/**
+ * Memo of the best-location costs of `Heuristic::FidelityBestLocation`. The
+ * cost of moving a 2Q-gate to its best physical edge (or the 1Q-gates of a
+ * qubit to their best physical qubit) only depends on the multiplicities of
+ * the gates, the number of edges skipped in the fidelity distances, and the
+ * current physical qubits of the gates, i.e. not on the swaps which led to a
+ * search node. The costs are hence shared by all nodes of all layers.
+ *
+ * There is one table per number of skipped edges and multiplicities, which is
+ * allocated on first use and filled entry by entry. Tables are published with
+ * a compare-and-swap and entries are atomic, so that the memo can be used by
+ * several threads without locking (racing threads might compute an entry more
+ * than once, but always store the same value).
+ */
+class FidelityCostMemo {
+public:
+  FidelityCostMemo() = default;
+
+  FidelityCostMemo(const FidelityCostMemo&)            = delete;
+  FidelityCostMemo& operator=(const FidelityCostMemo&) = delete;
+
+  ~FidelityCostMemo() { clear(); }
+
+  /**
+   * @brief discards all memoized costs and prepares the tables for the given
+   * architecture size and ranges of keys (not thread-safe)
+   *
+   * @param nqubits number of physical qubits
+   * @param maxSkipEdges largest number of skipped edges
+   * @param maxForward largest number of 2Q-gates in forward direction
+   * @param maxReverse largest number of 2Q-gates in reverse direction
+   * @param maxSingle largest number of 1Q-gates on a qubit
+   */
+  void reset(const std::size_t nqubits, const std::size_t maxSkipEdges,
+             const std::uint16_t maxForward, const std::uint16_t maxReverse,
+             const std::uint16_t maxSingle) {
+    clear();
+    n        = nqubits;
+    skips    = maxSkipEdges + 1;
+    forwards = static_cast<std::size_t>(maxForward) + 1;
+    reverses = static_cast<std::size_t>(maxReverse) + 1;
+    singles  = static_cast<std::size_t>(maxSingle) + 1;
+    nTwoQubitTables    = skips * forwards * reverses;
+    nSingleQubitTables = skips * singles;
+    twoQubitTables =
+        std::make_unique<std::atomic<Entry*>[]>(nTwoQubitTables);
+    singleQubitTables =
+        std::make_unique<std::atomic<Entry*>[]>(nSingleQubitTables);
+    for (std::size_t i = 0; i < nTwoQubitTables; ++i) {
+      twoQubitTables[i].store(nullptr, std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < nSingleQubitTables; ++i) {
+      singleQubitTables[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief the cost of the 2Q-gates with the given multiplicities on the
+   * physical qubits `physQ1` and `physQ2`, evaluated by `compute()` if it has
+   * not been memoized yet (or if the key is out of the range set in `reset`)
+   */
+  template <class Compute>
+  double twoQubit(const std::size_t skipEdges, const std::uint16_t forward,
+                  const std::uint16_t reverse, const std::uint16_t physQ1,
+                  const std::uint16_t physQ2, const Compute& compute) {
+    if (skipEdges >= skips || forward >= forwards || reverse >= reverses ||
+        physQ1 >= n || physQ2 >= n) {
+      return compute();
+    }
+    auto& table =
+        twoQubitTables[(skipEdges * forwards + forward) * reverses + reverse];
+    return lookup(table, n * n, physQ1 * n + physQ2, compute);
+  }
+
+  /**
+   * @brief the cost of the given number of 1Q-gates on the physical qubit
+   * `physQbit`, evaluated by `compute()` if it has not been memoized yet (or
+   * if the key is out of the range set in `reset`)
+   */
+  template <class Compute>
+  double singleQubit(const std::size_t skipEdges, const std::uint16_t multiplicity,
+                     const std::uint16_t physQbit, const Compute& compute) {
+    if (skipEdges >= skips || multiplicity >= singles || physQbit >= n) {
+      return compute();
+    }
+    auto& table = singleQubitTables[skipEdges * singles + multiplicity];
+    return lookup(table, n, physQbit, compute);
+  }
+
+private:
+  using Entry = std::atomic<double>;
+
+  std::size_t n        = 0;
+  std::size_t skips    = 0;
+  std::size_t forwards = 0;
+  std::size_t reverses = 0;
+  std::size_t singles  = 0;
+
+  std::size_t                            nTwoQubitTables    = 0;
+  std::size_t                            nSingleQubitTables = 0;
+  std::unique_ptr<std::atomic<Entry*>[]> twoQubitTables{};
+  std::unique_ptr<std::atomic<Entry*>[]> singleQubitTables{};
+
+  template <class Compute>
+  static double lookup(std::atomic<Entry*>& slot, const std::size_t size,
+                       const std::size_t index, const Compute& compute) {
+    auto* table = slot.load(std::memory_order_acquire);
+    if (table == nullptr) {
+      auto* fresh = new Entry[size];
+      for (std::size_t i = 0; i < size; ++i) {
+        fresh[i].store(std::numeric_limits<double>::quiet_NaN(),
+                       std::memory_order_relaxed);
+      }
+      if (slot.compare_exchange_strong(table, fresh, std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+        table = fresh;
+      } else {
+        // another thread published its table first
+        delete[] fresh;
+      }
+    }
+    auto& entry = table[index];
+    auto  value = entry.load(std::memory_order_relaxed);
+    if (std::isnan(value)) {
+      value = compute();
+      entry.store(value, std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+  void clear() {
+    for (std::size_t i = 0; i < nTwoQubitTables; ++i) {
+      delete[] twoQubitTables[i].exchange(nullptr);
+    }
+    for (std::size_t i = 0; i < nSingleQubitTables; ++i) {
+      delete[] singleQubitTables[i].exchange(nullptr);
+    }
+    nTwoQubitTables    = 0;
+    nSingleQubitTables = 0;
+    n                  = 0;
+    skips              = 0;
+  }
+};
@@ -5,9 +5,18 @@
 
 #include "DataLogger.hpp"
 #include "Mapper.hpp"
+#include "heuristic/FidelityCostMemo.hpp"
+#include "heuristic/LayoutEmbedding.hpp"
+#include "heuristic/NodeArena.hpp"
+#include "heuristic/ThreadPool.hpp"
 #include "heuristic/UniquePriorityQueue.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
 
 #pragma once
 
@@ -16,6 +25,16 @@ public:
   using Mapper::Mapper; // import constructors from parent class
 
   static constexpr double EFFECTIVE_BRANCH_RATE_TOLERANCE = 1e-10;
+  /**
+   * @brief number of sets of teleportations whose distance tables are cached,
+   * after which the cache is cleared
+   */
+  static constexpr std::size_t TELEPORTATION_DISTANCE_CACHE_SIZE = 64;
+  /**
+   * @brief minimum number of children of a node, for which they are evaluated
+   * in parallel (smaller expansions are not worth dispatching to the threads)
+   */
+  static constexpr std::size_t PARALLEL_EXPANSION_MIN_CHILDREN = 8;
 
   /**
    * @brief map the circuit passed at initialization to the architecture
@@ -25,6 +44,109 @@ public:
    */
   void map(const Configuration& configuration) override;
 
+  /**
+   * @brief request a running (or any later) call of `map` to stop as soon as
+   * possible, which then throws a `QMAPException`
+   *
+   * May be called from any thread.
+   */
+  void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+
+  /**
+   * @brief request a running (or any later) call of `map` to stop like after
+   * `cancel` as soon as its committed exchanges (see `getCommittedExchanges`)
+   * exceed `limit`
+   *
+   * Lets a caller drop runs that can no longer beat a known result without
+   * watching them. May be called from any thread.
+   */
+  void limitExchanges(const std::size_t limit) {
+    exchangeLimit.store(limit, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief whether the last call of `map` was (or a running call will be)
+   * stopped because it exceeded the limit set by `limitExchanges`
+   *
+   * May be called from any thread.
+   */
+  [[nodiscard]] bool exceededExchangeLimit() const {
+    return committedExchanges.load(std::memory_order_relaxed) >
+           exchangeLimit.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief number of SWAPs and teleportations added to the mapped circuit by
+   * the current call of `map` so far
+   *
+   * Since exchanges are never removed during routing, this is a lower bound on
+   * `MappingResults::CircuitInfo::swaps` plus `teleportations` of the final
+   * result. May be called from any thread.
+   */
+  [[nodiscard]] std::size_t getCommittedExchanges() const {
+    return committedExchanges.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief contribution of one two-qubit gate to the heuristic cost (or
+   * lookahead penalty) of a search node
+   */
+  struct GateCost {
+    /** logical qubits of the gate */
+    Edge edge{};
+    /** number of gates on `edge` in each direction */
+    std::pair<std::uint16_t, std::uint16_t> multiplicity{};
+    /** term of the gate in `Configuration::heuristic` (or in
+     * `Configuration::lookaheadHeuristic` for gates of lookahead layers) */
+    double cost = 0.;
+    /** distance used for the gate in
+     * `Heuristic::GateCountSumDistanceMinusSharedSwaps` */
+    double swapCost = 0.;
+    /** whether the qubits of the gate are mapped next to each other */
+    bool validlyMapped = false;
+  };
+
+  /**
+   * @brief per-gate (and per-qubit) cost contributions of a search node, which
+   * are reused for all of its children, so that generating a child only
+   * re-evaluates the gates acting on the two exchanged qubits (see
+   * `HeuristicMapper::cacheGateCosts`)
+   */
+  struct GateCostCache {
+    static constexpr std::size_t INVALID = std::numeric_limits<std::size_t>::max();
+
+    /** number of swaps in the node when the costs were cached, i.e. the costs
+     * belong to the parent of the node if it has one more swap */
+    std::size_t nSwaps = INVALID;
+    /** one entry per two-qubit gate of the current layer followed by those of
+     * the lookahead layers (in the order of `Mapper::LayerView::edges`)
+     */
+    std::vector<GateCost> gates{};
+    /** number of entries in `gates` belonging to the current layer */
+    std::size_t currentGates = 0;
+    /** savings potential of the single-qubit gates on each logical qubit (only
+     * for `Heuristic::FidelityBestLocation`) */
+    std::vector<double> qubits{};
+
+    struct LookaheadLayer {
+      /** index of the circuit layer */
+      std::size_t layer = 0;
+      /** index of the first gate of the layer in `gates` */
+      std::size_t firstGate = 0;
+      /** number of gates of the layer in `gates` */
+      std::size_t nGates = 0;
+      /** lookahead penalty of the layer (before applying the lookahead
+       * factor) */
+      double penalty = 0.;
+      /** whether any gate in the layer acts on a qubit which is not mapped yet
+       * (its cost then depends on all free physical qubits) */
+      bool unmappedQubits = false;
+    };
+    /** all lookahead layers considered in `Node::lookaheadPenalty`, so that
+     * layers not acting on the exchanged qubits are not re-evaluated at all */
+    std::vector<LookaheadLayer> lookaheadLayers{};
+  };
+
   /**
    * @brief struct representing one node in the A* search containing info about
    * swaps, mappings and costs
@@ -41,14 +163,14 @@ public:
      *
      * The inverse of `locations`
      */
-    std::array<std::int16_t, MAX_DEVICE_QUBITS> qubits{};
+    std::vector<std::int16_t> qubits{};
     /**
      * containing the logical qubit currently mapped to each physical qubit.
      * `locations[logical_qubit] = physical_qubit`
      *
      * The inverse of `qubits`
      */
-    std::array<std::int16_t, MAX_DEVICE_QUBITS> locations{};
+    std::vector<std::int16_t> locations{};
     /** current fixed cost
      *
      * non-fidelity-aware: cost of all swaps used in the node
@@ -77,30 +199,38 @@ public:
     /** true if all qubit pairs are mapped next to each other on the
      * architecture */
     bool validMapping = true;
+    /** cost contributions of the node (or its parent) to be reused when
+     * generating children */
+    GateCostCache gateCosts{};
+    /** if set, the cost contributions to use instead of `gateCosts`, i.e. the
+     * ones cached in another copy of the node (see `expandNodeParallel`) */
+    const GateCostCache* sharedGateCosts = nullptr;
 
-    explicit Node() {
-      qubits.fill(DEFAULT_POSITION);
-      locations.fill(DEFAULT_POSITION);
-    };
-    explicit Node(std::size_t nodeId) : id(nodeId) {
-      qubits.fill(DEFAULT_POSITION);
-      locations.fill(DEFAULT_POSITION);
-    };
+    explicit Node() = default;
+    explicit Node(std::size_t nodeId) : id(nodeId) {};
     Node(std::size_t nodeId, std::size_t parentId,
-         const std::array<std::int16_t, MAX_DEVICE_QUBITS>& q,
-         const std::array<std::int16_t, MAX_DEVICE_QUBITS>& loc,
-         const std::vector<Exchange>&                       sw            = {},
-         const std::set<Edge>&                              valid2QGates  = {},
-         const double                                       initCostFixed = 0,
-         const double      initCostFixedReversals                         = 0,
-         const std::size_t searchDepth                                    = 0,
-         const std::size_t initSharedSwaps                                = 0)
+         const std::vector<std::int16_t>& q,
+         const std::vector<std::int16_t>& loc,
+         const std::vector<Exchange>&     sw                     = {},
+         const std::set<Edge>&            valid2QGates           = {},
+         const double                     initCostFixed          = 0,
+         const double                     initCostFixedReversals = 0,
+         const std::size_t                searchDepth            = 0,
+         const std::size_t                initSharedSwaps        = 0)
         : validMappedTwoQubitGates(valid2QGates), swaps(sw), qubits(q),
           locations(loc), costFixed(initCostFixed),
           costFixedReversals(initCostFixedReversals),
           sharedSwaps(initSharedSwaps), depth(searchDepth), parent(parentId),
           id(nodeId) {}
 
+    /**
+     * @brief returns the cost contributions cached for the node (or its
+     * parent), i.e. `sharedGateCosts` if set and `gateCosts` otherwise
+     */
+    [[nodiscard]] const GateCostCache& cachedGateCosts() const {
+      return sharedGateCosts != nullptr ? *sharedGateCosts : gateCosts;
+    }
+
     /**
      * @brief returns costFixed + costHeur + lookaheadPenalty
      */
@@ -132,13 +262,270 @@ public:
     }
   };
 
+  /**
+   * @brief orders search nodes stored in a `NodeArena` by their qubit mapping
+   * (lexicographically), equivalent to `operator<` on `HeuristicMapper::Node`
+   */
+  struct NodeMappingCompare {
+    const NodeArena* arena = nullptr;
+
+    bool operator()(const NodeArena::Index x, const NodeArena::Index y) const {
+      const auto* qx = arena->mapping(x);
+      const auto* qy = arena->mapping(y);
+      return std::lexicographical_compare(qx, qx + arena->getWidth(), qy,
+                                          qy + arena->getWidth());
+    }
+  };
+
+  /**
+   * @brief hashes search nodes stored in a `NodeArena` by their qubit mapping
+   * (using the Zobrist hash precomputed in the arena)
+   */
+  struct NodeMappingHash {
+    const NodeArena* arena = nullptr;
+
+    std::size_t operator()(const NodeArena::Index x) const {
+      return static_cast<std::size_t>(arena->at(x).hash);
+    }
+  };
+
+  /**
+   * @brief checks if two search nodes stored in a `NodeArena` have the same
+   * qubit mapping
+   */
+  struct NodeMappingEqual {
+    const NodeArena* arena = nullptr;
+
+    bool operator()(const NodeArena::Index x, const NodeArena::Index y) const {
+      const auto* qx = arena->mapping(x);
+      return std::equal(qx, qx + arena->getWidth(), arena->mapping(y));
+    }
+  };
+
+  /**
+   * @brief orders search nodes stored in a `NodeArena` by their costs,
+   * equivalent to `operator>` on `HeuristicMapper::Node`
+   */
+  struct NodeCostCompare {
+    const NodeArena* arena = nullptr;
+
+    bool operator()(const NodeArena::Index x, const NodeArena::Index y) const {
+      const auto& nx    = arena->at(x);
+      const auto& ny    = arena->at(y);
+      const auto  xcost = nx.getTotalCost();
+      const auto  ycost = ny.getTotalCost();
+      if (std::abs(xcost - ycost) > 1e-6) {
+        return xcost > ycost;
+      }
+
+      if (nx.validMapping != ny.validMapping) {
+        return ny.validMapping;
+      }
+
+      const auto xheur = nx.costHeur + nx.lookaheadPenalty;
+      const auto yheur = ny.costHeur + ny.lookaheadPenalty;
+      if (std::abs(xheur - yheur) > 1e-6) {
+        return xheur > yheur;
+      }
+
+      if (nx.validMappedTwoQubitGates != ny.validMappedTwoQubitGates) {
+        return nx.validMappedTwoQubitGates < ny.validMappedTwoQubitGates;
+      }
+
+      return NodeMappingCompare{arena}(x, y);
+    }
+  };
+
 protected:
-  UniquePriorityQueue<Node>   nodes{};
+  /**
+   * @brief single-qubit gate emitted by `routeCircuit` while its logical qubit
+   * is not placed yet, its physical qubit is determined once the circuit has
+   * been routed (see `placeDeferredGates`)
+   */
+  struct DeferredGate {
+    /** the gate in the mapped circuit (targeting the logical qubit) */
+    qc::Operation* op = nullptr;
+    /** number of SWAPs in the mapped circuit before the gate */
+    std::size_t swapsBefore = 0;
+  };
+
+  /**
+   * @brief determines which cost contributions cached in a node (see
+   * `Node::gateCosts`) are still valid for the node
+   *
+   * The cached costs can only be reused if they belong to the parent of the
+   * node, i.e. if the node has been generated by exactly one exchange since
+   * the costs were cached. In this case, only gates acting on one of the two
+   * exchanged logical qubits need to be re-evaluated.
+   */
+  struct GateCostReuse {
+    /** whether the cached costs belong to the parent of the node */
+    bool parentCached = false;
+    /** whether the cached costs have been evaluated for the node itself */
+    bool allUnchanged = false;
+    /** logical qubits exchanged between the parent and the node (-1 for a
+     * physical qubit without logical qubit) */
+    std::int16_t q1 = DEFAULT_POSITION;
+    std::int16_t q2 = DEFAULT_POSITION;
+
+    explicit GateCostReuse(const Node& node)
+        : parentCached(node.cachedGateCosts().nSwaps !=
+                           GateCostCache::INVALID &&
+                       node.swaps.size() ==
+                           node.cachedGateCosts().nSwaps + 1) {
+      if (parentCached) {
+        q1 = node.qubits.at(node.swaps.back().first);
+        q2 = node.qubits.at(node.swaps.back().second);
+      }
+    }
+
+    /** the cost of the single-qubit gates on `q` is unchanged */
+    [[nodiscard]] bool unchanged(const std::uint16_t q) const {
+      return allUnchanged ||
+             (parentCached && static_cast<std::int16_t>(q) != q1 &&
+              static_cast<std::int16_t>(q) != q2);
+    }
+
+    /** the cost of a gate of the current layer is unchanged */
+    [[nodiscard]] bool unchanged(const Edge& edge) const {
+      return unchanged(edge.first) && unchanged(edge.second);
+    }
+
+    /** the lookahead penalty of a whole layer is unchanged */
+    [[nodiscard]] bool
+    unchangedLookahead(const GateCostCache::LookaheadLayer& lookahead,
+                       const QubitSet& layerQubits) const {
+      if (allUnchanged) {
+        return true;
+      }
+      return parentCached &&
+             (!lookahead.unmappedQubits ||
+              (q1 != DEFAULT_POSITION && q2 != DEFAULT_POSITION)) &&
+             (q1 == DEFAULT_POSITION ||
+              !layerQubits.test(static_cast<std::size_t>(q1))) &&
+             (q2 == DEFAULT_POSITION ||
+              !layerQubits.test(static_cast<std::size_t>(q2)));
+    }
+
+    /** the cost of a gate of a lookahead layer is unchanged (which
+     * additionally depends on the free physical qubits, if one of its qubits
+     * is not mapped yet) */
+    [[nodiscard]] bool unchangedLookahead(const Edge& edge,
+                                          const Node& node) const {
+      if (allUnchanged) {
+        return true;
+      }
+      if (!unchanged(edge)) {
+        return false;
+      }
+      return (q1 != DEFAULT_POSITION && q2 != DEFAULT_POSITION) ||
+             (node.locations.at(edge.first) != DEFAULT_POSITION &&
+              node.locations.at(edge.second) != DEFAULT_POSITION);
+    }
+  };
+
+  /**
+   * @brief search state of one worker of the hash-distributed A*-search or of
+   * one chain of iterative bidirectional routing (defined in the source file)
+   */
+  struct SearchWorker;
+
+  /** all search nodes generated in the current A*-search */
+  NodeArena arena{};
+  /** open list of the A*-search (indices into `arena`) */
+  UniquePriorityQueue<NodeArena::Index, NodeCostCompare, NodeMappingHash,
+                      NodeMappingEqual>
+      nodes{NodeCostCompare{&arena}, NodeMappingHash{&arena},
+            NodeMappingEqual{&arena}};
+  /** workers of the hash-distributed A*-search, kept across layers to reuse
+   * their allocated memory (see `hashDistributedAStarMap`) */
+  std::vector<std::shared_ptr<SearchWorker>> searchWorkers{};
+  /** workers for expanding nodes in parallel (only if
+   * `Configuration::nThreads` > 1) */
+  std::unique_ptr<ThreadPool> threadPool;
+  /** swaps to be evaluated in the current (parallel) node expansion */
+  std::vector<Edge> expansionCandidates;
+  /** pairs of logical qubits already exchanged by one of the
+   * `expansionCandidates` (all bits are reset after each collection) */
+  std::vector<QubitSet> expansionUsedSwaps;
+  /** children generated in the current (parallel) node expansion, in the
+   * order of `expansionCandidates` */
+  std::vector<NodeArena::Entry> expansionChildren;
+  /** per-thread copies of the state of the node currently being expanded
+   * (kept across expansions to reuse their memory, see `expandNodeParallel`)
+   */
+  std::vector<Node>           expansionScratch;
   std::unique_ptr<DataLogger> dataLogger;
   std::size_t                 nextNodeId                = 0;
   bool                        principallyAdmissibleHeur = true;
   bool                        tightHeur                 = true;
   bool                        fidelityAwareHeur         = false;
+  /** best-location costs of `Heuristic::FidelityBestLocation` (filled while
+   * evaluating the heuristic, hence mutable) */
+  mutable FidelityCostMemo fidelityCostMemo{};
+  /** set by `cancel` */
+  std::atomic<bool> cancelled{false};
+  /** see `getCommittedExchanges` */
+  std::atomic<std::size_t> committedExchanges{0};
+  /** set by `limitExchanges` */
+  std::atomic<std::size_t> exchangeLimit{
+      std::numeric_limits<std::size_t>::max()};
+  /** point in time at which the search of each layer is stopped (see
+   * `Configuration::timeout`) */
+  std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::time_point::max();
+
+  // the state of the teleportations is owned by the mapper (the architecture
+  // is only read, and may be shared by several mappers)
+  /** physical qubits of the teleportation qubit pairs of the node being
+   * expanded */
+  std::vector<std::pair<std::int16_t, std::int16_t>> teleportationQubits{};
+  /** teleportations available in the node being expanded */
+  CouplingMap currentTeleportations{};
+  /** distances with `currentTeleportations` (null if there are none) */
+  std::shared_ptr<const Matrix> teleportationDistanceTable{};
+  /** distances of previously used sets of teleportations */
+  std::map<CouplingMap, std::shared_ptr<const Matrix>>
+      teleportationDistanceTables{};
+
+  /**
+   * @brief sets the teleportations (i.e. edges between qubits which are not
+   * coupled, but can exchange states via teleportation qubits) which are
+   * currently available in addition to the coupling map, and on which
+   * `physicalDistance` is based
+   *
+   * The distances for a set of teleportations are computed once for all pairs
+   * of qubits (see `Architecture::createTeleportationDistanceTable`) and
+   * cached (see `TELEPORTATION_DISTANCE_CACHE_SIZE`), so that each lookup is
+   * O(1).
+   */
+  void setCurrentTeleportations(CouplingMap teleportations);
+
+  /**
+   * @brief distance between the physical qubits in the architecture (see
+   * `Architecture::distance`) with the current teleportations
+   */
+  [[nodiscard]] double
+  physicalDistance(const std::uint16_t control, const std::uint16_t target,
+                   const bool includeReversalCost = true) const {
+    if (teleportationDistanceTable) {
+      return (*teleportationDistanceTable)(control, target);
+    }
+    return architecture->distance(control, target, includeReversalCost);
+  }
+
+  /**
+   * @brief whether the mapping has been cancelled (see `cancel` and
+   * `limitExchanges`)
+   */
+  [[nodiscard]] bool isCancelled() const {
+    return cancelled.load(std::memory_order_relaxed) || exceededExchangeLimit();
+  }
+
+  /**
+   * @brief throw a `QMAPException` if the mapping has been cancelled
+   */
+  void checkCancelled() const;
 
   /**
    * @brief check the `results.config` for any invalid settings
@@ -159,31 +546,83 @@ protected:
    */
   virtual void staticInitialMapping();
 
+  /**
+   * @brief creates an initial mapping of logical qubits to physical qubits by
+   * embedding the interaction graph of the circuit into the coupling graph of
+   * the architecture (see `LayoutEmbedding`) within
+   * `Configuration::initialLayoutTimeout`. Qubits without gates are then just
+   * mapped by order of index.
+   */
+  virtual void graphIsomorphismInitialMapping();
+
   /**
    * @brief map the logical qubit `target` to a free physical qubit, that is
    * nearest to the physical qubit `source` is mapped to
    *
+   * @param node node whose mapping is extended
    * @param source an already mapped logical qubit, which should be mapped near
    * to `target`
    * @param target an unmapped logical qubit
+   * @param recordLayout if true, the placement is also recorded in the initial
+   * layout and output permutation of the mapped circuit
    */
-  virtual void mapToMinDistance(std::uint16_t source, std::uint16_t target);
+  virtual void mapToMinDistance(Node& node, std::uint16_t source,
+                                std::uint16_t target, bool recordLayout);
 
   /**
    * @brief maps any yet unmapped qubits, which are acted on in a given layer,
    * to a physical qubit.
    *
-   * @param twoQubitGateMultiplicity number of two qubit gates acting on pairs
-   * of logical qubits in the current layer
+   * @param layer index of the current circuit layer
+   * @param node node whose mapping is extended
+   * @param recordLayout if true, the placements are also recorded in the
+   * initial layout and output permutation of the mapped circuit
    */
-  virtual void mapUnmappedGates(std::size_t layer);
+  virtual void mapUnmappedGates(std::size_t layer, Node& node,
+                                bool recordLayout);
+
+  /**
+   * @brief records the current mapping (i.e. `qubits`) as the initial layout
+   * (and output permutation) of the mapped circuit, e.g. after it has been
+   * changed by iterative bidirectional routing
+   */
+  void recordInitialLayout();
 
   /**
    * @brief Routes the input circuit, i.e. inserts SWAPs to meet topology
    * constraints and optimize fidelity if activated
+   *
+   * If the layers are streamed (see `Configuration::layerWindow`), the gates of
+   * each layer are released once it has been routed.
    */
   void routeCircuit();
 
+  /**
+   * @brief sets the physical qubits of the gates deferred by `routeCircuit`
+   *
+   * Starting from the final layout, the SWAPs of the mapped circuit are undone
+   * in reverse order to obtain the layout at each deferred gate. Qubits only
+   * acted on by single-qubit gates are placed on the first free physical
+   * qubit. Afterwards, `qubits` and `locations` hold the layout at the first
+   * deferred gate.
+   *
+   * @param swaps the SWAPs of the mapped circuit in order
+   * @param deferred the deferred gates in order
+   */
+  void placeDeferredGates(const std::vector<Edge>&         swaps,
+                          const std::vector<DeferredGate>& deferred);
+
+  /**
+   * @brief loads the data of the layers needed to route the given layer (see
+   * `Mapper::loadLayers`), i.e. the layer itself and its lookahead layers
+   * (for the SABRE router, the lookahead of reverse passes goes to the
+   * preceding layers)
+   *
+   * @param layer index of the circuit layer to route
+   * @param reverse if true, the circuit is mapped from the end to the beginning
+   */
+  void loadRoutingLayers(std::size_t layer, bool reverse);
+
   /**
    * @brief Performs pseudo-routing on the input circuit, i.e. rearranges the
    * qubit layout layer by layer to meet topology constraints without actually
@@ -196,51 +635,297 @@ protected:
    */
   void pseudoRouteCircuit(bool reverse = false);
 
+  /**
+   * @brief iterative bidirectional routing with several independent chains of
+   * forward/backward passes (see
+   * `Configuration::iterativeBidirectionalRoutingChains`), which are run
+   * concurrently on `HeuristicMapper::threadPool`
+   *
+   * The first chain starts from the initial layout created by
+   * `createInitialMapping`, chain `i > 0` from a random layout (seeded with
+   * `i`). Each pass estimates the quality of the current layout of a chain by
+   * the number of exchanges inserted when routing from it, and a chain stops
+   * once this estimate no longer improves. The best layout among all chains is
+   * left in `qubits` and `locations`.
+   */
+  void routeBidirectionalChains();
+
+  /**
+   * @brief pseudo-routes the circuit starting from the mapping of the given
+   * node (as `pseudoRouteCircuit`, but without changing any global data, so
+   * that several chains may be routed concurrently; layers are not split)
+   *
+   * @param mapping node holding the mapping to start from, which is replaced
+   * by the final mapping
+   * @param reverse if true, the circuit is routed from the end to the beginning
+   * @param worker search state used for the A*-search of each layer
+   * @return number of exchanges inserted (except for the first layer, unless
+   * `Configuration::swapOnFirstLayer` is set), or the maximum value if the
+   * deadline of the mapping expired (leaving `mapping` partially routed)
+   */
+  std::size_t pseudoRouteChain(Node& mapping, bool reverse,
+                               SearchWorker& worker);
+
   /**
    * @brief search for an optimal mapping/set of swaps using A*-search and the
    * heuristic specified in `HeuristicMapper::Node::updateHeuristicCost`
    *
    * uses `HeuristicMapper::nodes` as a priority queue for the A*-search,
    * assumed to be empty (or at least containing only nodes compliant with the
-   * current layer in their fields `costHeur` and `validMapping`)
+   * current layer in their fields `costHeur` and `validMapping`). The search
+   * nodes themselves are stored in `HeuristicMapper::arena`, which is reset
+   * at the start of each search with an empty queue (keeping its allocated
+   * memory, as does the queue, so that consecutive layers reuse it). With
+   * `Configuration::warmStartSearch`, the current mapping is returned without
+   * any search if it already satisfies all gates of the layer.
+   *
+   * Once the deadline given by `Configuration::timeout` has expired, the search
+   * stops before expanding any further node and returns the best goal node
+   * found so far (nodes are still tested for being goal nodes, so a layer
+   * which is already satisfied by the mapping of the root is never affected).
+   * Only if there is no such node, the layer is degraded (see
+   * `MappingResults::degradedLayers`): its gates are routed by
+   * `routeLayerGreedily` (after splitting the layer until it contains a single
+   * 2Q-gate).
    *
    * @param layer index of the current circuit layer
    * @param reverse if true, the circuit is mapped from the end to the beginning
    */
   virtual Node aStarMap(std::size_t layer, bool reverse);
 
+  /**
+   * @brief routes the single 2Q-gate of the given layer (if any) by moving its
+   * control along a shortest path towards its target
+   *
+   * @param layer index of the current circuit layer
+   * @param node node whose mapping is routed (by appending SWAPs)
+   */
+  void routeLayerGreedily(std::size_t layer, Node& node);
+
+  /**
+   * @brief whether the deadline of the current mapping has expired
+   */
+  [[nodiscard]] bool deadlineExpired() const {
+    return std::chrono::steady_clock::now() >= deadline;
+  }
+
+  /**
+   * @brief finalizes the data log of the given layer with the node chosen as
+   * the result of its search (only if data logging is enabled)
+   */
+  void logLayerResult(std::size_t layer, const Node& result);
+
+  /**
+   * @brief search for an optimal mapping/set of swaps using hash-distributed
+   * A*-search (HDA*) on all threads of `HeuristicMapper::threadPool`
+   *
+   * Each worker owns a local open list and closed list for the search nodes
+   * whose qubit mapping hashes to it; generated nodes are sent to their owner
+   * through lock-free queues. The search terminates once no worker holds any
+   * node which could improve the best goal node found so far (all nodes in
+   * open lists and in transit are counted, so that this can be detected
+   * without a central open list).
+   *
+   * In contrast to `aStarMap`, the search continues after the first goal node
+   * has been found (until it is proven to be optimal) and nodes which have
+   * already been expanded are reopened if they are reached with lower cost.
+   * The cost of the result is therefore the same as in `aStarMap` for
+   * admissible heuristics, but among several optimal solutions, any may be
+   * chosen. Once the deadline has expired, the workers stop expanding nodes
+   * and the best goal node found by any of them is returned, or the layer is
+   * degraded as in `aStarMap` if there is none.
+   *
+   * @param layer index of the current circuit layer
+   * @param reverse if true, the circuit is mapped from the end to the beginning
+   * @param root root node of the search
+   */
+  Node hashDistributedAStarMap(std::size_t layer, bool reverse,
+                               const Node& root);
+
+  /**
+   * @brief splits the given layer (as triggered by
+   * `Configuration::automaticLayerSplits`) and restarts the search
+   *
+   * @param layer index of the current circuit layer
+   * @param reverse if true, the circuit is mapped from the end to the beginning
+   */
+  Node splitLayerAndRestart(std::size_t layer, bool reverse);
+
+  /**
+   * @brief adds the benchmark information of the layer searched last to
+   * `Mapper::results` (only if `Configuration::debug` is set)
+   *
+   * @return the added layer benchmark, which may be extended by the caller
+   */
+  MappingResults::LayerHeuristicBenchmarkInfo&
+  addLayerBenchmark(std::size_t expandedNodes, std::size_t generatedNodes,
+                    std::size_t solutionDepth, std::size_t peakMemory,
+                    double seconds);
+
   /**
    * @brief Get all qubits that are acted on by a relevant gate in the given
    * layer
    *
    * @param layer the layer for which to get the considered qubits
    */
-  const std::set<std::uint16_t>& getConsideredQubits(std::size_t layer) const {
+  const QubitSet& getConsideredQubits(std::size_t layer) const {
     if (fidelityAwareHeur) {
-      return activeQubits.at(layer);
+      return getLayerView(layer).activeQubits;
     }
-    return activeQubits2QGates.at(layer);
+    return getLayerView(layer).activeQubits2QGates;
   }
 
+  /**
+   * @brief stores the given node in `HeuristicMapper::arena` as a root node
+   * (i.e. without parent) and adds it to `HeuristicMapper::nodes`
+   *
+   * @param node search node to store
+   */
+  void pushRootNode(const Node& node);
+
+  /**
+   * @brief reconstructs the full search node (mapping, swaps and validly
+   * mapped gates) of a node stored in `HeuristicMapper::arena`
+   *
+   * @param index index of the node in the arena
+   * @param layer index of current circuit layer
+   * @param node search node to overwrite with the reconstructed data
+   */
+  void restoreNode(NodeArena::Index index, std::size_t layer, Node& node);
+
+  /**
+   * @brief reconstructs the mapping, validly mapped gates and costs of a node
+   * stored in the given arena (but not its swaps)
+   *
+   * @param nodeArena arena in which the node is stored
+   * @param index index of the node in the arena
+   * @param layer index of current circuit layer
+   * @param node search node to overwrite with the reconstructed data
+   */
+  void restoreNodeState(const NodeArena& nodeArena, NodeArena::Index index,
+                        std::size_t layer, Node& node);
+
+  /**
+   * @brief collects all swaps (or teleportations) to consider when expanding
+   * the given node, in the order in which the children are generated
+   *
+   * The candidates are enumerated from the precomputed incident edges of the
+   * physical qubits of all considered logical qubits (see
+   * `Architecture::getIncidentEdges`), i.e. in O(sum of their degrees).
+   *
+   * @param node current search node
+   * @param layer index of current circuit layer
+   * @param teleportations pairs of physical qubits on which a teleportation
+   * is possible (in addition to swaps on the edges of the coupling map)
+   * @param candidates vector to overwrite with the swaps to consider
+   * @param usedSwaps scratch buffer with one (cleared) row per physical qubit,
+   * which is left cleared again
+   */
+  void collectExpansionCandidates(const Node& node, std::size_t layer,
+                                  const CouplingMap&     teleportations,
+                                  std::vector<Edge>&     candidates,
+                                  std::vector<QubitSet>& usedSwaps);
+
+  /**
+   * @brief prunes the search to the `Configuration::memoryBoundedSearchBeamWidth`
+   * best nodes in `HeuristicMapper::nodes` (plus the best goal node found so
+   * far) and releases the memory of all other nodes in
+   * `HeuristicMapper::arena`
+   *
+   * This turns the A*-search into a beam search, i.e. the search may no longer
+   * find an optimal solution once nodes have been pruned.
+   *
+   * @param bestDoneNode index of the best goal node found so far, updated to
+   * its index after pruning
+   * @param validMapping whether a goal node has been found so far
+   */
+  void pruneSearch(NodeArena::Index& bestDoneNode, bool validMapping);
+
   /**
    * @brief expand the given node by calling `expand_node_add_one_swap` for all
    * possible swaps, which creates new search nodes and adds them to
    * `HeuristicMapper::nodes`
    *
-   * @param node current search node
+   * If `HeuristicMapper::threadPool` is set, data logging is disabled and
+   * there are at least `PARALLEL_EXPANSION_MIN_CHILDREN` swaps to consider,
+   * the children are evaluated concurrently by `expandNodeParallel` instead.
+   *
+   * @param nodeIndex index of the current search node in the arena
+   * @param node current search node (as reconstructed by `restoreNodeState`,
+   * its swaps are only needed for data logging), which is modified during the
+   * expansion but restored afterwards
+   * @param layer index of current circuit layer
+   */
+  void expandNode(NodeArena::Index nodeIndex, Node& node, std::size_t layer);
+
+  /**
+   * @brief evaluates the children of the given node for all swaps in
+   * `HeuristicMapper::expansionCandidates` on the threads of
+   * `HeuristicMapper::threadPool` and adds them to `HeuristicMapper::nodes`
+   *
+   * The children are added in the order of the candidates (and get their ids
+   * in this order), i.e. the search proceeds exactly as with
+   * `expandNodeAddOneSwap` being called for each candidate in turn.
+   *
+   * Each thread works on its own copy of the mapping and costs of the node in
+   * `HeuristicMapper::expansionScratch`, but all of them read the cost
+   * contributions cached in `node` (see `Node::sharedGateCosts`).
+   *
+   * @param nodeIndex index of the current search node in the arena
+   * @param node current search node (its cached cost contributions must not
+   * change until the expansion has finished)
    * @param layer index of current circuit layer
    */
-  void expandNode(Node& node, std::size_t layer);
+  void expandNodeParallel(NodeArena::Index nodeIndex, Node& node,
+                          std::size_t layer);
 
   /**
    * @brief creates a new node with a swap on the given edge and adds it to
    * `HeuristicMapper::nodes`
    *
+   * The swap is applied to `node` in place and reverted once the new node is
+   * stored in `HeuristicMapper::arena`.
+   *
    * @param swap edge on which to perform a swap
+   * @param nodeIndex index of the current search node in the arena
    * @param node current search node
    * @param layer index of current circuit layer
    */
-  void expandNodeAddOneSwap(const Edge& swap, Node& node, std::size_t layer);
+  void expandNodeAddOneSwap(const Edge& swap, NodeArena::Index nodeIndex,
+                            Node& node, std::size_t layer);
+
+  /**
+   * @brief applies a swap (or teleportation) on the given edge to `node` in
+   * place and returns the data of the resulting child node to be stored in
+   * `HeuristicMapper::arena` (without an id)
+   *
+   * Only modifies `node` (all other data is only read), i.e. it may be called
+   * concurrently for different copies of a node.
+   *
+   * @param nodeArena arena in which the current search node is stored
+   * @param swap edge on which to perform a swap
+   * @param nodeIndex index of the current search node in the arena
+   * @param node current search node, which is turned into the child
+   * @param layer index of current circuit layer
+   */
+  NodeArena::Entry applyExchange(const NodeArena& nodeArena, const Edge& swap,
+                                 NodeArena::Index nodeIndex, Node& node,
+                                 std::size_t layer);
+
+  /**
+   * @brief reverts the swap or teleportation applied to the given node by
+   * `applyExchange`, i.e. restores the mapping, swaps and validly mapped gates
+   * and resets the costs to the ones of the parent node stored in the arena
+   *
+   * @param nodeArena arena in which the parent node is stored
+   * @param swap physical edge on which the swap was performed
+   * @param nodeIndex index of the parent node in the arena
+   * @param layer index of current circuit layer
+   * @param node search node in which to revert the swap
+   */
+  void revertExchange(const NodeArena& nodeArena, const Edge& swap,
+                      NodeArena::Index nodeIndex, std::size_t layer,
+                      Node& node);
 
   /**
    * @brief applies an in-place swap of 2 virtual qubits in the given node and
@@ -307,6 +992,141 @@ protected:
    */
   void recalculateFixedCostReversals(std::size_t layer, Node& node);
 
+  /**
+   * @brief evaluates the cost contributions of all gates of the current layer
+   * and the lookahead layers for the given node and stores them in
+   * `Node::gateCosts`, to be reused when generating its children
+   *
+   * @param layer index of current circuit layer
+   * @param node search node about to be expanded
+   */
+  void cacheGateCosts(std::size_t layer, Node& node);
+
+  /**
+   * @brief evaluates the cost contributions of the gates of the current layer
+   * and/or the lookahead layers for the given node
+   *
+   * @param layer index of current circuit layer
+   * @param node search node for which to evaluate the contributions
+   * @param cache cache to fill (`GateCostCache::nSwaps` is left untouched)
+   * @param currentLayer whether to evaluate the current layer (including
+   * single-qubit gates for `Heuristic::FidelityBestLocation`)
+   * @param lookahead whether to evaluate the lookahead layers
+   */
+  void computeGateCosts(std::size_t layer, const Node& node,
+                        GateCostCache& cache, bool currentLayer,
+                        bool lookahead);
+
+  /**
+   * @brief returns the cost contributions to be used when evaluating the
+   * heuristic for the given node, i.e. the ones cached for its parent if
+   * available, and otherwise ones freshly evaluated into `scratch` (in which
+   * case `reuse` is updated to reuse all of them)
+   *
+   * @param layer index of current circuit layer
+   * @param node search node for which to evaluate the heuristic
+   * @param reuse reusability of the cached costs for `node`
+   * @param scratch storage for freshly evaluated costs
+   * @param lookahead whether the costs are needed for the lookahead layers
+   * instead of the current layer
+   */
+  const GateCostCache& gateCostsFor(std::size_t layer, const Node& node,
+                                    GateCostReuse& reuse,
+                                    GateCostCache& scratch, bool lookahead);
+
+  /**
+   * @brief evaluates the contribution of one gate of the current layer to the
+   * heuristic cost according to `Configuration::heuristic`
+   *
+   * @param layer index of current circuit layer
+   * @param edge logical qubits of the gate
+   * @param multiplicity number of gates on `edge` in each direction
+   * @param node search node for which to evaluate the heuristic
+   */
+  GateCost
+  heuristicGateCost(std::size_t layer, const Edge& edge,
+                    const std::pair<std::uint16_t, std::uint16_t>& multiplicity,
+                    const Node& node) const;
+
+  /**
+   * @brief evaluates the contribution of one gate of a lookahead layer to the
+   * lookahead penalty (identical for all gate-count lookahead heuristics,
+   * which only differ in how the contributions are combined)
+   *
+   * @param edge logical qubits of the gate
+   * @param multiplicity number of gates on `edge` in each direction
+   * @param node search node for which to evaluate the heuristic
+   */
+  double
+  lookaheadGateCost(const Edge&                                    edge,
+                    const std::pair<std::uint16_t, std::uint16_t>& multiplicity,
+                    const Node& node) const;
+
+  /**
+   * @brief evaluates the contribution of one gate of a lookahead layer to the
+   * lookahead penalty of `LookaheadHeuristic::FidelityBestLocation`, using the
+   * best-edge cost precomputed in `Mapper::LayerView::bestEdgeCosts`
+   *
+   * @param layer index of the lookahead layer
+   * @param gate index of the gate in `Mapper::LayerView::edges`
+   * @param node search node for which to evaluate the heuristic
+   */
+  double lookaheadFidelityGateCost(std::size_t layer, std::size_t gate,
+                                   const Node& node) const;
+
+  /**
+   * @brief evaluates the potential fidelity savings of moving the single-qubit
+   * gates on a logical qubit to a better physical qubit (used in
+   * `Heuristic::FidelityBestLocation`)
+   *
+   * @param layer index of current circuit layer
+   * @param logQbit logical qubit
+   * @param node search node for which to evaluate the heuristic
+   */
+  double singleQubitSavings(std::size_t layer, std::uint16_t logQbit,
+                            const Node& node) const;
+
+  /**
+   * @brief the minimum fidelity cost of moving a logical qubit pair from the
+   * physical qubits `physQ1` and `physQ2` to any edge of the architecture and
+   * executing its 2Q-gates there (used in `Heuristic::FidelityBestLocation`,
+   * memoized in `HeuristicMapper::fidelityCostMemo`)
+   *
+   * @param multiplicity number of gates on the pair in each direction
+   * @param skipEdges number of edges skipped in the fidelity distances
+   * @param physQ1 physical qubit of the first logical qubit of the pair
+   * @param physQ2 physical qubit of the second logical qubit of the pair
+   */
+  double
+  bestEdgeCost(const std::pair<std::uint16_t, std::uint16_t>& multiplicity,
+               std::size_t skipEdges, std::uint16_t physQ1,
+               std::uint16_t physQ2) const;
+
+  /**
+   * @brief the maximum fidelity savings of moving a logical qubit from the
+   * physical qubit `location` to any other physical qubit and executing its
+   * 1Q-gates there (see `singleQubitSavings`, memoized in
+   * `HeuristicMapper::fidelityCostMemo`)
+   *
+   * @param multiplicity number of 1Q-gates on the logical qubit
+   * @param skipEdges number of edges skipped in the fidelity distances
+   * @param location physical qubit of the logical qubit
+   */
+  double bestQubitSavings(std::uint16_t multiplicity, std::size_t skipEdges,
+                          std::uint16_t location) const;
+
+  /**
+   * @brief number of edges skipped in the fidelity distances of
+   * `Heuristic::FidelityBestLocation` for the given layer
+   */
+  [[nodiscard]] std::size_t fidelitySkipEdges(std::size_t layer) const;
+
+  /**
+   * @brief discards all costs in `HeuristicMapper::fidelityCostMemo` and
+   * prepares it for the multiplicities of the current layers
+   */
+  void resetFidelityCostMemo();
+
   /**
    * @brief calculates the heuristic cost of the current mapping in the node
    * for some given layer and writes it to `Node::costHeur`, additionally
@@ -384,29 +1204,69 @@ protected:
    */
   void updateLookaheadPenalty(std::size_t layer, Node& node);
 
+  /**
+   * @brief calculates the lookahead penalty for one layer using
+   * `Configuration::lookaheadHeuristic`
+   *
+   * @param lookahead lookahead layer for which to calculate the penalty
+   * @param cache cost contributions to reuse for unaffected gates
+   * @param reuse reusability of the contributions in `cache`
+   * @param node search node for which to calculate the heuristic cost
+   *
+   * @return lookahead penalty (before applying the lookahead factor)
+   */
+  double lookaheadLayerPenalty(const GateCostCache::LookaheadLayer& lookahead,
+                               const GateCostCache&                 cache,
+                               const GateCostReuse& reuse,
+                               const Node&          node) const;
+
   /**
    * @brief calculates the lookahead penalty for one layer using
    * `LookaheadHeuristic::GateCountMaxDistance`
    *
-   * @param layer index of the circuit layer for which to calculate the
-   * lookahead penalty
+   * @param lookahead lookahead layer for which to calculate the penalty
+   * @param cache cost contributions to reuse for unaffected gates
+   * @param reuse reusability of the contributions in `cache`
    * @param node search node for which to calculate the heuristic cost
    *
    * @return lookahead penalty
    */
-  double lookaheadGateCountMaxDistance(std::size_t layer, Node& node);
+  double lookaheadGateCountMaxDistance(
+      const GateCostCache::LookaheadLayer& lookahead,
+      const GateCostCache& cache, const GateCostReuse& reuse,
+      const Node& node) const;
 
   /**
    * @brief calculates the lookahead penalty for one layer using
    * `LookaheadHeuristic::GateCountSumDistance`
    *
-   * @param layer index of the circuit layer for which to calculate the
-   * lookahead penalty
+   * @param lookahead lookahead layer for which to calculate the penalty
+   * @param cache cost contributions to reuse for unaffected gates
+   * @param reuse reusability of the contributions in `cache`
+   * @param node search node for which to calculate the heuristic cost
+   *
+   * @return lookahead penalty
+   */
+  double lookaheadGateCountSumDistance(
+      const GateCostCache::LookaheadLayer& lookahead,
+      const GateCostCache& cache, const GateCostReuse& reuse,
+      const Node& node) const;
+
+  /**
+   * @brief calculates the lookahead penalty for one layer using
+   * `LookaheadHeuristic::FidelityBestLocation`
+   *
+   * @param lookahead lookahead layer for which to calculate the penalty
+   * @param cache cost contributions to reuse for unaffected gates
+   * @param reuse reusability of the contributions in `cache`
    * @param node search node for which to calculate the heuristic cost
    *
    * @return lookahead penalty
    */
-  double lookaheadGateCountSumDistance(std::size_t layer, Node& node);
+  double lookaheadFidelityBestLocation(
+      const GateCostCache::LookaheadLayer& lookahead,
+      const GateCostCache& cache, const GateCostReuse& reuse,
+      const Node& node) const;
 
   static double computeEffectiveBranchingRate(std::size_t       nodesProcessed,
                                               const std::size_t solutionDepth) {
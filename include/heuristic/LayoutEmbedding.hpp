@@ -0,0 +1,227 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "Architecture.hpp"
+#include "utils.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#pragma once
+
+/**
+ * Embeds the interaction graph of a circuit (logical qubits connected by their
+ * 2Q-gates) into the coupling graph of an architecture, i.e. computes an
+ * initial layout in which frequently interacting qubits are placed close to
+ * each other (see `InitialLayout::GraphIsomorphism`).
+ *
+ * The cost of a layout is the sum over all interacting qubit pairs of the
+ * weight of their gates times the cost of executing them at the positions of
+ * the layout:
+ * - gate count: the distance of the positions (including direction reversals)
+ * - fidelity-aware: the fidelity cost of moving the qubits to an edge and
+ *   executing the gates there (the edge of the positions, if they are adjacent,
+ *   or the edge minimizing the cost of a single gate, see `meetingEdges`);
+ *   1Q-gates additionally contribute their fidelity cost at their position
+ *
+ * The layout is first constructed greedily (placing the qubits in order of
+ * their interactions with the already placed ones) and improved by a local
+ * search over moves and exchanges of qubits. Afterwards, a branch-and-bound
+ * search (in the style of VF2) enumerates subgraph isomorphisms of the
+ * interaction graph in the coupling graph, i.e. layouts in which all
+ * interacting pairs are adjacent, bounded by the cost of the best layout so
+ * far (see `remainingBounds`). The latter thus stops as soon as no remaining
+ * candidate can lower the cost, and both searches stop at the given deadline.
+ */
+class LayoutEmbedding {
+public:
+  /**
+   * @brief weight of a gate relative to a gate in the preceding layer, i.e.
+   * gates far into the circuit have less influence on the initial layout
+   */
+  static constexpr double LAYER_DECAY = 0.9;
+  /**
+   * @brief number of search nodes of the isomorphism search between two
+   * checks of the deadline
+   */
+  static constexpr std::size_t DEADLINE_CHECK_INTERVAL = 1024;
+
+  /**
+   * @param arch architecture to embed the circuit into
+   * @param nLogical number of logical qubits (including teleportation qubits)
+   * @param fidelityAware if the layout should be scored by the fidelity data
+   * of `arch` instead of its distances
+   */
+  LayoutEmbedding(const Architecture& arch, std::uint16_t nLogical,
+                  bool fidelityAware);
+
+  /**
+   * @brief adds 2Q-gates on the given logical qubits to the interaction graph
+   *
+   * @param edge logical qubits of the gates (control, target)
+   * @param multiplicity number of gates in each direction
+   * @param weight weight of each gate (see `LAYER_DECAY`)
+   */
+  void
+  addTwoQubitGates(const Edge&                                    edge,
+                   const std::pair<std::uint16_t, std::uint16_t>& multiplicity,
+                   double                                         weight);
+
+  /**
+   * @brief adds 1Q-gates on the given logical qubit (only relevant if the
+   * embedding is fidelity-aware)
+   *
+   * @param logQbit logical qubit of the gates
+   * @param multiplicity number of gates
+   * @param weight weight of each gate (see `LAYER_DECAY`)
+   */
+  void addSingleQubitGates(std::uint16_t logQbit, std::uint16_t multiplicity,
+                           double weight);
+
+  /**
+   * @brief computes a layout of all logical qubits with gates
+   *
+   * @param occupied physical qubits which may not be used (e.g. by
+   * teleportation qubits)
+   * @param until point in time at which the search is stopped
+   * @return the physical qubit of each logical qubit (`DEFAULT_POSITION` for
+   * qubits without gates)
+   */
+  std::vector<std::int16_t>
+  embed(const std::vector<bool>&              occupied,
+        std::chrono::steady_clock::time_point until);
+
+  /**
+   * @brief cost of the layout returned by the last call of `embed`
+   */
+  [[nodiscard]] double getCost() const { return bestCost; }
+
+  /**
+   * @brief true if the layout returned by the last call of `embed` places all
+   * interacting qubits on adjacent physical qubits
+   */
+  [[nodiscard]] bool isIsomorphism() const { return isomorphism; }
+
+protected:
+  struct Interaction {
+    /** the other logical qubit of the pair */
+    std::uint16_t partner = 0;
+    /** weight of the gates from this qubit to `partner` */
+    double forward = 0.;
+    /** weight of the gates from `partner` to this qubit */
+    double reverse = 0.;
+  };
+
+  const Architecture& architecture;
+  std::uint16_t       nqubits;
+  std::uint16_t       nlogical;
+  bool                fidelity;
+
+  /** interacting qubit pairs, adjacency lists of the interaction graph */
+  std::vector<std::vector<Interaction>> interactions{};
+  /** weight of the 1Q-gates of each logical qubit */
+  std::vector<double> singleWeights{};
+  /** undirected adjacency lists of the coupling graph */
+  std::vector<std::vector<std::uint16_t>> neighbors{};
+  /** cost of executing a gate at physical positions that are not connected */
+  double unreachableCost = 0.;
+  /**
+   * for each pair of physical qubits `(q1, q2)` (at index `q1 * nqubits + q2`),
+   * the edge `(q3, q4)` minimizing the fidelity cost of moving `q1` to `q3`
+   * and `q2` to `q4` and executing a gate from `q3` to `q4` (only if the
+   * embedding is fidelity-aware)
+   */
+  std::vector<Edge> meetingEdges{};
+
+  /** logical qubits with gates in the order in which they are placed */
+  std::vector<std::uint16_t> order{};
+  /**
+   * lower bound on the cost added by placing the qubits `order[index]`,
+   * `order[index + 1]`, ... in the isomorphism search (at index `index`)
+   */
+  std::vector<double> remainingBounds{};
+  /** current layout (logical -> physical) and its inverse */
+  std::vector<std::int16_t> locations{};
+  std::vector<std::int16_t> qubits{};
+
+  std::vector<std::int16_t> bestLocations{};
+  double                    bestCost    = 0.;
+  bool                      isomorphism = false;
+
+  std::chrono::steady_clock::time_point deadline{};
+  std::size_t                           searchNodes = 0;
+  bool                                  expired     = false;
+
+  /**
+   * @brief cost of the gates of an interacting pair placed at the given
+   * physical qubits
+   */
+  [[nodiscard]] double pairCost(const Interaction& interaction,
+                                std::uint16_t      physQ1,
+                                std::uint16_t      physQ2) const;
+
+  /** @brief false for the values used for unreachable distances */
+  [[nodiscard]] static bool isFinite(double cost);
+
+  /**
+   * @brief fidelity cost of moving a qubit between the given physical qubits
+   */
+  [[nodiscard]] double moveCost(std::uint16_t from, std::uint16_t to) const;
+
+  /**
+   * @brief cost of the 1Q-gates of a logical qubit at the given physical qubit
+   */
+  [[nodiscard]] double singleCost(std::uint16_t logQbit,
+                                  std::uint16_t physQbit) const;
+
+  /**
+   * @brief cost of all gates of the logical qubit with the current layout,
+   * counting only interactions with qubits that have been placed already
+   */
+  [[nodiscard]] double qubitCost(std::uint16_t logQbit) const;
+
+  /** @brief cost of the current layout */
+  [[nodiscard]] double layoutCost() const;
+
+  /**
+   * @brief orders the logical qubits such that each qubit interacts as much as
+   * possible with the qubits before it (see `order`)
+   */
+  void orderQubits();
+
+  /**
+   * @brief computes `remainingBounds` for the current `order`, using that the
+   * isomorphism search places each interacting pair on adjacent physical
+   * qubits
+   */
+  void computeRemainingBounds();
+
+  void place(std::uint16_t logQbit, std::uint16_t physQbit);
+  void unplace(std::uint16_t logQbit);
+
+  /** @brief places the qubits in `order` greedily at their cheapest position */
+  void greedyLayout();
+
+  /**
+   * @brief moves or exchanges placed qubits as long as this lowers the cost of
+   * the layout
+   */
+  void localSearch();
+
+  /**
+   * @brief branch-and-bound search for subgraph isomorphisms cheaper than
+   * `bestCost`, placing the qubit `order[index]` next
+   *
+   * @param index position in `order` of the next qubit to place
+   * @param cost cost of the qubits placed so far
+   */
+  void isomorphismSearch(std::size_t index, double cost);
+
+  /** @brief true (and stays true) once the deadline has passed */
+  bool deadlineExpired();
+};
@@ -0,0 +1,97 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#pragma once
+
+/**
+ * Lock-free queue with multiple producers and a single consumer. Producers
+ * push onto an intrusive stack with a compare-and-swap loop, the consumer
+ * takes the whole stack at once (which avoids the ABA problem, since nodes are
+ * never popped individually by concurrent threads) and restores the FIFO order
+ * of the taken elements. Elements pushed by one producer are thereby received
+ * in the order in which they were pushed.
+ */
+template <class T> class MPSCQueue {
+public:
+  MPSCQueue() = default;
+
+  MPSCQueue(const MPSCQueue&)            = delete;
+  MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+  ~MPSCQueue() { deleteList(head.exchange(nullptr)); }
+
+  /**
+   * @brief adds an element to the queue (may be called by any thread)
+   */
+  void push(T value) {
+    auto* node =
+        new Node{std::move(value), head.load(std::memory_order_relaxed)};
+    while (!head.compare_exchange_weak(node->next, node,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+      // `node->next` has been updated to the current head, retry
+    }
+  }
+
+  /**
+   * @brief removes all elements from the queue and calls `func` for each of
+   * them in the order in which they were pushed (may only be called by the
+   * consumer thread)
+   *
+   * @return the number of consumed elements
+   */
+  template <class Func> std::size_t consumeAll(Func&& func) {
+    Node* list = head.exchange(nullptr, std::memory_order_acquire);
+    if (list == nullptr) {
+      return 0;
+    }
+
+    // reverse the stack to obtain the order of insertion
+    Node* reversed = nullptr;
+    while (list != nullptr) {
+      Node* next = list->next;
+      list->next = reversed;
+      reversed   = list;
+      list       = next;
+    }
+
+    std::size_t count = 0;
+    try {
+      while (reversed != nullptr) {
+        const std::unique_ptr<Node> node(reversed);
+        reversed = node->next;
+        func(std::move(node->value));
+        ++count;
+      }
+    } catch (...) {
+      deleteList(reversed);
+      throw;
+    }
+    return count;
+  }
+
+  [[nodiscard]] bool empty() const {
+    return head.load(std::memory_order_acquire) == nullptr;
+  }
+
+private:
+  struct Node {
+    T     value;
+    Node* next;
+  };
+
+  static void deleteList(Node* list) {
+    while (list != nullptr) {
+      const std::unique_ptr<Node> node(list);
+      list = node->next;
+    }
+  }
+
+  std::atomic<Node*> head{nullptr};
+};
@@ -0,0 +1,273 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#pragma once
+
+/**
+ * Storage for all search nodes generated in one A*-search. Instead of keeping a
+ * full copy of the swap sequence (and the derived data) in every node, each
+ * entry only stores the swap leading to it from its parent together with the
+ * index of that parent. The full swap sequence can be reconstructed by walking
+ * up the parent indices. The qubit mapping of each node is kept in one flat
+ * buffer (one row of `width` entries per node), since it is needed to order
+ * and deduplicate nodes in the priority queue.
+ *
+ * For deduplication, each entry carries a Zobrist hash of its mapping, i.e.
+ * the XOR of one random key per (physical qubit, logical qubit) pair. Since a
+ * swap only changes two of these pairs, the hash of a child is obtained from
+ * the hash of its parent in O(1) (see `hashExchange`). The keys only depend on
+ * the width, so all arenas of the same width share one immutable key table.
+ *
+ * Entries are only ever appended (or the last one discarded) until `reset` is
+ * called, which keeps the allocated capacity for the next search. In a
+ * memory-bounded search, `compact` may be used to drop all but a few nodes.
+ */
+class NodeArena {
+public:
+  using Index = std::size_t;
+
+  static constexpr Index NO_PARENT = std::numeric_limits<Index>::max();
+
+  struct Entry {
+    /** swap applied to the parent to obtain this node (`qc::OpType::None` for
+     * the root) */
+    Exchange swap{0, 0, qc::OpType::None};
+    /** index of the parent node in the arena, `NO_PARENT` for the root */
+    Index parent = NO_PARENT;
+    /** id of the node in the search (as used in data logging) */
+    std::size_t id = 0;
+    double      costFixed          = 0.;
+    double      costFixedReversals = 0.;
+    double      costHeur           = 0.;
+    double      lookaheadPenalty   = 0.;
+    std::size_t sharedSwaps        = 0;
+    std::size_t depth              = 0;
+    /** number of gates (pairs of logical qubits) mapped next to each other */
+    std::size_t validMappedTwoQubitGates = 0;
+    bool        validMapping             = true;
+    /** Zobrist hash of the mapping of the node (see `hashMapping`) */
+    std::uint64_t hash = 0;
+
+    /**
+     * @brief returns costFixed + costHeur + lookaheadPenalty
+     */
+    [[nodiscard]] double getTotalCost() const {
+      return costFixed + costFixedReversals + costHeur + lookaheadPenalty;
+    }
+
+    /**
+     * @brief returns costFixed + lookaheadPenalty
+     */
+    [[nodiscard]] double getTotalFixedCost() const {
+      return costFixed + costFixedReversals + lookaheadPenalty;
+    }
+  };
+
+  /**
+   * @brief discards all stored nodes in O(1) while keeping the allocated
+   * memory, and sets the number of physical qubits stored per mapping
+   */
+  void reset(const std::size_t mappingWidth) {
+    entries.clear();
+    mappings.clear();
+    if (mappingWidth != width) {
+      width = mappingWidth;
+      initZobristKeys();
+    }
+  }
+
+  /**
+   * @brief computes the Zobrist hash of a mapping from scratch in O(width)
+   *
+   * @param qubits mapping, `qubits[physical_qubit] = logical_qubit` (or -1 if
+   * no logical qubit is mapped to the physical qubit)
+   */
+  [[nodiscard]] std::uint64_t hashMapping(const std::int16_t* qubits) const {
+    std::uint64_t hash = 0;
+    for (std::size_t i = 0; i < width; ++i) {
+      hash ^= zobristKey(i, qubits[i]);
+    }
+    return hash;
+  }
+
+  /**
+   * @brief value to XOR onto the hash of a mapping to obtain the hash of the
+   * mapping after exchanging the logical qubits at two physical qubits
+   *
+   * @param p1 first physical qubit
+   * @param p2 second physical qubit
+   * @param q1 logical qubit at `p1` (before the exchange) or -1
+   * @param q2 logical qubit at `p2` (before the exchange) or -1
+   */
+  [[nodiscard]] std::uint64_t hashExchange(const std::uint16_t p1,
+                                           const std::uint16_t p2,
+                                           const std::int16_t  q1,
+                                           const std::int16_t  q2) const {
+    return zobristKey(p1, q1) ^ zobristKey(p2, q2) ^ zobristKey(p1, q2) ^
+           zobristKey(p2, q1);
+  }
+
+  /**
+   * @brief appends a node to the arena
+   *
+   * @param entry the swap, parent index and costs of the node
+   * @param qubits mapping of the node, `qubits[physical_qubit] =
+   * logical_qubit`, of which the first `width` entries are stored
+   *
+   * @return index of the new node
+   */
+  Index add(const Entry& entry, const std::int16_t* qubits) {
+    assert(entry.hash == hashMapping(qubits));
+    entries.emplace_back(entry);
+    mappings.insert(mappings.end(), qubits, qubits + width);
+    return entries.size() - 1;
+  }
+
+  /**
+   * @brief removes the node added last (e.g. if it was not accepted by the
+   * priority queue), no other node may refer to it as its parent
+   */
+  void discardLast() {
+    assert(!entries.empty());
+    entries.pop_back();
+    mappings.resize(mappings.size() - width);
+  }
+
+  [[nodiscard]] const Entry& at(const Index i) const {
+    assert(i < entries.size());
+    return entries[i];
+  }
+
+  /**
+   * @brief returns a pointer to the first of the `width` entries of the
+   * mapping of the given node
+   */
+  [[nodiscard]] const std::int16_t* mapping(const Index i) const {
+    assert(i < entries.size());
+    return mappings.data() + i * width;
+  }
+
+  /**
+   * @brief collects all swaps on the path from the root to the given node in
+   * the order in which they have to be applied
+   */
+  void collectSwaps(Index i, std::vector<Exchange>& swaps) const {
+    swaps.clear();
+    for (; entries[i].parent != NO_PARENT; i = entries[i].parent) {
+      swaps.emplace_back(entries[i].swap);
+    }
+    std::reverse(swaps.begin(), swaps.end());
+  }
+
+  /**
+   * @brief discards all nodes except for the given ones and their ancestors,
+   * and releases the memory of the discarded nodes
+   *
+   * @param keep indices of the nodes to keep
+   *
+   * @return the new index of each previously stored node (`NO_PARENT` for
+   * discarded nodes)
+   */
+  std::vector<Index> compact(const std::vector<Index>& keep) {
+    std::vector<bool> kept(entries.size(), false);
+    std::size_t       nrKept = 0;
+    for (auto i : keep) {
+      for (; i != NO_PARENT && !kept[i]; i = entries[i].parent) {
+        kept[i] = true;
+        ++nrKept;
+      }
+    }
+
+    std::vector<Index>        newIndex(entries.size(), NO_PARENT);
+    std::vector<Entry>        keptEntries{};
+    std::vector<std::int16_t> keptMappings{};
+    keptEntries.reserve(nrKept);
+    keptMappings.reserve(nrKept * width);
+    // parents are always stored before their children, i.e. their new index is
+    // already known when a child is moved
+    for (Index i = 0; i < entries.size(); ++i) {
+      if (!kept[i]) {
+        continue;
+      }
+      newIndex[i] = keptEntries.size();
+      auto& entry = keptEntries.emplace_back(entries[i]);
+      if (entry.parent != NO_PARENT) {
+        entry.parent = newIndex[entry.parent];
+      }
+      keptMappings.insert(keptMappings.end(), mapping(i), mapping(i) + width);
+    }
+    entries.swap(keptEntries);
+    mappings.swap(keptMappings);
+    return newIndex;
+  }
+
+  [[nodiscard]] std::size_t size() const { return entries.size(); }
+  [[nodiscard]] bool        empty() const { return entries.empty(); }
+  [[nodiscard]] std::size_t getWidth() const { return width; }
+
+  /**
+   * @brief approximate number of bytes currently held by the arena
+   */
+  [[nodiscard]] std::size_t memoryUsage() const {
+    return entries.capacity() * sizeof(Entry) +
+           mappings.capacity() * sizeof(std::int16_t);
+  }
+
+private:
+  /** fixed seed, so that hashes (and thereby memory layouts) are reproducible */
+  static constexpr std::uint64_t ZOBRIST_SEED = 0x9E3779B97F4A7C15ULL;
+
+  void initZobristKeys() {
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    static std::mutex mutex;
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    static std::map<std::size_t,
+                    std::weak_ptr<const std::vector<std::uint64_t>>>
+        tables;
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    auto&                             table = tables[width];
+
+    zobristKeys = table.lock();
+    if (!zobristKeys) {
+      auto keys =
+          std::make_shared<std::vector<std::uint64_t>>(width * (width + 1));
+      std::mt19937_64 mt(ZOBRIST_SEED);
+      std::generate(keys->begin(), keys->end(), std::ref(mt));
+      zobristKeys = std::move(keys);
+      table       = zobristKeys;
+    }
+  }
+
+  [[nodiscard]] std::uint64_t zobristKey(const std::size_t  physical,
+                                         const std::int16_t logical) const {
+    assert(physical < width && logical >= -1 &&
+           static_cast<std::size_t>(logical + 1) <= width);
+    return (*zobristKeys)[physical * (width + 1) +
+                          static_cast<std::size_t>(logical + 1)];
+  }
+
+  std::vector<Entry>        entries{};
+  std::vector<std::int16_t> mappings{};
+  std::size_t               width = 0;
+  /** one key per physical qubit and logical qubit (shifted by one, so that
+   * index 0 corresponds to an unmapped physical qubit), shared by all arenas
+   * of the same width */
+  std::shared_ptr<const std::vector<std::uint64_t>> zobristKeys{};
+};
@@ -0,0 +1,63 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "heuristic/HeuristicMapper.hpp"
+
+#include <vector>
+
+#pragma once
+
+/**
+ * Races several configurations of the `HeuristicMapper` or `SabreMapper`
+ * (see `Configuration::portfolio`) against each other, each on its own thread
+ * and its own copy of the architecture, and keeps the best result.
+ *
+ * All runs share the wall-clock budget given by `Configuration::timeout`: each
+ * run uses the rest of it as its own timeout and hence returns a (possibly
+ * degraded) result within the budget. Results are compared by the number of
+ * SWAPs and teleportations (and then by the number of gates), or by the
+ * fidelity of the mapped circuit if `Configuration::heuristic` is
+ * fidelity-aware. In the former case, a run is cancelled as soon as the
+ * exchanges it has already committed exceed those of a finished run, since it
+ * can no longer win.
+ */
+class PortfolioMapper : public Mapper {
+public:
+  using Mapper::Mapper; // import constructors from parent class
+
+  /**
+   * @brief number of passes of the iterative bidirectional routing variant in
+   * the default portfolio
+   */
+  static constexpr std::size_t DEFAULT_BIDIRECTIONAL_PASSES = 2;
+  /**
+   * @brief tolerance when comparing the log fidelities of results
+   */
+  static constexpr double FIDELITY_TOLERANCE = 1e-6;
+
+  /**
+   * @brief map the circuit passed at initialization to the architecture
+   *
+   * @param config the settings for this mapping run, i.e. the portfolio of
+   * configurations and their shared timeout
+   */
+  void map(const Configuration& config) override;
+
+  /**
+   * @brief the configurations raced by `map` for the given settings, i.e.
+   * `Configuration::portfolio` or, if it is empty, variants of `config` using
+   * different heuristics and iterative bidirectional routing
+   */
+  [[nodiscard]] static std::vector<Configuration>
+  portfolioFor(const Configuration& config);
+
+protected:
+  /**
+   * @brief whether the result `a` is strictly better than the result `b`
+   */
+  [[nodiscard]] static bool isBetter(const MappingResults& a,
+                                     const MappingResults& b,
+                                     bool                  fidelityObjective);
+};
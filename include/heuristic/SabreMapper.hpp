@@ -0,0 +1,82 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "heuristic/HeuristicMapper.hpp"
+
+#include <vector>
+
+#pragma once
+
+/**
+ * Routes each layer greedily (instead of by an A*-search), by repeatedly
+ * inserting the SWAP that minimizes the distance of the gates of the layer
+ * (the front layer) and of the gates of the following `nrLookaheads` layers
+ * (the extended set) as in SABRE. Each SWAP is chosen without any search,
+ * at the cost of more SWAPs than `HeuristicMapper`.
+ *
+ * Layering, initial layout and iterative bidirectional routing are shared with
+ * `HeuristicMapper`; `Configuration::heuristic` is ignored.
+ *
+ * G. Li, Y. Ding, and Y. Xie, "Tackling the qubit mapping problem for
+ * NISQ-era quantum devices", Proc. 24th Int. Conf. on Architectural Support
+ * for Program. Languages and Oper. Syst. (ASPLOS)
+ * https://arxiv.org/abs/1809.02573
+ */
+class SabreMapper : public HeuristicMapper {
+public:
+  using HeuristicMapper::HeuristicMapper; // import constructors
+
+  /**
+   * @brief increase of the decay of a physical qubit each time it is swapped,
+   * which discourages swapping the same qubits over and over
+   */
+  static constexpr double DECAY_INCREMENT = 0.001;
+  /**
+   * @brief number of SWAPs after which the decay of all qubits is reset
+   */
+  static constexpr std::size_t DECAY_RESET = 5;
+
+protected:
+  /** 2Q-gates of the extended set of the current layer and their weights */
+  std::vector<std::pair<Edge, double>> extendedSet{};
+  /** SWAPs considered in the current step */
+  std::vector<Edge> candidates{};
+  /** decay of each physical qubit */
+  std::vector<double> decay{};
+
+  void checkParameters() override;
+
+  /**
+   * @brief routes the given layer greedily (see `SabreMapper`)
+   *
+   * If the front layer does not get closer to being routed for as many SWAPs
+   * as the architecture has qubits, the layer is split (if it contains several
+   * 2Q-gates) or its 2Q-gate is routed along a shortest path.
+   *
+   * @param layer index of the current circuit layer
+   * @param reverse if true, the circuit is mapped from the end to the
+   * beginning (and the extended set consists of the preceding layers)
+   */
+  Node aStarMap(std::size_t layer, bool reverse) override;
+
+  /**
+   * @brief collects the 2Q-gates of the layers following the given one (in
+   * the direction of routing) into `extendedSet`
+   */
+  void collectExtendedSet(std::size_t layer, bool reverse, const Node& node);
+
+  /**
+   * @brief cost of the given mapping with the physical qubits of `swap`
+   * exchanged, i.e. the average distance of the gates of the front layer plus
+   * the weighted average distance of the gates of the extended set
+   */
+  [[nodiscard]] double swapScore(std::size_t layer, const Node& node,
+                                 const Edge& swap) const;
+
+  /**
+   * @brief exchanges the logical qubits on the physical qubits of `swap`
+   */
+  static void applySwap(Node& node, const Edge& swap);
+};
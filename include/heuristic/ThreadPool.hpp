@@ -0,0 +1,150 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#pragma once
+
+/**
+ * Fixed-size pool of worker threads that repeatedly runs data-parallel loops
+ * (see `parallelFor`). The threads are kept alive between loops, so that even
+ * small loops (e.g. over the children of a single search node) can be
+ * distributed without the overhead of spawning threads.
+ */
+class ThreadPool {
+public:
+  /**
+   * @param nThreads total number of threads working on each loop, including
+   * the thread calling `parallelFor` (i.e. `nThreads - 1` workers are started)
+   */
+  explicit ThreadPool(const std::size_t nThreads) {
+    const auto nWorkers = std::max<std::size_t>(nThreads, 1) - 1;
+    workers.reserve(nWorkers);
+    for (std::size_t i = 0; i < nWorkers; ++i) {
+      workers.emplace_back([this, i]() { work(i + 1); });
+    }
+  }
+
+  ThreadPool(const ThreadPool&)            = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  /**
+   * @brief number of threads working on each loop
+   */
+  [[nodiscard]] std::size_t size() const { return workers.size() + 1; }
+
+  /**
+   * @brief calls `func(thread, i)` for all `i` in `[0, n)` and blocks until all
+   * calls have finished
+   *
+   * The iterations are distributed dynamically among the threads, `thread` is
+   * the index (in `[0, size())`) of the thread executing the iteration and may
+   * be used to access per-thread scratch data. If any call throws, the first
+   * exception is rethrown in the calling thread (after all other started
+   * iterations have finished).
+   */
+  void parallelFor(const std::size_t                               n,
+                   const std::function<void(std::size_t, std::size_t)>& func) {
+    if (workers.empty() || n <= 1) {
+      for (std::size_t i = 0; i < n; ++i) {
+        func(0, i);
+      }
+      return;
+    }
+
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      job        = &func;
+      iterations = n;
+      next       = 0;
+      busy       = workers.size();
+      exception  = nullptr;
+      ++generation;
+    }
+    jobAvailable.notify_all();
+
+    runIterations(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [this]() { return busy == 0; });
+    job = nullptr;
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+private:
+  void work(const std::size_t thread) {
+    std::size_t seenGeneration = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobAvailable.wait(lock, [this, seenGeneration]() {
+          return stop || generation != seenGeneration;
+        });
+        if (stop) {
+          return;
+        }
+        seenGeneration = generation;
+      }
+
+      runIterations(thread);
+
+      {
+        const std::lock_guard<std::mutex> lock(mutex);
+        --busy;
+      }
+      jobDone.notify_one();
+    }
+  }
+
+  void runIterations(const std::size_t thread) {
+    for (auto i = next.fetch_add(1); i < iterations; i = next.fetch_add(1)) {
+      try {
+        (*job)(thread, i);
+      } catch (...) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (!exception) {
+          exception = std::current_exception();
+        }
+        // skip all remaining iterations
+        next = iterations;
+      }
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::mutex               mutex;
+  std::condition_variable  jobAvailable;
+  std::condition_variable  jobDone;
+
+  const std::function<void(std::size_t, std::size_t)>* job = nullptr;
+  std::size_t                                          iterations = 0;
+  std::atomic<std::size_t>                             next{0};
+  /** number of workers that have not finished the current loop yet */
+  std::size_t        busy       = 0;
+  std::size_t        generation = 0;
+  bool               stop       = false;
+  std::exception_ptr exception  = nullptr;
+};
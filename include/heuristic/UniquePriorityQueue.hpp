@@ -3,132 +3,134 @@
 // See README.md or go to https://github.com/cda-tum/qmap for more information.
 //
 
-#include <array>
 #include <cassert>
-#include <iostream>
-#include <queue>
-#include <set>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
 #include <vector>
 
 #pragma once
 
-constexpr int    MAX_QUEUE_SIZE               = 6000000;
-constexpr int    MAX_NODES_MARGIN             = 500000;
-constexpr int    MAX_QUEUE_COPY_LENGTH        = 1000000;
-constexpr double QUEUE_COPY_LENGTH_PERCENTAGE = 1. / 6;
-
 template <class T> struct DoNothing {
   void operator()(const T& /*unused*/) {
     // intentionally left blank
   }
 };
 
-template <class T, class Container = std::vector<T>,
-          class Compare = std::less<typename Container::value_type>>
-class OwnPriorityQueue : public std::priority_queue<T, Container, Compare> {
-public:
-  Container& getContainer() { return this->c; }
-};
-
 /**
- * Priority queue with unique (according to FuncCompare) elements of type T
- * where the sorting is based on CostCompare. If NDEBUG is *not* defined, there
- * are some assertions that help catching errors in the provided comparison
- * functions.
+ * Priority queue with unique (according to Hash and KeyEqual) elements of type
+ * T where the sorting is based on CostCompare. The queue is an addressable
+ * binary heap: each element knows its position in the heap, so that replacing
+ * an element by a cheaper equivalent one (decrease-key) only takes O(log n).
+ * Equivalent elements are detected through a hash table, i.e. Hash should be
+ * cheap to evaluate (e.g. return a precomputed value) while KeyEqual is only
+ * called for elements with equal hashes. If NDEBUG is *not* defined, there are
+ * some assertions that help catching errors in the provided comparison
+ * functions. The comparison functions may carry state (e.g. a reference to the
+ * storage the elements of type T point into), in which case they have to be
+ * passed on construction.
  */
 template <class T, class CostCompare = std::greater<T>,
-          class FuncCompare          = std::less<T>,
+          class Hash = std::hash<T>, class KeyEqual = std::equal_to<T>,
           class CleanObsoleteElement = DoNothing<T>>
 class UniquePriorityQueue {
 public:
-  using size_type =
-      typename OwnPriorityQueue<T, std::vector<T>, CostCompare>::size_type;
+  using size_type = std::size_t;
+
+  explicit UniquePriorityQueue(const CostCompare& costComp = CostCompare(),
+                               const Hash&        hash     = Hash(),
+                               const KeyEqual&    equal    = KeyEqual())
+      : costCompare(costComp), membership(0, hash, equal) {}
 
   /**
    * Return true if the element was inserted into the queue.
-   * This happens if equivalent element is present or if the new element has a
-   * lower cost associated to it. False is returned if no insertion into the
-   * queue took place.
+   * This happens if no equivalent element is present or if the new element
+   * has a lower cost associated to it (in which case it replaces the
+   * equivalent element). False is returned if no insertion into the queue took
+   * place.
    */
   bool push(const T& v) {
-    const auto& insertionPair = membership.insert(v);
-    if (insertionPair.second) {
-      queue.push(v);
-    } else if (CostCompare()(*(insertionPair.first), v)) {
-      CleanObsoleteElement()(*(insertionPair.first));
-      membership.erase(insertionPair.first);
-
-      [[maybe_unused]] const auto inserted = membership.insert(v);
-      assert(inserted.second);
-
-      queue = OwnPriorityQueue<T, std::vector<T>, CostCompare>();
-      for (const auto& element : membership) {
-        queue.push(element);
-      }
-      assert(queue.size() == membership.size());
+    const auto [it, inserted] = membership.try_emplace(v, heap.size());
+    if (inserted) {
+      heap.emplace_back(&*it);
+      siftUp(heap.size() - 1);
+      assert(heap.size() == membership.size());
+      return true;
+    }
 
+    if (costCompare(it->first, v)) {
+      const auto position = it->second;
+      assert(position < heap.size() && heap[position] == &*it);
+      CleanObsoleteElement()(it->first);
+      membership.erase(it);
+
+      [[maybe_unused]] const auto [newIt, newInserted] =
+          membership.try_emplace(v, position);
+      assert(newInserted);
+      heap[position] = &*newIt;
+      siftUp(position);
+      assert(heap.size() == membership.size());
       return true;
-    } else {
-      CleanObsoleteElement()(v);
     }
-    assert(queue.size() == membership.size());
-    return insertionPair.second;
+
+    CleanObsoleteElement()(v);
+    assert(heap.size() == membership.size());
+    return false;
   }
 
   void pop() {
-    assert(!queue.empty() && queue.size() == membership.size());
+    assert(!heap.empty() && heap.size() == membership.size());
 
-    const auto&                 topElement   = queue.top();
-    [[maybe_unused]] const auto numberErased = membership.erase(topElement);
-    assert(numberErased == 1);
+    const auto topElement = membership.find(heap.front()->first);
+    assert(topElement != membership.end() && &*topElement == heap.front());
 
-    queue.pop();
-    assert(queue.size() == membership.size());
+    heap.front() = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+      siftDown(0);
+    }
+    membership.erase(topElement);
+    assert(heap.size() == membership.size());
   }
 
   const T& top() const {
-    assert(!queue.empty());
-    return queue.top();
+    assert(!heap.empty());
+    return heap.front()->first;
   }
 
   [[nodiscard]] bool empty() const {
-    assert(queue.size() == membership.size());
-    return queue.empty();
+    assert(heap.size() == membership.size());
+    return heap.empty();
   }
 
-  size_type size() const { return queue.size(); }
+  size_type size() const { return heap.size(); }
 
-  std::vector<T>& getContainer() { return queue.get_container(); }
+  /**
+   * Approximate number of bytes held by the queue (the hash table is estimated
+   * with one pointer per bucket and a per-element overhead of a typical
+   * singly-linked hash node with cached hash value).
+   */
+  [[nodiscard]] std::size_t memoryUsage() const {
+    return heap.capacity() * sizeof(Element*) +
+           membership.bucket_count() * sizeof(void*) +
+           membership.size() * (sizeof(Element) + 2 * sizeof(void*));
+  }
 
   void deleteQueue() {
-    std::vector<T>& v = getContainer();
-    for (typename std::vector<T>::const_iterator it = v.begin(); it != v.end();
-         it++) {
-      CleanObsoleteElement()(*it);
+    for (const auto& [element, position] : membership) {
+      CleanObsoleteElement()(element);
     }
-    queue      = OwnPriorityQueue<T, std::vector<T>, CostCompare>();
-    membership = std::set<T, FuncCompare>();
+    heap.clear();
+    membership.clear();
   }
 
-  // clears the queue until a certain length is reached
-  void update() {
-    std::array<T, MAX_QUEUE_SIZE> tempQueue;
-    unsigned int                  length =
-        std::min(static_cast<int>(queue.size() * QUEUE_COPY_LENGTH_PERCENTAGE),
-                 MAX_QUEUE_COPY_LENGTH);
-
-    for (unsigned int i = 0; i < length; i++) {
-      tempQueue[i] = queue.top();
-      queue.pop();
-
-      lastNodeCopied = i;
-    }
-    deleteQueue();
-    for (unsigned int i = 0; i < length; i++) {
-      queue.push(tempQueue[i]);
-    }
-
-    std::cout << "RESULTING SIZE: " << queue.size() << std::endl;
+  /**
+   * releases memory not needed for the elements currently in the queue (which
+   * is otherwise kept to avoid reallocations when the queue is filled again)
+   */
+  void shrinkToFit() {
+    heap.shrink_to_fit();
+    membership.rehash(0);
   }
 
   void restart(T& n) {
@@ -137,7 +139,57 @@ public:
   }
 
 private:
-  OwnPriorityQueue<T, std::vector<T>, CostCompare> queue;
-  std::set<T, FuncCompare>                         membership;
-  unsigned int                                     lastNodeCopied = 0;
+  /** element and its current position in the heap */
+  using Membership = std::unordered_map<T, std::size_t, Hash, KeyEqual>;
+  using Element    = typename Membership::value_type;
+
+  /**
+   * move the element at the given position towards the root of the heap until
+   * it is not cheaper than its parent
+   */
+  void siftUp(std::size_t position) {
+    Element* element = heap[position];
+    while (position > 0) {
+      const auto parent = (position - 1) / 2;
+      if (!costCompare(heap[parent]->first, element->first)) {
+        break;
+      }
+      heap[position]         = heap[parent];
+      heap[position]->second = position;
+      position               = parent;
+    }
+    heap[position]  = element;
+    element->second = position;
+  }
+
+  /**
+   * move the element at the given position towards the leaves of the heap
+   * until it is not more expensive than any of its children
+   */
+  void siftDown(std::size_t position) {
+    Element* element = heap[position];
+    while (true) {
+      auto child = 2 * position + 1;
+      if (child >= heap.size()) {
+        break;
+      }
+      if (child + 1 < heap.size() &&
+          costCompare(heap[child]->first, heap[child + 1]->first)) {
+        ++child;
+      }
+      if (!costCompare(element->first, heap[child]->first)) {
+        break;
+      }
+      heap[position]         = heap[child];
+      heap[position]->second = position;
+      position               = child;
+    }
+    heap[position]  = element;
+    element->second = position;
+  }
+
+  CostCompare           costCompare;
+  std::vector<Element*> heap;
+  // references to elements of an unordered_map stay valid on rehashing
+  Membership membership;
 };
@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <initializer_list>
 #include <iostream>
 #include <limits>
 #include <optional>
@@ -19,7 +20,123 @@
 #include <string>
 #include <vector>
 
-using Matrix      = std::vector<std::vector<double>>;
+/**
+ * Dense row-major matrix stored in a single contiguous buffer, e.g. the
+ * distance tables of an architecture (see `Matrix`).
+ *
+ * Entries can be accessed without any indirection as `matrix(row, col)`.
+ * Rows are accessed as `matrix[row]` (or bounds-checked as `matrix.at(row)`),
+ * which returns a view of the row, such that `matrix[row][col]` and
+ * `matrix.at(row).at(col)` work as for nested vectors.
+ *
+ * @tparam T type of the entries (e.g. `float` or `std::uint16_t` for tables
+ * which do not need the precision of `double`)
+ */
+template <typename T> class FlatMatrix {
+public:
+  /** view of a single row of the matrix (invalidated by resizing it) */
+  template <typename U> class RowView {
+  public:
+    RowView(U* row, const std::size_t cols) : first(row), length(cols) {}
+
+    U& operator[](const std::size_t col) const { return first[col]; }
+    U& at(const std::size_t col) const {
+      if (col >= length) {
+        throw std::out_of_range("Matrix column index out of range.");
+      }
+      return first[col];
+    }
+    [[nodiscard]] std::size_t size() const { return length; }
+    [[nodiscard]] U*          begin() const { return first; }
+    [[nodiscard]] U*          end() const { return first + length; }
+
+  private:
+    U*          first;
+    std::size_t length;
+  };
+  using Row      = RowView<T>;
+  using ConstRow = RowView<const T>;
+
+  FlatMatrix() = default;
+  FlatMatrix(const std::size_t rows, const std::size_t cols,
+             const T& value = T{})
+      : nrows(rows), ncols(cols), entries(rows * cols, value) {}
+  /**
+   * @brief creates a matrix from its rows, which all need to have the same
+   * length, e.g. `Matrix m = {{0., 1.}, {1., 0.}};`
+   */
+  FlatMatrix(std::initializer_list<std::initializer_list<T>> rows)
+      : nrows(rows.size()), ncols(rows.size() == 0 ? 0 : rows.begin()->size()) {
+    entries.reserve(nrows * ncols);
+    for (const auto& row : rows) {
+      if (row.size() != ncols) {
+        throw std::invalid_argument("All rows of a matrix need to have the "
+                                    "same length.");
+      }
+      entries.insert(entries.end(), row.begin(), row.end());
+    }
+  }
+
+  /** @brief resizes the matrix and sets all entries to `value` */
+  void assign(const std::size_t rows, const std::size_t cols,
+              const T& value = T{}) {
+    nrows = rows;
+    ncols = cols;
+    entries.assign(rows * cols, value);
+  }
+  void clear() { assign(0, 0); }
+
+  /** @brief number of rows (as for nested vectors) */
+  [[nodiscard]] std::size_t size() const { return nrows; }
+  [[nodiscard]] std::size_t rows() const { return nrows; }
+  [[nodiscard]] std::size_t cols() const { return ncols; }
+  [[nodiscard]] bool        empty() const { return nrows == 0; }
+
+  T& operator()(const std::size_t row, const std::size_t col) {
+    return entries[row * ncols + col];
+  }
+  const T& operator()(const std::size_t row, const std::size_t col) const {
+    return entries[row * ncols + col];
+  }
+
+  Row operator[](const std::size_t row) {
+    return {entries.data() + row * ncols, ncols};
+  }
+  ConstRow operator[](const std::size_t row) const {
+    return {entries.data() + row * ncols, ncols};
+  }
+  Row at(const std::size_t row) {
+    checkRow(row);
+    return (*this)[row];
+  }
+  [[nodiscard]] ConstRow at(const std::size_t row) const {
+    checkRow(row);
+    return (*this)[row];
+  }
+
+  /** @brief all entries in row-major order */
+  [[nodiscard]] T*       data() { return entries.data(); }
+  [[nodiscard]] const T* data() const { return entries.data(); }
+
+  bool operator==(const FlatMatrix& other) const {
+    return nrows == other.nrows && ncols == other.ncols &&
+           entries == other.entries;
+  }
+  bool operator!=(const FlatMatrix& other) const { return !(*this == other); }
+
+private:
+  std::size_t    nrows = 0;
+  std::size_t    ncols = 0;
+  std::vector<T> entries{};
+
+  void checkRow(const std::size_t row) const {
+    if (row >= nrows) {
+      throw std::out_of_range("Matrix row index out of range.");
+    }
+  }
+};
+
+using Matrix      = FlatMatrix<double>;
 using Edge        = std::pair<std::uint16_t, std::uint16_t>;
 using CouplingMap = std::set<Edge>;
 using QubitSubset = std::set<std::uint16_t>;
@@ -52,13 +169,14 @@ public:
 
 class Dijkstra {
 public:
-  struct Node {
-    /** true if the node has already been expanded */
-    bool visited = false;
-    /** current qubit */
-    std::optional<std::uint16_t> pos = std::nullopt;
-    /** current cost of the path */
-    double cost = -1.;
+  /**
+   * @brief undirected adjacency lists of a coupling map in compressed sparse
+   * row format, i.e. the neighbors of qubit `q` are stored in `neighbors` at
+   * the indices `offsets[q]` to `offsets[q + 1] - 1`
+   */
+  struct Adjacency {
+    std::vector<std::size_t>   offsets{};
+    std::vector<std::uint16_t> neighbors{};
   };
 
   /**
@@ -68,15 +186,19 @@ public:
    * e.g. cost of moving qubit q1 onto q2:
    * distanceTable[q1][q2]
    *
+   * Qubits that cannot be reached have a distance of -1.
+   *
    * @param couplingMap coupling map specifying all edges in the architecture
    * @param distanceTable target table
    * @param edgeWeights matrix containing costs for swapping any two, connected
    * qubits (this might be uniform for all edges or different for each edge, as
    * e.g. in the case of fidelity-aware distances or distances on
    * mixed bi/unidirectional architectures)
+   * @param nThreads number of threads computing the rows of the table (see
+   * `parallelFor`)
    */
   static void buildTable(const CouplingMap& couplingMap, Matrix& distanceTable,
-                         const Matrix& edgeWeights);
+                         const Matrix& edgeWeights, std::size_t nThreads = 1);
   /**
    * @brief builds a 3d matrix containing the distance tables giving the minimal
    * distances between 2 qubit when upto k edges can be skipped.
@@ -95,10 +217,40 @@ public:
    * qubits (this might be uniform for all edges or different for each edge, as
    * e.g. in the case of fidelity-aware distances or distances on
    * mixed bi/unidirectional architectures)
+   * @param nThreads number of threads computing the rows of each table (see
+   * `parallelFor`)
    */
   static void buildEdgeSkipTable(const CouplingMap&   couplingMap,
                                  std::vector<Matrix>& distanceTables,
-                                 const Matrix&        edgeWeights);
+                                 const Matrix&        edgeWeights,
+                                 std::size_t          nThreads = 1);
+  /**
+   * @brief repairs the tables built by `buildEdgeSkipTable` after the weights
+   * of some edges have changed, recomputing only the rows whose distances may
+   * be affected by the changes
+   *
+   * A row is kept if, for each changed edge, the edge is neither on a
+   * cheapest path (with its previous weight) nor part of a cheaper path (with
+   * its new weight). In this case, all previous cheapest paths still exist and
+   * the distances still satisfy the triangle inequality for all edges, so they
+   * are exact. Rows of skip tables are additionally recomputed if the same row
+   * of the previous table has changed. If a weight of 0 is involved, the number
+   * of tables may change and they are rebuilt from scratch.
+   *
+   * @param couplingMap coupling map specifying all edges in the architecture
+   * @param distanceTables tables built by `buildEdgeSkipTable` for
+   * `previousEdgeWeights`, which are updated to `edgeWeights`
+   * @param previousEdgeWeights edge weights the tables have been built for
+   * @param edgeWeights new edge weights
+   * @param nThreads number of threads recomputing the rows of each table (see
+   * `parallelFor`)
+   * @return number of recomputed rows (over all tables)
+   */
+  static std::size_t updateEdgeSkipTable(const CouplingMap&   couplingMap,
+                                         std::vector<Matrix>& distanceTables,
+                                         const Matrix& previousEdgeWeights,
+                                         const Matrix& edgeWeights,
+                                         std::size_t   nThreads = 1);
   /**
    * @brief builds a distance table containing the minimal costs for moving
    * logical qubits from one physical qubit to another (along the cheapest path)
@@ -112,24 +264,102 @@ public:
    * @param couplingMap coupling map specifying all edges in the architecture
    * @param reversalCost cost for reversing an edge
    * @param edgeSkipDistanceTable target distance table
+   * @param nThreads number of threads computing the rows of the table (see
+   * `parallelFor`)
    */
   static void buildSingleEdgeSkipTable(const Matrix&      distanceTable,
                                        const CouplingMap& couplingMap,
                                        double             reversalCost,
-                                       Matrix& edgeSkipDistanceTable);
+                                       Matrix&            edgeSkipDistanceTable,
+                                       std::size_t        nThreads = 1);
+
+  /**
+   * @brief builds the undirected adjacency lists of the given coupling map
+   * (each pair of connected qubits is listed once, regardless of the
+   * directions in which it is contained in the coupling map)
+   *
+   * @param couplingMap coupling map specifying all edges in the architecture
+   * @param nqubits number of qubits, all edges have to be between qubits
+   * smaller than this
+   */
+  static Adjacency buildAdjacency(const CouplingMap& couplingMap,
+                                  std::uint16_t      nqubits);
+
+  /**
+   * @brief minimum number of rows of a table to compute them in parallel (with
+   * more than one thread requested)
+   */
+  static constexpr std::size_t PARALLEL_MIN_ROWS = 64;
 
 protected:
-  static void dijkstra(const CouplingMap& couplingMap, std::vector<Node>& nodes,
-                       std::uint16_t start, const Matrix& edgeWeights);
+  /**
+   * Binary min-heap of qubits ordered by their costs (stored outside of the
+   * heap), which supports lowering the cost of a qubit already in the heap.
+   */
+  class IndexedHeap {
+  public:
+    explicit IndexedHeap(const std::size_t nqubits)
+        : positions(nqubits, NOT_CONTAINED) {}
+
+    [[nodiscard]] bool empty() const { return heap.empty(); }
 
-  struct NodeComparator {
-    bool operator()(const Node* x, const Node* y) { return x->cost > y->cost; }
+    /**
+     * @brief inserts the qubit or, if it is already in the heap, restores the
+     * heap order after its cost has been lowered (qubits that have been popped
+     * already are ignored)
+     */
+    void push(std::uint16_t qubit, const Matrix::Row& costs);
+    /** @brief removes and returns the qubit with the lowest cost */
+    std::uint16_t pop(const Matrix::Row& costs);
+
+  private:
+    static constexpr std::size_t NOT_CONTAINED =
+        std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t POPPED = NOT_CONTAINED - 1;
+
+    std::vector<std::uint16_t> heap{};
+    /** position of each qubit in `heap` (or `NOT_CONTAINED`/`POPPED`) */
+    std::vector<std::size_t> positions{};
+
+    void siftUp(std::size_t index, const Matrix::Row& costs);
+    void siftDown(std::size_t index, const Matrix::Row& costs);
   };
-};
 
-inline bool operator<(const Dijkstra::Node& x, const Dijkstra::Node& y) {
-  return x.cost < y.cost;
-}
+  /**
+   * @brief lowers `costs` to the costs of the cheapest paths starting at any
+   * qubit with a finite initial cost (i.e. with the initial cost of the start
+   * qubit added); unreachable qubits keep the cost
+   * `std::numeric_limits<double>::max()`
+   */
+  static void dijkstra(const Adjacency& adjacency, const Matrix& edgeWeights,
+                       const Matrix::Row& costs);
+
+  /**
+   * @brief computes the row of `source` in the table of `buildTable`
+   */
+  static void shortestPaths(const Adjacency&   adjacency,
+                            const Matrix&      edgeWeights,
+                            std::size_t        source,
+                            const Matrix::Row& costs);
+
+  /**
+   * @brief computes the row of `source` in a table of `buildEdgeSkipTable`
+   * from its row `previous` in the table skipping one edge less
+   */
+  static void edgeSkipShortestPaths(const Adjacency&        adjacency,
+                                    const Matrix&           edgeWeights,
+                                    std::size_t             source,
+                                    const Matrix::ConstRow& previous,
+                                    const Matrix::Row&      costs);
+
+  /**
+   * @brief calls `func(i)` for all `i` in `[0, n)`, distributed over up to
+   * `nThreads` threads (including the calling one) if `n >= PARALLEL_MIN_ROWS`
+   * and sequentially otherwise
+   */
+  static void parallelFor(std::size_t n, std::size_t nThreads,
+                          const std::function<void(std::size_t)>& func);
+};
 
 /// Iterating routine through all combinations
 /// \tparam Iterator iterator type
@@ -7,8 +7,194 @@
 
 #include "utils.hpp"
 
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <type_traits>
 #include <utility>
 
+namespace {
+/** first bytes of every entry of the table cache */
+constexpr std::array<char, 8> TABLE_CACHE_MAGIC = {'Q', 'M', 'A', 'P',
+                                                   'T', 'B', 'L', '\0'};
+/** entries written on machines with another byte order are not read */
+constexpr std::uint32_t TABLE_CACHE_BYTE_ORDER = 0x01020304U;
+
+std::mutex& tableCacheMutex() {
+  static std::mutex mutex{};
+  return mutex;
+}
+
+std::string& tableCacheDirectory() {
+  static std::string directory{};
+  return directory;
+}
+
+/** 64-bit FNV-1a hash */
+std::uint64_t hashTableCacheKey(const std::string& key) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const char c : key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::filesystem::path tableCachePath(const std::string& directory,
+                                     const std::string& kind,
+                                     const std::string& key) {
+  std::ostringstream filename;
+  filename << kind << '-' << std::hex << std::setw(16) << std::setfill('0')
+           << hashTableCacheKey(key) << ".bin";
+  return std::filesystem::path(directory) / filename.str();
+}
+
+class TableCacheWriter {
+public:
+  explicit TableCacheWriter(std::ostream& stream) : os(stream) {}
+
+  template <class T> void write(const T& value) { writeRaw(&value, 1U); }
+
+  void write(const std::vector<double>& values) {
+    write(static_cast<std::uint64_t>(values.size()));
+    writeRaw(values.data(), values.size());
+  }
+  void write(const Matrix& matrix) {
+    write(static_cast<std::uint64_t>(matrix.rows()));
+    write(static_cast<std::uint64_t>(matrix.cols()));
+    writeRaw(matrix.data(), matrix.rows() * matrix.cols());
+  }
+
+  template <class T> void writeRaw(const T* values, const std::size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    os.write(reinterpret_cast<const char*>(values),
+             static_cast<std::streamsize>(count * sizeof(T)));
+  }
+
+private:
+  std::ostream& os;
+};
+
+class TableCacheReader {
+public:
+  explicit TableCacheReader(std::istream& stream) : is(stream) {}
+
+  template <class T> bool read(T& value) { return readRaw(&value, 1U); }
+  /** @brief reads a vector, which has to be of the given size */
+  bool read(std::vector<double>& values, const std::size_t size) {
+    std::uint64_t storedSize = 0;
+    if (!read(storedSize) || storedSize != size) {
+      return false;
+    }
+    values.resize(size);
+    return readRaw(values.data(), size);
+  }
+  /** @brief reads a matrix, which has to be of the given size */
+  bool read(Matrix& matrix, const std::size_t rows, const std::size_t cols) {
+    std::uint64_t storedRows = 0;
+    std::uint64_t storedCols = 0;
+    if (!read(storedRows) || !read(storedCols) || storedRows != rows ||
+        storedCols != cols) {
+      return false;
+    }
+    matrix.assign(rows, cols);
+    return readRaw(matrix.data(), rows * cols);
+  }
+
+  template <class T> bool readRaw(T* values, const std::size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return static_cast<bool>(
+        is.read(reinterpret_cast<char*>(values),
+                static_cast<std::streamsize>(count * sizeof(T))));
+  }
+
+  /** @brief true if the whole entry has been read */
+  bool atEnd() { return is.peek() == std::istream::traits_type::eof(); }
+
+private:
+  std::istream& is;
+};
+
+/**
+ * @brief reads an entry of the table cache
+ *
+ * @return false if the entry does not exist, belongs to another key or
+ * version, or if `readTables` fails
+ */
+bool readTableCacheEntry(
+    const std::filesystem::path&                  path,
+    const std::string&                            key,
+    const std::function<bool(TableCacheReader&)>& readTables) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs.good()) {
+    return false;
+  }
+  TableCacheReader    reader(ifs);
+  std::array<char, 8> magic{};
+  std::uint32_t       version   = 0;
+  std::uint32_t       byteOrder = 0;
+  std::uint64_t       keySize   = 0;
+  if (!reader.read(magic) || magic != TABLE_CACHE_MAGIC ||
+      !reader.read(version) || version != Architecture::TABLE_CACHE_VERSION ||
+      !reader.read(byteOrder) || byteOrder != TABLE_CACHE_BYTE_ORDER ||
+      !reader.read(keySize) || keySize != key.size()) {
+    return false;
+  }
+  std::string storedKey(key.size(), '\0');
+  if (!reader.readRaw(storedKey.data(), storedKey.size()) ||
+      storedKey != key) {
+    return false;
+  }
+  return readTables(reader) && reader.atEnd();
+}
+
+/**
+ * @brief writes an entry of the table cache (failures are ignored, the tables
+ * are simply recomputed next time)
+ */
+void writeTableCacheEntry(
+    const std::filesystem::path&                  path,
+    const std::string&                            key,
+    const std::function<void(TableCacheWriter&)>& writeTables) {
+  std::error_code ec{};
+  std::filesystem::create_directories(path.parent_path(), ec);
+  // the entry is written to a temporary file first and then moved into
+  // place, so that concurrent readers never see incomplete entries
+  auto temporaryPath = path;
+  temporaryPath += ".tmp" + std::to_string(std::random_device{}());
+  {
+    std::ofstream ofs(temporaryPath, std::ios::binary);
+    if (!ofs.good()) {
+      return;
+    }
+    TableCacheWriter writer(ofs);
+    writer.write(TABLE_CACHE_MAGIC);
+    writer.write(Architecture::TABLE_CACHE_VERSION);
+    writer.write(TABLE_CACHE_BYTE_ORDER);
+    writer.write(static_cast<std::uint64_t>(key.size()));
+    writer.writeRaw(key.data(), key.size());
+    writeTables(writer);
+    ofs.flush();
+    if (!ofs.good()) {
+      ofs.close();
+      std::filesystem::remove(temporaryPath, ec);
+      return;
+    }
+  }
+  std::filesystem::rename(temporaryPath, path, ec);
+  if (ec) {
+    std::filesystem::remove(temporaryPath, ec);
+  }
+}
+} // namespace
+
 void Architecture::loadCouplingMap(AvailableArchitecture architecture) {
   std::stringstream ss{getCouplingMapSpecification(architecture)};
   name = toString(architecture);
@@ -34,6 +220,7 @@ void Architecture::loadCouplingMap(const std::string& filename) {
 void Architecture::loadCouplingMap(std::istream&& is) {
   couplingMap.clear();
   properties.clear();
+  fidelityAvailable = false;
   std::string line;
 
   const auto  rNqubits = std::regex("([0-9]+)");
@@ -68,7 +255,8 @@ void Architecture::loadCouplingMap(std::uint16_t nQ, const CouplingMap& cm) {
   nqubits     = nQ;
   couplingMap = cm;
   properties.clear();
-  name = "generic_" + std::to_string(nQ);
+  fidelityAvailable = false;
+  name              = "generic_" + std::to_string(nQ);
   createDistanceTable();
 }
 
@@ -185,10 +373,16 @@ Architecture::Architecture(const std::uint16_t nQ, const CouplingMap& cm,
 }
 
 void Architecture::createDistanceTable() {
+  createIncidentEdges();
+
+  const auto cacheDirectory = getTableCacheDirectory();
+  if (!cacheDirectory.empty() && loadDistanceTables(cacheDirectory)) {
+    return;
+  }
+
   isBidirectional  = true;
   isUnidirectional = true;
-  Matrix edgeWeights(nqubits, std::vector<double>(
-                                  nqubits, std::numeric_limits<double>::max()));
+  Matrix edgeWeights(nqubits, nqubits, std::numeric_limits<double>::max());
   for (const auto& edge : couplingMap) {
     if (couplingMap.find({edge.second, edge.first}) == couplingMap.end()) {
       // unidirectional edge
@@ -202,88 +396,338 @@ void Architecture::createDistanceTable() {
     }
   }
 
+  auto   tables = std::make_shared<DistanceTables>();
   Matrix simpleDistanceTable{};
-  Dijkstra::buildTable(couplingMap, simpleDistanceTable, edgeWeights);
+  Dijkstra::buildTable(couplingMap, simpleDistanceTable, edgeWeights,
+                       tableThreads);
   Dijkstra::buildSingleEdgeSkipTable(simpleDistanceTable, couplingMap, 0.,
-                                     distanceTable);
+                                     tables->distanceTable, tableThreads);
   if (bidirectional()) {
-    distanceTableReversals = distanceTable;
+    tables->distanceTableReversals = tables->distanceTable;
   } else {
     Dijkstra::buildSingleEdgeSkipTable(simpleDistanceTable, couplingMap,
                                        COST_DIRECTION_REVERSE,
-                                       distanceTableReversals);
+                                       tables->distanceTableReversals,
+                                       tableThreads);
+  }
+  distances = std::move(tables);
+
+  if (!cacheDirectory.empty()) {
+    storeDistanceTables(cacheDirectory);
+  }
+}
+
+void Architecture::createIncidentEdges() {
+  std::uint16_t maxQubit = nqubits;
+  for (const auto& [q1, q2] : couplingMap) {
+    maxQubit = std::max({maxQubit, static_cast<std::uint16_t>(q1 + 1U),
+                         static_cast<std::uint16_t>(q2 + 1U)});
+  }
+
+  // count the degree of each qubit
+  incidentEdgeOffsets.assign(static_cast<std::size_t>(maxQubit) + 1U, 0U);
+  for (const auto& [q1, q2] : couplingMap) {
+    ++incidentEdgeOffsets[q1 + 1U];
+    if (q2 != q1) {
+      ++incidentEdgeOffsets[q2 + 1U];
+    }
+  }
+  std::partial_sum(incidentEdgeOffsets.begin(), incidentEdgeOffsets.end(),
+                   incidentEdgeOffsets.begin());
+
+  // iterating the (ordered) coupling map keeps each list in its order
+  incidentEdges.resize(incidentEdgeOffsets.back());
+  std::vector<std::size_t> next(incidentEdgeOffsets.begin(),
+                                incidentEdgeOffsets.end() - 1);
+  for (const auto& edge : couplingMap) {
+    incidentEdges[next[edge.first]++] = edge;
+    if (edge.second != edge.first) {
+      incidentEdges[next[edge.second]++] = edge;
+    }
   }
 }
 
 void Architecture::createFidelityTable() {
-  fidelityAvailable = true;
-  fidelityTable.clear();
-  fidelityTable.resize(nqubits, std::vector<double>(nqubits, 0.0));
-  twoQubitFidelityCosts.clear();
-  twoQubitFidelityCosts.resize(
-      nqubits,
-      std::vector<double>(nqubits, std::numeric_limits<double>::max()));
-  swapFidelityCosts.clear();
-  swapFidelityCosts.resize(
-      nqubits,
-      std::vector<double>(nqubits, std::numeric_limits<double>::max()));
-
-  singleQubitFidelities.resize(nqubits, 1.0);
-  singleQubitFidelityCosts.resize(nqubits, 0.0);
+  const auto cacheDirectory = getTableCacheDirectory();
+  if (!cacheDirectory.empty() && loadFidelityTables(cacheDirectory)) {
+    return;
+  }
+
+  auto tables = std::make_shared<FidelityTables>();
+  tables->fidelityTable.assign(nqubits, nqubits, 0.0);
+  tables->twoQubitFidelityCosts.assign(nqubits, nqubits,
+                                       std::numeric_limits<double>::max());
+  tables->swapFidelityCosts.assign(nqubits, nqubits,
+                                   std::numeric_limits<double>::max());
+
+  tables->singleQubitFidelities.resize(nqubits, 1.0);
+  tables->singleQubitFidelityCosts.resize(nqubits, 0.0);
 
   for (const auto& [qubit, operationProps] :
        properties.singleQubitErrorRate.get()) {
-    singleQubitFidelities[qubit] =
+    tables->singleQubitFidelities[qubit] =
         1.0 - properties.getAverageSingleQubitErrorRate(qubit);
-    singleQubitFidelityCosts[qubit] = -std::log2(singleQubitFidelities[qubit]);
+    tables->singleQubitFidelityCosts[qubit] =
+        -std::log2(tables->singleQubitFidelities[qubit]);
   }
 
   for (const auto& [first, second] : couplingMap) {
-    if (properties.twoQubitErrorRateAvailable(first, second)) {
-      fidelityTable[first][second] =
-          1.0 - properties.getTwoQubitErrorRate(first, second);
-      twoQubitFidelityCosts[first][second] =
-          -std::log2(fidelityTable[first][second]);
-      if (couplingMap.find({second, first}) == couplingMap.end()) {
-        // CNOT reversal (unidirectional edge q1 -> q2):
-        // CX(q2,q1) = H(q1) H(q2) CX(q1,q2) H(q1) H(q2)
-        twoQubitFidelityCosts[second][first] =
-            twoQubitFidelityCosts[first][second] +
-            2 * singleQubitFidelityCosts[first] +
-            2 * singleQubitFidelityCosts[second];
-        // SWAP decomposition (unidirectional edge q1 -> q2):
-        // SWAP(q1,q2) = CX(q1,q2) H(q1) H(q2) CX(q1,q2) H(q1) H(q2) CX(q1,q2)
-        swapFidelityCosts[first][second] =
-            3 * twoQubitFidelityCosts[first][second] +
-            2 * singleQubitFidelityCosts[first] +
-            2 * singleQubitFidelityCosts[second];
-        swapFidelityCosts[second][first] = swapFidelityCosts[first][second];
-      } else {
-        // SWAP decomposition (bidirectional edge q1 <-> q2):
-        // SWAP(q1,q2) = CX(q1,q2) CX(q2,q1) CX(q1,q2)
-        swapFidelityCosts[first][second] =
-            3 * twoQubitFidelityCosts[first][second];
-      }
-    } else {
+    if (!properties.twoQubitErrorRateAvailable(first, second)) {
       fidelityAvailable = false;
-      fidelityTable.clear();
-      singleQubitFidelities.clear();
-      twoQubitFidelityCosts.clear();
-      swapFidelityCosts.clear();
+      fidelities        = std::make_shared<const FidelityTables>();
       return;
     }
+    createEdgeFidelityCosts(*tables, first, second);
+  }
+
+  Dijkstra::buildEdgeSkipTable(couplingMap, tables->fidelityDistanceTables,
+                               tables->swapFidelityCosts, tableThreads);
+  fidelityAvailable = true;
+  fidelities        = std::move(tables);
+  if (!cacheDirectory.empty()) {
+    storeFidelityTables(cacheDirectory);
+  }
+}
+
+void Architecture::createEdgeFidelityCosts(FidelityTables&     tables,
+                                           const std::uint16_t first,
+                                           const std::uint16_t second) const {
+  auto&       fidelityTable            = tables.fidelityTable;
+  auto&       twoQubitFidelityCosts    = tables.twoQubitFidelityCosts;
+  auto&       swapFidelityCosts        = tables.swapFidelityCosts;
+  const auto& singleQubitFidelityCosts = tables.singleQubitFidelityCosts;
+
+  fidelityTable[first][second] =
+      1.0 - properties.getTwoQubitErrorRate(first, second);
+  twoQubitFidelityCosts[first][second] =
+      -std::log2(fidelityTable[first][second]);
+  if (couplingMap.find({second, first}) == couplingMap.end()) {
+    // CNOT reversal (unidirectional edge q1 -> q2):
+    // CX(q2,q1) = H(q1) H(q2) CX(q1,q2) H(q1) H(q2)
+    twoQubitFidelityCosts[second][first] =
+        twoQubitFidelityCosts[first][second] +
+        2 * singleQubitFidelityCosts[first] +
+        2 * singleQubitFidelityCosts[second];
+    // SWAP decomposition (unidirectional edge q1 -> q2):
+    // SWAP(q1,q2) = CX(q1,q2) H(q1) H(q2) CX(q1,q2) H(q1) H(q2) CX(q1,q2)
+    swapFidelityCosts[first][second] =
+        3 * twoQubitFidelityCosts[first][second] +
+        2 * singleQubitFidelityCosts[first] +
+        2 * singleQubitFidelityCosts[second];
+    swapFidelityCosts[second][first] = swapFidelityCosts[first][second];
+  } else {
+    // SWAP decomposition (bidirectional edge q1 <-> q2):
+    // SWAP(q1,q2) = CX(q1,q2) CX(q2,q1) CX(q1,q2)
+    swapFidelityCosts[first][second] =
+        3 * twoQubitFidelityCosts[first][second];
+  }
+}
+
+void Architecture::updateProperties(const Properties& changes) {
+  std::set<std::uint16_t> changedQubits{};
+  for (const auto& [qubit, operationProps] :
+       changes.singleQubitErrorRate.get()) {
+    for (const auto& [operation, errorRate] : operationProps.get()) {
+      properties.singleQubitErrorRate.get(qubit).set(operation, errorRate);
+    }
+    changedQubits.emplace(qubit);
+  }
+  CouplingMap changedEdges{};
+  for (const auto& [control, targetProps] : changes.twoQubitErrorRate.get()) {
+    for (const auto& [target, operationProps] : targetProps.get()) {
+      for (const auto& [operation, errorRate] : operationProps.get()) {
+        properties.twoQubitErrorRate.get(control).get(target).set(operation,
+                                                                   errorRate);
+      }
+      // error rates of other qubit pairs do not enter the tables
+      if (couplingMap.find({control, target}) != couplingMap.end()) {
+        changedEdges.emplace(control, target);
+      }
+    }
+  }
+  for (const auto& [qubit, errorRate] : changes.readoutErrorRate.get()) {
+    properties.readoutErrorRate.set(qubit, errorRate);
+  }
+  for (const auto& [qubit, time] : changes.t1Time.get()) {
+    properties.t1Time.set(qubit, time);
+  }
+  for (const auto& [qubit, time] : changes.t2Time.get()) {
+    properties.t2Time.set(qubit, time);
+  }
+  for (const auto& [qubit, frequency] : changes.qubitFrequency.get()) {
+    properties.qubitFrequency.set(qubit, frequency);
+  }
+  for (const auto& [qubit, date] : changes.calibrationDate.get()) {
+    properties.calibrationDate.set(qubit, date);
+  }
+
+  const bool inRange =
+      std::all_of(changedQubits.begin(), changedQubits.end(),
+                  [this](const std::uint16_t q) { return q < nqubits; });
+  if (!fidelityAvailable || !inRange) {
+    createFidelityTable();
+    return;
+  }
+
+  // the current tables may be shared with copies of this architecture
+  auto tables = std::make_shared<FidelityTables>(*fidelities);
+  for (const auto qubit : changedQubits) {
+    tables->singleQubitFidelities[qubit] =
+        1.0 - properties.getAverageSingleQubitErrorRate(qubit);
+    tables->singleQubitFidelityCosts[qubit] =
+        -std::log2(tables->singleQubitFidelities[qubit]);
+    // the costs of unidirectional edges include 1Q-gates on their qubits
+    for (const auto& edge : getIncidentEdges(qubit)) {
+      if (couplingMap.find({edge.second, edge.first}) == couplingMap.end()) {
+        changedEdges.emplace(edge);
+      }
+    }
   }
 
-  fidelityDistanceTables.clear();
-  if (fidelityAvailable) {
-    Dijkstra::buildEdgeSkipTable(couplingMap, fidelityDistanceTables,
-                                 swapFidelityCosts);
+  for (const auto& [first, second] : changedEdges) {
+    createEdgeFidelityCosts(*tables, first, second);
   }
+  Dijkstra::updateEdgeSkipTable(couplingMap, tables->fidelityDistanceTables,
+                                fidelities->swapFidelityCosts,
+                                tables->swapFidelityCosts, tableThreads);
+  fidelities = std::move(tables);
+
+  const auto cacheDirectory = getTableCacheDirectory();
+  if (!cacheDirectory.empty()) {
+    storeFidelityTables(cacheDirectory);
+  }
+}
+
+void Architecture::setTableCacheDirectory(const std::string& directory) {
+  const std::lock_guard lock(tableCacheMutex());
+  tableCacheDirectory() = directory;
+}
+
+std::string Architecture::getTableCacheDirectory() {
+  const std::lock_guard lock(tableCacheMutex());
+  return tableCacheDirectory();
+}
+
+std::string Architecture::tableCacheKey(const bool includeProperties) const {
+  std::ostringstream key;
+  key << "qubits " << nqubits << "\ncosts " << COST_UNIDIRECTIONAL_SWAP << ' '
+      << COST_BIDIRECTIONAL_SWAP << ' ' << COST_DIRECTION_REVERSE << '\n';
+  for (const auto& [q1, q2] : couplingMap) {
+    key << q1 << ' ' << q2 << '\n';
+  }
+  if (includeProperties) {
+    // the exact representation of the error rates
+    key << std::hexfloat;
+    for (const auto& [qubit, operationProps] :
+         properties.singleQubitErrorRate.get()) {
+      for (const auto& [operation, errorRate] : operationProps.get()) {
+        key << "1q " << qubit << ' ' << static_cast<int>(operation) << ' '
+            << errorRate << '\n';
+      }
+    }
+    for (const auto& [control, targetProps] :
+         properties.twoQubitErrorRate.get()) {
+      for (const auto& [target, operationProps] : targetProps.get()) {
+        for (const auto& [operation, errorRate] : operationProps.get()) {
+          key << "2q " << control << ' ' << target << ' '
+              << static_cast<int>(operation) << ' ' << errorRate << '\n';
+        }
+      }
+    }
+  }
+  return key.str();
+}
+
+bool Architecture::loadDistanceTables(const std::string& directory) {
+  const auto key = tableCacheKey(false);
+  return readTableCacheEntry(
+      tableCachePath(directory, "distances", key), key,
+      [this](TableCacheReader& reader) {
+        std::uint8_t bidirectionalFlag  = 0;
+        std::uint8_t unidirectionalFlag = 0;
+        auto         tables             = std::make_shared<DistanceTables>();
+        if (!reader.read(bidirectionalFlag) ||
+            !reader.read(unidirectionalFlag) ||
+            !reader.read(tables->distanceTable, nqubits, nqubits)) {
+          return false;
+        }
+        // the tables only differ if there are unidirectional edges
+        if (bidirectionalFlag != 0U) {
+          tables->distanceTableReversals = tables->distanceTable;
+        } else if (!reader.read(tables->distanceTableReversals, nqubits,
+                                nqubits)) {
+          return false;
+        }
+        isBidirectional  = bidirectionalFlag != 0U;
+        isUnidirectional = unidirectionalFlag != 0U;
+        distances        = std::move(tables);
+        return true;
+      });
+}
+
+void Architecture::storeDistanceTables(const std::string& directory) const {
+  const auto key = tableCacheKey(false);
+  writeTableCacheEntry(tableCachePath(directory, "distances", key), key,
+                       [this](TableCacheWriter& writer) {
+                         writer.write(static_cast<std::uint8_t>(
+                             isBidirectional ? 1U : 0U));
+                         writer.write(static_cast<std::uint8_t>(
+                             isUnidirectional ? 1U : 0U));
+                         writer.write(distances->distanceTable);
+                         if (!isBidirectional) {
+                           writer.write(distances->distanceTableReversals);
+                         }
+                       });
+}
+
+bool Architecture::loadFidelityTables(const std::string& directory) {
+  const auto key = tableCacheKey(true);
+  return readTableCacheEntry(
+      tableCachePath(directory, "fidelities", key), key,
+      [this](TableCacheReader& reader) {
+        auto          tables    = std::make_shared<FidelityTables>();
+        std::uint64_t numTables = 0;
+        if (!reader.read(tables->fidelityTable, nqubits, nqubits) ||
+            !reader.read(tables->singleQubitFidelities, nqubits) ||
+            !reader.read(tables->singleQubitFidelityCosts, nqubits) ||
+            !reader.read(tables->twoQubitFidelityCosts, nqubits, nqubits) ||
+            !reader.read(tables->swapFidelityCosts, nqubits, nqubits) ||
+            !reader.read(numTables) || numTables > nqubits + 1U) {
+          return false;
+        }
+        tables->fidelityDistanceTables.resize(numTables);
+        for (auto& table : tables->fidelityDistanceTables) {
+          if (!reader.read(table, nqubits, nqubits)) {
+            return false;
+          }
+        }
+        fidelityAvailable = true;
+        fidelities        = std::move(tables);
+        return true;
+      });
+}
+
+void Architecture::storeFidelityTables(const std::string& directory) const {
+  const auto key = tableCacheKey(true);
+  writeTableCacheEntry(
+      tableCachePath(directory, "fidelities", key), key,
+      [this](TableCacheWriter& writer) {
+        writer.write(fidelities->fidelityTable);
+        writer.write(fidelities->singleQubitFidelities);
+        writer.write(fidelities->singleQubitFidelityCosts);
+        writer.write(fidelities->twoQubitFidelityCosts);
+        writer.write(fidelities->swapFidelityCosts);
+        writer.write(static_cast<std::uint64_t>(
+            fidelities->fidelityDistanceTables.size()));
+        for (const auto& table : fidelities->fidelityDistanceTables) {
+          writer.write(table);
+        }
+      });
 }
 
 std::uint64_t
 Architecture::minimumNumberOfSwaps(std::vector<std::uint16_t>& permutation,
-                                   std::int64_t                limit) {
+                                   std::int64_t                limit) const {
   const bool tryToAbortEarly = (limit != -1);
 
   // consolidate used qubits
@@ -373,7 +817,7 @@ Architecture::minimumNumberOfSwaps(std::vector<std::uint16_t>& permutation,
 }
 
 void Architecture::minimumNumberOfSwaps(std::vector<std::uint16_t>& permutation,
-                                        std::vector<Edge>&          swaps) {
+                                        std::vector<Edge>& swaps) const {
   // consolidate used qubits
   QubitSubset qubits{};
   for (const auto& q : permutation) {
@@ -466,7 +910,24 @@ void Architecture::minimumNumberOfSwaps(std::vector<std::uint16_t>& permutation,
 }
 
 std::size_t Architecture::getCouplingLimit() const {
-  return findCouplingLimit(getCouplingMap(), getNqubits());
+  const auto cacheDirectory = getTableCacheDirectory();
+  if (cacheDirectory.empty()) {
+    return findCouplingLimit(getCouplingMap(), getNqubits());
+  }
+
+  const auto    key  = tableCacheKey(false);
+  const auto    path = tableCachePath(cacheDirectory, "coupling-limit", key);
+  std::uint64_t limit = 0;
+  if (readTableCacheEntry(path, key, [&limit](TableCacheReader& reader) {
+        return reader.read(limit);
+      })) {
+    return limit;
+  }
+  limit = findCouplingLimit(getCouplingMap(), getNqubits());
+  writeTableCacheEntry(path, key, [limit](TableCacheWriter& writer) {
+    writer.write(limit);
+  });
+  return limit;
 }
 
 std::size_t
@@ -474,74 +935,90 @@ Architecture::getCouplingLimit(const QubitSubset& qubitChoice) const {
   return findCouplingLimit(getCouplingMap(), getNqubits(), qubitChoice);
 }
 
-std::uint64_t Architecture::bfs(const std::uint16_t   start,
-                                const std::uint16_t   goal,
-                                const std::set<Edge>& teleportations) const {
-  std::queue<std::vector<int>> queue;
-  std::vector<int>             v;
-  v.push_back(start);
-  queue.push(v);
-  std::vector<std::vector<int>> solutions;
-
-  std::uint64_t length = 0U;
-  std::set<int> successors;
-  while (!queue.empty()) {
-    v = queue.front();
-    queue.pop();
-    const int current = v[v.size() - 1];
-    if (current == goal) {
-      length = v.size();
-      solutions.push_back(v);
-      break;
-    }
-    successors.clear();
-    for (const auto& edge : getCouplingMap()) {
-      if (edge.first == current && !contains(v, edge.second)) {
-        successors.insert(edge.second);
-      }
-      if (edge.second == current && !contains(v, edge.first)) {
-        successors.insert(edge.first);
-      }
-    }
-    for (const auto& edge : teleportations) {
-      if (edge.first == current && !contains(v, edge.second)) {
-        successors.insert(edge.second);
-      }
-      if (edge.second == current && !contains(v, edge.first)) {
-        successors.insert(edge.first); // was v2 but this is probably wrong
-      }
-    }
+Matrix Architecture::createTeleportationDistanceTable(
+    const CouplingMap& teleportations) const {
+  std::uint16_t n = nqubits;
+  for (const auto& [q1, q2] : teleportations) {
+    n = std::max({n, static_cast<std::uint16_t>(q1 + 1U),
+                  static_cast<std::uint16_t>(q2 + 1U)});
+  }
 
-    for (const auto successor : successors) {
-      auto v2 = v;
-      v2.push_back(successor);
-      queue.push(v2);
+  // undirected adjacency lists of coupled and teleportation edges (in CSR
+  // format), marking whether an edge is traversed in the direction of the
+  // coupling map
+  std::vector<std::vector<std::pair<std::uint16_t, bool>>> neighbors(n);
+  auto addEdge = [&neighbors](const std::uint16_t from, const std::uint16_t to,
+                              const bool forward) {
+    auto& list = neighbors[from];
+    auto  it   = std::find_if(list.begin(), list.end(),
+                              [to](const auto& e) { return e.first == to; });
+    if (it == list.end()) {
+      list.emplace_back(to, forward);
+    } else {
+      it->second = it->second || forward;
     }
+  };
+  for (const auto& [q1, q2] : couplingMap) {
+    addEdge(q1, q2, true);
+    addEdge(q2, q1, false);
   }
-  while (!queue.empty() && queue.front().size() == length) {
-    if (queue.front()[queue.front().size() - 1] == goal) {
-      solutions.push_back(queue.front());
-    }
-    queue.pop();
+  for (const auto& [q1, q2] : teleportations) {
+    addEdge(q1, q2, false);
+    addEdge(q2, q1, false);
+  }
+  std::vector<std::size_t>                    offsets(n + 1U, 0);
+  std::vector<std::pair<std::uint16_t, bool>> adjacency{};
+  for (std::uint16_t q = 0; q < n; ++q) {
+    adjacency.insert(adjacency.end(), neighbors[q].begin(), neighbors[q].end());
+    offsets[q + 1U] = adjacency.size();
   }
 
-  // TODO: different weight if this contains a teleportation
-  for (const auto& s : solutions) {
-    for (std::size_t j = 0; j < s.size() - 1; j++) {
-      const Edge e{s[j], s[j + 1]};
-      if (getCouplingMap().find(e) != getCouplingMap().end()) {
-        return (length - 2) * 7;
+  Matrix table(n, n, std::numeric_limits<double>::max());
+  std::vector<std::size_t>   hops(n);
+  std::vector<bool>          forwardPath(n);
+  std::vector<std::uint16_t> queue(n);
+  constexpr auto UNVISITED = std::numeric_limits<std::size_t>::max();
+  for (std::uint16_t start = 0; start < n; ++start) {
+    // BFS from `start`, where `forwardPath[q]` is true if any shortest path to
+    // `q` traverses an edge of the coupling map in its direction
+    std::fill(hops.begin(), hops.end(), UNVISITED);
+    std::fill(forwardPath.begin(), forwardPath.end(), false);
+    hops[start]       = 0;
+    std::size_t front = 0;
+    std::size_t back  = 0;
+    queue[back++]     = start;
+    while (front < back) {
+      const auto current = queue[front++];
+      for (std::size_t i = offsets[current]; i < offsets[current + 1U]; ++i) {
+        const auto [next, forward] = adjacency[i];
+        if (hops[next] == UNVISITED) {
+          hops[next]    = hops[current] + 1;
+          queue[back++] = next;
+        }
+        if (hops[next] == hops[current] + 1) {
+          forwardPath[next] =
+              forwardPath[next] || forwardPath[current] || forward;
+        }
       }
     }
-  }
 
-  if (length == 2 &&
-      getCouplingMap().find(Edge{start, goal}) == getCouplingMap().end() &&
-      getCouplingMap().find(Edge{goal, start}) == getCouplingMap().end()) {
-    return 7;
+    auto  row  = table[start];
+    row[start] = 0.;
+    for (std::uint16_t goal = 0; goal < n; ++goal) {
+      if (goal == start || hops[goal] == UNVISITED) {
+        continue;
+      }
+      const auto swaps = static_cast<double>(hops[goal] - 1);
+      if (forwardPath[goal]) {
+        row[goal] = swaps * 7;
+      } else if (hops[goal] == 1 && !isEdgeConnected({start, goal}, false)) {
+        row[goal] = 7;
+      } else {
+        row[goal] = swaps * 7 + 4;
+      }
+    }
   }
-
-  return (length - 2) * 7 + 4;
+  return table;
 }
 
 std::size_t Architecture::findCouplingLimit(const CouplingMap&  cm,
@@ -9,6 +9,18 @@
 
 #include <filesystem>
 
+namespace {
+/// tables are logged as arrays of their rows
+nlohmann::json matrixJson(const Matrix& matrix) {
+  auto json = nlohmann::json::array();
+  for (std::size_t i = 0; i < matrix.rows(); ++i) {
+    const auto row = matrix[i];
+    json.emplace_back(std::vector<double>(row.begin(), row.end()));
+  }
+  return json;
+}
+} // namespace
+
 void DataLogger::initLog() {
   if (dataLoggingPath.back() != '/') {
     dataLoggingPath += '/';
@@ -43,18 +55,24 @@ void DataLogger::logArchitecture() {
   json["name"]         = architecture->getName();
   json["nqubits"]      = architecture->getNqubits();
   json["coupling_map"] = architecture->getCouplingMap();
-  json["distances"]    = architecture->getDistanceTable();
+  json["distances"]    = matrixJson(architecture->getDistanceTable());
   if (architecture->isFidelityAvailable()) {
     auto& fidelity = json["fidelity"];
     fidelity["single_qubit_fidelities"] =
         architecture->getSingleQubitFidelities();
-    fidelity["two_qubit_fidelities"] = architecture->getFidelityTable();
+    fidelity["two_qubit_fidelities"] =
+        matrixJson(architecture->getFidelityTable());
     fidelity["single_qubit_fidelity_costs"] =
         architecture->getSingleQubitFidelityCosts();
     fidelity["two_qubit_fidelity_costs"] =
-        architecture->getTwoQubitFidelityCosts();
-    fidelity["swap_fidelity_costs"] = architecture->getSwapFidelityCosts();
-    fidelity["fidelity_distances"]  = architecture->getFidelityDistanceTables();
+        matrixJson(architecture->getTwoQubitFidelityCosts());
+    fidelity["swap_fidelity_costs"] =
+        matrixJson(architecture->getSwapFidelityCosts());
+    auto& fidelityDistances = fidelity["fidelity_distances"];
+    fidelityDistances       = nlohmann::json::array();
+    for (const auto& table : architecture->getFidelityDistanceTables()) {
+      fidelityDistances.emplace_back(matrixJson(table));
+    }
   }
   of << json.dump(2);
   of.close();
@@ -82,11 +100,10 @@ void DataLogger::logFinalizeLayer(
     const std::vector<std::uint16_t>& singleQubitMultiplicity,
     const std::map<std::pair<std::uint16_t, std::uint16_t>,
                    std::pair<std::uint16_t, std::uint16_t>>&
-                                                       twoQubitMultiplicity,
-    const std::array<std::int16_t, MAX_DEVICE_QUBITS>& initialLayout,
-    std::size_t finalNodeId, double finalCostFixed, double finalCostHeur,
-    double                                             finalLookaheadPenalty,
-    const std::array<std::int16_t, MAX_DEVICE_QUBITS>& finalLayout,
+                                     twoQubitMultiplicity,
+    const std::vector<std::int16_t>& initialLayout, std::size_t finalNodeId,
+    double finalCostFixed, double finalCostHeur, double finalLookaheadPenalty,
+    const std::vector<std::int16_t>& finalLayout,
     const std::vector<Exchange>& finalSwaps, std::size_t finalSearchDepth) {
   if (deactivated) {
     return;
@@ -127,15 +144,17 @@ void DataLogger::logFinalizeLayer(
   json["single_qubit_multiplicity"] = singleQubitMultiplicity;
   auto& initialLayoutJSON           = json["initial_layout"];
   for (std::size_t i = 0; i < nqubits; ++i) {
-    initialLayoutJSON[i] = initialLayout.at(i);
+    initialLayoutJSON[i] = i < initialLayout.size() ? initialLayout[i] : -1;
   }
   json["final_node_id"]           = finalNodeId;
   json["final_cost_fixed"]        = finalCostFixed;
   json["final_cost_heur"]         = finalCostHeur;
   json["final_lookahead_penalty"] = finalLookaheadPenalty;
   auto& finalLayoutJSON           = json["final_layout"];
+  // layouts shorter than the architecture (e.g., the empty final layout of a
+  // split layer) are padded with unmapped entries
   for (std::size_t i = 0; i < nqubits; ++i) {
-    finalLayoutJSON[i] = finalLayout.at(i);
+    finalLayoutJSON[i] = i < finalLayout.size() ? finalLayout[i] : -1;
   }
   if (finalSwaps.empty()) {
     json["final_swaps"] = nlohmann::json::array();
@@ -184,8 +203,7 @@ void DataLogger::splitLayer() {
 void DataLogger::logSearchNode(
     std::size_t layerIndex, std::size_t nodeId, std::size_t parentId,
     double costFixed, double costHeur, double lookaheadPenalty,
-    const std::array<std::int16_t, MAX_DEVICE_QUBITS>& qubits,
-    bool validMapping, const std::vector<Exchange>& swaps, std::size_t depth) {
+    const std::vector<std::int16_t>& qubits, bool validMapping, const std::vector<Exchange>& swaps, std::size_t depth) {
   if (deactivated) {
     return;
   }
@@ -204,7 +222,7 @@ void DataLogger::logSearchNode(
   of << nodeId << ";" << parentId << ";" << costFixed << ";" << costHeur << ";"
      << lookaheadPenalty << ";" << validMapping << ";" << depth << ";";
   for (std::size_t i = 0; i < nqubits; ++i) {
-    of << qubits.at(i) << ",";
+    of << (i < qubits.size() ? qubits[i] : -1) << ",";
   }
   if (nqubits > 0) {
     of.seekp(-1, std::ios_base::cur); // remove last comma
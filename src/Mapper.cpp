@@ -9,6 +9,7 @@
 #include "Definitions.hpp"
 #include "operations/CompoundOperation.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <utility>
@@ -22,12 +23,18 @@ void Mapper::initResults() {
   results.output.qubits = architecture->getNqubits();
   results.output.gates  = std::numeric_limits<std::size_t>::max();
   qcMapped.addQubitRegister(architecture->getNqubits());
+
+  // the mapping is sized to the architecture, which may have been changed
+  // since the construction of the mapper
+  qubits.assign(architecture->getNqubits(), DEFAULT_POSITION);
+  locations.assign(architecture->getNqubits(), DEFAULT_POSITION);
 }
 
-Mapper::Mapper(qc::QuantumComputation quantumComputation, Architecture& arch)
-    : qc(std::move(quantumComputation)), architecture(&arch) {
-  qubits.fill(DEFAULT_POSITION);
-  locations.fill(DEFAULT_POSITION);
+Mapper::Mapper(qc::QuantumComputation quantumComputation,
+               const Architecture&    arch)
+    : qc(std::move(quantumComputation)), architecture(&arch),
+      qubits(arch.getNqubits(), DEFAULT_POSITION),
+      locations(arch.getNqubits(), DEFAULT_POSITION) {
 
   // strip away qubits that are not used in the circuit
   qc.stripIdleQubits(true, true);
@@ -36,7 +43,7 @@ Mapper::Mapper(qc::QuantumComputation quantumComputation, Architecture& arch)
 }
 
 void Mapper::processDisjointQubitLayer(
-    std::array<std::optional<std::size_t>, MAX_DEVICE_QUBITS>& lastLayer,
+    std::vector<std::optional<std::size_t>>& lastLayer,
     const std::optional<std::uint16_t>& control, const std::uint16_t target,
     qc::Operation* gate) {
   std::size_t layer = 0;
@@ -71,7 +78,7 @@ void Mapper::processDisjointQubitLayer(
 }
 
 void Mapper::processDisjoint2qBlockLayer(
-    std::array<std::optional<std::size_t>, MAX_DEVICE_QUBITS>& lastLayer,
+    std::vector<std::optional<std::size_t>>& lastLayer,
     const std::optional<std::uint16_t>& control, const std::uint16_t target,
     qc::Operation* gate) {
   std::size_t layer = 0;
@@ -120,7 +127,8 @@ void Mapper::processDisjoint2qBlockLayer(
 
 void Mapper::createLayers() {
   const auto& config = results.config;
-  std::array<std::optional<std::size_t>, MAX_DEVICE_QUBITS> lastLayer{};
+  std::vector<std::optional<std::size_t>> lastLayer(
+      std::max<std::size_t>(architecture->getNqubits(), qc.getNqubits()));
 
   auto qubitsInLayer = std::set<std::uint16_t>{};
 
@@ -215,54 +223,174 @@ void Mapper::createLayers() {
   }
   results.input.layers = layers.size();
 
-  // compute qubit gate multiplicities
-  singleQubitMultiplicities = std::vector<SingleQubitMultiplicity>(
-      layers.size(), SingleQubitMultiplicity(architecture->getNqubits(), 0));
-  twoQubitMultiplicities =
-      std::vector<TwoQubitMultiplicity>(layers.size(), TwoQubitMultiplicity{});
-  activeQubits = std::vector<std::set<std::uint16_t>>(
-      layers.size(), std::set<std::uint16_t>{});
-  activeQubits1QGates = std::vector<std::set<std::uint16_t>>(
-      layers.size(), std::set<std::uint16_t>{});
-  activeQubits2QGates = std::vector<std::set<std::uint16_t>>(
-      layers.size(), std::set<std::uint16_t>{});
+  singleQubitMultiplicities.clear();
+  twoQubitMultiplicities.clear();
+  activeQubits.clear();
+  activeQubits1QGates.clear();
+  activeQubits2QGates.clear();
+  layerViews.clear();
+  layerWindowBegin = 0;
+  if (config.layerWindow > 0) {
+    // the data of the layers is created on demand (see `loadLayers`)
+    return;
+  }
 
+  singleQubitMultiplicities.reserve(layers.size());
+  twoQubitMultiplicities.reserve(layers.size());
+  activeQubits.reserve(layers.size());
+  activeQubits1QGates.reserve(layers.size());
+  activeQubits2QGates.reserve(layers.size());
+  layerViews.reserve(layers.size());
   for (std::size_t i = 0; i < layers.size(); ++i) {
-    for (const auto& gate : layers[i]) {
-      if (gate.singleQubit()) {
-        activeQubits[i].emplace(gate.target);
-        activeQubits1QGates[i].emplace(gate.target);
-        ++singleQubitMultiplicities[i][gate.target];
+    appendLayerData(i);
+  }
+}
+
+void Mapper::appendLayerData(const std::size_t index) {
+  assert(index == layerWindowBegin + layerViews.size());
+
+  // compute qubit gate multiplicities
+  auto& singleQubitMultiplicity = singleQubitMultiplicities.emplace_back(
+      architecture->getNqubits(), 0);
+  auto& twoQubitMultiplicity = twoQubitMultiplicities.emplace_back();
+  auto& active               = activeQubits.emplace_back();
+  auto& active1QGates        = activeQubits1QGates.emplace_back();
+  auto& active2QGates        = activeQubits2QGates.emplace_back();
+
+  for (const auto& gate : layers.at(index)) {
+    if (gate.singleQubit()) {
+      active.emplace(gate.target);
+      active1QGates.emplace(gate.target);
+      ++singleQubitMultiplicity[gate.target];
+    } else {
+      active.emplace(gate.control);
+      active.emplace(gate.target);
+      active2QGates.emplace(gate.control);
+      active2QGates.emplace(gate.target);
+      if (gate.control >= gate.target) {
+        const auto edge =
+            std::pair(gate.target, static_cast<std::uint16_t>(gate.control));
+        if (twoQubitMultiplicity.find(edge) == twoQubitMultiplicity.end()) {
+          twoQubitMultiplicity[edge] = {0, 1};
+        } else {
+          twoQubitMultiplicity[edge].second++;
+        }
       } else {
-        activeQubits[i].emplace(gate.control);
-        activeQubits[i].emplace(gate.target);
-        activeQubits2QGates[i].emplace(gate.control);
-        activeQubits2QGates[i].emplace(gate.target);
-        if (gate.control >= gate.target) {
-          const auto edge =
-              std::pair(gate.target, static_cast<std::uint16_t>(gate.control));
-          if (twoQubitMultiplicities[i].find(edge) ==
-              twoQubitMultiplicities[i].end()) {
-            twoQubitMultiplicities[i][edge] = {0, 1};
-          } else {
-            twoQubitMultiplicities[i][edge].second++;
-          }
+        const auto edge =
+            std::pair(static_cast<std::uint16_t>(gate.control), gate.target);
+        if (twoQubitMultiplicity.find(edge) == twoQubitMultiplicity.end()) {
+          twoQubitMultiplicity[edge] = {1, 0};
         } else {
-          const auto edge =
-              std::pair(static_cast<std::uint16_t>(gate.control), gate.target);
-          if (twoQubitMultiplicities[i].find(edge) ==
-              twoQubitMultiplicities[i].end()) {
-            twoQubitMultiplicities[i][edge] = {1, 0};
-          } else {
-            twoQubitMultiplicities[i][edge].first++;
-          }
+          twoQubitMultiplicity[edge].first++;
         }
       }
     }
   }
+
+  layerViews.emplace_back();
+  updateLayerView(index);
+}
+
+void Mapper::loadLayers(const std::size_t first, std::size_t last) {
+  const auto window = results.config.layerWindow;
+  last              = std::min(last, layers.size());
+  const auto begin  = layerWindowBegin;
+  const auto end    = layerWindowBegin + layerViews.size();
+  if (window == 0 || (first >= begin && last <= end) || first >= last) {
+    return;
+  }
+
+  // move the window into the direction of the requested layers
+  const auto size     = std::min(std::max(last - first, window), layers.size());
+  auto       newBegin = first;
+  if (first < begin) {
+    newBegin = last > size ? last - size : 0;
+  } else if (newBegin + size > layers.size()) {
+    newBegin = layers.size() - size;
+  }
+  const auto newEnd = newBegin + size;
+
+  // the data of layers in both windows is kept
+  auto oldSingleQubitMultiplicities = std::move(singleQubitMultiplicities);
+  auto oldTwoQubitMultiplicities    = std::move(twoQubitMultiplicities);
+  auto oldActiveQubits              = std::move(activeQubits);
+  auto oldActiveQubits1QGates       = std::move(activeQubits1QGates);
+  auto oldActiveQubits2QGates       = std::move(activeQubits2QGates);
+  auto oldLayerViews                = std::move(layerViews);
+  singleQubitMultiplicities.clear();
+  twoQubitMultiplicities.clear();
+  activeQubits.clear();
+  activeQubits1QGates.clear();
+  activeQubits2QGates.clear();
+  layerViews.clear();
+  singleQubitMultiplicities.reserve(size);
+  twoQubitMultiplicities.reserve(size);
+  activeQubits.reserve(size);
+  activeQubits1QGates.reserve(size);
+  activeQubits2QGates.reserve(size);
+  layerViews.reserve(size);
+
+  layerWindowBegin = newBegin;
+  for (std::size_t i = newBegin; i < newEnd; ++i) {
+    if (i < begin || i >= end) {
+      appendLayerData(i);
+      continue;
+    }
+    const auto old = i - begin;
+    singleQubitMultiplicities.emplace_back(
+        std::move(oldSingleQubitMultiplicities[old]));
+    twoQubitMultiplicities.emplace_back(
+        std::move(oldTwoQubitMultiplicities[old]));
+    activeQubits.emplace_back(std::move(oldActiveQubits[old]));
+    activeQubits1QGates.emplace_back(std::move(oldActiveQubits1QGates[old]));
+    activeQubits2QGates.emplace_back(std::move(oldActiveQubits2QGates[old]));
+    layerViews.emplace_back(std::move(oldLayerViews[old]));
+  }
+}
+
+void Mapper::updateLayerView(std::size_t index) {
+  index -= layerWindowBegin;
+  auto& view = layerViews.at(index);
+  view.edges.clear();
+  view.multiplicities.clear();
+  view.edges.reserve(twoQubitMultiplicities.at(index).size());
+  view.multiplicities.reserve(twoQubitMultiplicities.at(index).size());
+  for (const auto& [edge, multiplicity] : twoQubitMultiplicities.at(index)) {
+    view.edges.emplace_back(edge);
+    view.multiplicities.emplace_back(multiplicity);
+  }
+
+  view.bestEdgeCosts.clear();
+  if (architecture->isFidelityAvailable()) {
+    view.bestEdgeCosts.reserve(view.edges.size());
+    for (const auto& [forwardMult, reverseMult] : view.multiplicities) {
+      double cost = std::numeric_limits<double>::max();
+      for (const auto& [q1, q2] : architecture->getCouplingMap()) {
+        const auto edgeCost =
+            forwardMult * architecture->getTwoQubitFidelityCost(q1, q2) +
+            reverseMult * architecture->getTwoQubitFidelityCost(q2, q1);
+        cost = std::min(cost, edgeCost);
+      }
+      view.bestEdgeCosts.emplace_back(cost);
+    }
+  }
+
+  view.activeQubits.reset();
+  view.activeQubits1QGates.reset();
+  view.activeQubits2QGates.reset();
+  for (const auto q : activeQubits.at(index)) {
+    view.activeQubits.set(q);
+  }
+  for (const auto q : activeQubits1QGates.at(index)) {
+    view.activeQubits1QGates.set(q);
+  }
+  for (const auto q : activeQubits2QGates.at(index)) {
+    view.activeQubits2QGates.set(q);
+  }
 }
 
 bool Mapper::isLayerSplittable(std::size_t index) {
+  index -= layerWindowBegin;
   if (twoQubitMultiplicities.at(index).size() > 1) {
     return true;
   }
@@ -281,11 +409,11 @@ bool Mapper::isLayerSplittable(std::size_t index) {
                      });
 }
 
-void Mapper::splitLayer(std::size_t index, Architecture& arch) {
+void Mapper::splitLayer(std::size_t index, const Architecture& arch) {
   const SingleQubitMultiplicity& singleQubitMultiplicity =
-      singleQubitMultiplicities.at(index);
+      getSingleQubitMultiplicity(index);
   const TwoQubitMultiplicity& twoQubitMultiplicity =
-      twoQubitMultiplicities.at(index);
+      getTwoQubitMultiplicity(index);
   std::vector<Gate>       layer0{};
   std::vector<Gate>       layer1{};
   SingleQubitMultiplicity singleQubitMultiplicity0(arch.getNqubits(), 0);
@@ -378,6 +506,8 @@ void Mapper::splitLayer(std::size_t index, Architecture& arch) {
               index) +
           1,
       layer1);
+  // position of the layer in the data of the loaded layers
+  index -= layerWindowBegin;
   singleQubitMultiplicities[index] = singleQubitMultiplicity0;
   singleQubitMultiplicities.insert(
       singleQubitMultiplicities.begin() +
@@ -413,6 +543,12 @@ void Mapper::splitLayer(std::size_t index, Architecture& arch) {
               index) +
           1,
       activeQubits2QGates1);
+  layerViews.insert(
+      layerViews.begin() +
+          static_cast<std::vector<LayerView>::difference_type>(index) + 1,
+      LayerView{});
+  updateLayerView(layerWindowBegin + index);
+  updateLayerView(layerWindowBegin + index + 1);
   results.input.layers = layers.size();
 }
 
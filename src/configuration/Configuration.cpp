@@ -28,6 +28,9 @@ nlohmann::json Configuration::json() const {
     heuristicPropertiesJson["tight"]          = isTight(heuristic);
     heuristicPropertiesJson["fidelity_aware"] = isFidelityAware(heuristic);
     heuristicJson["initial_layout"]           = ::toString(initialLayout);
+    if (initialLayout == InitialLayout::GraphIsomorphism) {
+      heuristicJson["initial_layout_timeout"] = initialLayoutTimeout;
+    }
     if (lookaheadHeuristic != LookaheadHeuristic::None) {
       auto& lookaheadSettings        = heuristicJson["lookahead"];
       lookaheadSettings["heuristic"] = ::toString(lookaheadHeuristic);
@@ -39,6 +42,25 @@ nlohmann::json Configuration::json() const {
       lookaheadSettings["first_factor"] = firstLookaheadFactor;
       lookaheadSettings["factor"]       = lookaheadFactor;
     }
+    if (iterativeBidirectionalRouting) {
+      auto& bidirectional     = heuristicJson["iterative_bidirectional_routing"];
+      bidirectional["passes"] = iterativeBidirectionalRoutingPasses;
+      bidirectional["chains"] = iterativeBidirectionalRoutingChains;
+    }
+    if (searchEngine != SearchEngine::AStar) {
+      heuristicJson["search_engine"] = ::toString(searchEngine);
+    }
+    if (memoryBoundedSearch) {
+      auto& memoryBounded         = heuristicJson["memory_bounded_search"];
+      memoryBounded["budget"]     = memoryBoundedSearchBudget;
+      memoryBounded["beam_width"] = memoryBoundedSearchBeamWidth;
+    }
+    if (warmStartSearch) {
+      heuristicJson["warm_start_search"] = true;
+    }
+    if (layerWindow > 0) {
+      heuristicJson["layer_window"] = layerWindow;
+    }
     if (useTeleportation) {
       auto& teleportation     = heuristicJson["teleportation"];
       teleportation["qubits"] = teleportationQubits;
@@ -47,6 +69,37 @@ nlohmann::json Configuration::json() const {
     }
   }
 
+  if (method == Method::Sabre) {
+    auto& sabre             = config["settings"];
+    sabre["initial_layout"] = ::toString(initialLayout);
+    if (initialLayout == InitialLayout::GraphIsomorphism) {
+      sabre["initial_layout_timeout"] = initialLayoutTimeout;
+    }
+    if (lookaheadHeuristic != LookaheadHeuristic::None) {
+      auto& extendedSet           = sabre["extended_set"];
+      extendedSet["layers"]       = nrLookaheads;
+      extendedSet["first_factor"] = firstLookaheadFactor;
+      extendedSet["factor"]       = lookaheadFactor;
+    }
+    if (iterativeBidirectionalRouting) {
+      sabre["iterative_bidirectional_routing"]["passes"] =
+          iterativeBidirectionalRoutingPasses;
+    }
+    if (layerWindow > 0) {
+      sabre["layer_window"] = layerWindow;
+    }
+  }
+
+  if (method == Method::Portfolio) {
+    auto& portfolioJson      = config["settings"];
+    portfolioJson["timeout"] = timeout;
+    auto& members            = portfolioJson["portfolio"];
+    members                  = nlohmann::json::array();
+    for (const auto& member : portfolio) {
+      members.push_back(member.json());
+    }
+  }
+
   if (method == Method::Exact) {
     auto& exact       = config["settings"];
     exact["timeout"]  = timeout;
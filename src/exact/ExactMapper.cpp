@@ -15,6 +15,8 @@
 void ExactMapper::map(const Configuration& settings) {
   results.config     = settings;
   const auto& config = results.config;
+  // a previous run may have mapped to a subgraph
+  architecture = fullArchitecture;
 
   const std::chrono::high_resolution_clock::time_point start =
       std::chrono::high_resolution_clock::now();
@@ -78,7 +80,9 @@ void ExactMapper::map(const Configuration& settings) {
       return;
     }
 
-    architecture->setCouplingMap(reducedCouplingMap);
+    subgraphArchitecture = *fullArchitecture;
+    subgraphArchitecture.setCouplingMap(reducedCouplingMap);
+    architecture = &subgraphArchitecture;
   }
 
   // 2b) If configured to use subsets, collect all k (=m over n) possibilities
@@ -5,12 +5,151 @@
 
 #include "heuristic/HeuristicMapper.hpp"
 
+#include "heuristic/MPSCQueue.hpp"
 #include "operations/StandardOperation.hpp"
 #include "utils.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+/**
+ * search nodes sent from one worker of the hash-distributed A*-search to
+ * another (see `HeuristicMapper::hashDistributedAStarMap`)
+ */
+struct NodeBatch {
+  /** worker which generated the nodes, i.e. which owns their parents */
+  std::size_t                   sender = 0;
+  std::vector<NodeArena::Entry> entries{};
+  /** mappings of all nodes, one row of the arena width per node */
+  std::vector<std::int16_t> mappings{};
+};
+
+std::size_t ownerOf(const std::uint64_t hash, const std::size_t nWorkers) {
+  // use the upper bits, the lower ones already determine the bucket in the
+  // hash tables of the worker
+  return static_cast<std::size_t>((hash >> 32U) % nWorkers);
+}
+} // namespace
+
+/**
+ * state owned by one worker of the hash-distributed A*-search, i.e. all search
+ * nodes whose mapping hashes to this worker (or by one chain of iterative
+ * bidirectional routing, i.e. the single worker of a sequential search)
+ */
+struct HeuristicMapper::SearchWorker {
+  SearchWorker(const std::size_t width, const std::size_t nWorkers)
+      : outboxes(nWorkers) {
+    arena.reset(width);
+  }
+
+  NodeArena arena{};
+  /** worker owning the parent of each node in `arena` */
+  std::vector<std::size_t> parentWorkers{};
+  /** open list */
+  UniquePriorityQueue<NodeArena::Index, HeuristicMapper::NodeCostCompare,
+                      HeuristicMapper::NodeMappingHash,
+                      HeuristicMapper::NodeMappingEqual>
+      open{HeuristicMapper::NodeCostCompare{&arena},
+           HeuristicMapper::NodeMappingHash{&arena},
+           HeuristicMapper::NodeMappingEqual{&arena}};
+  /** cheapest node reached so far for each mapping (open or closed) */
+  std::unordered_set<NodeArena::Index, HeuristicMapper::NodeMappingHash,
+                     HeuristicMapper::NodeMappingEqual>
+      best{0, HeuristicMapper::NodeMappingHash{&arena},
+           HeuristicMapper::NodeMappingEqual{&arena}};
+  MPSCQueue<NodeBatch> inbox{};
+  /** nodes to be sent to each other worker after the current expansion */
+  std::vector<NodeBatch> outboxes;
+  /** batches sent by this worker, which have been consumed by their receiver
+   * and are handed back to reuse their allocated memory */
+  MPSCQueue<NodeBatch> returnedBatches{};
+  /** empty batches to replace sent outboxes with (see `takeSpareBatch`) */
+  std::vector<NodeBatch> spareBatches{};
+  std::vector<Edge>      candidates{};
+  std::vector<QubitSet>  usedSwaps{};
+  HeuristicMapper::Node  node{};
+
+  bool             foundGoal      = false;
+  NodeArena::Index bestGoal       = 0;
+  std::size_t      expandedNodes  = 0;
+  std::size_t      generatedNodes = 0;
+
+  /**
+   * discards all nodes (keeping the allocated memory) to start a new search
+   */
+  void reset() {
+    arena.reset(arena.getWidth());
+    parentWorkers.clear();
+    open.deleteQueue();
+    best.clear();
+    // nodes left over from a search that has been stopped
+    const auto keepSpare = [this](NodeBatch&& batch) {
+      batch.entries.clear();
+      batch.mappings.clear();
+      spareBatches.emplace_back(std::move(batch));
+    };
+    inbox.consumeAll(keepSpare);
+    returnedBatches.consumeAll(keepSpare);
+    for (auto& batch : outboxes) {
+      batch.entries.clear();
+      batch.mappings.clear();
+    }
+    foundGoal      = false;
+    bestGoal       = 0;
+    expandedNodes  = 0;
+    generatedNodes = 0;
+  }
+
+  /**
+   * returns an empty batch, preferably one that has been sent before and still
+   * holds its allocated memory
+   */
+  NodeBatch takeSpareBatch() {
+    if (spareBatches.empty()) {
+      returnedBatches.consumeAll([this](NodeBatch&& batch) {
+        spareBatches.emplace_back(std::move(batch));
+      });
+      if (spareBatches.empty()) {
+        return NodeBatch{};
+      }
+    }
+    auto batch = std::move(spareBatches.back());
+    spareBatches.pop_back();
+    return batch;
+  }
+
+  /**
+   * stores the given node and adds it to the open list, unless its mapping has
+   * already been reached with lower or equal cost
+   *
+   * @return the change in the number of nodes in the open list (-1 if the node
+   * was dropped, 0 if it replaced a more expensive node, 1 otherwise)
+   */
+  int receive(const NodeArena::Entry& entry, const std::int16_t* mapping,
+              const std::size_t parentWorker) {
+    const auto index = arena.add(entry, mapping);
+    if (const auto it = best.find(index); it != best.end()) {
+      if (!HeuristicMapper::NodeCostCompare{&arena}(*it, index)) {
+        arena.discardLast();
+        return -1;
+      }
+      best.erase(it);
+    }
+    best.emplace(index);
+    parentWorkers.emplace_back(parentWorker);
+
+    const auto queued = open.size();
+    open.push(index);
+    return open.size() > queued ? 1 : 0;
+  }
+};
 
 void HeuristicMapper::map(const Configuration& configuration) {
   if (configuration.dataLoggingEnabled()) {
@@ -21,12 +160,34 @@ void HeuristicMapper::map(const Configuration& configuration) {
   tightHeur         = isTight(configuration.heuristic);
   fidelityAwareHeur = isFidelityAware(configuration.heuristic);
 
+  const auto nThreads = configuration.nThreads == 0
+                            ? std::thread::hardware_concurrency()
+                            : configuration.nThreads;
+  if (nThreads > 1) {
+    if (!threadPool || threadPool->size() != nThreads) {
+      threadPool = std::make_unique<ThreadPool>(nThreads);
+    }
+  } else {
+    threadPool.reset();
+  }
+
   results            = MappingResults{};
   results.config     = configuration;
+  committedExchanges.store(0, std::memory_order_relaxed);
   const auto& config = results.config;
   checkParameters();
   const auto start = std::chrono::steady_clock::now();
+  // the deadline saturates for timeouts beyond the range of the clock
+  const auto maxTimeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::time_point::max() - start);
+  deadline = config.timeout < static_cast<std::size_t>(maxTimeout.count())
+                 ? start + std::chrono::milliseconds(config.timeout)
+                 : std::chrono::steady_clock::time_point::max();
   initResults();
+  // the architecture may have changed since the last run
+  teleportationQubits.clear();
+  teleportationDistanceTables.clear();
+  setCurrentTeleportations({});
 
   // perform pre-mapping optimizations
   preMappingOptimizations(config);
@@ -36,6 +197,9 @@ void HeuristicMapper::map(const Configuration& configuration) {
     std::clog << "Teleportation qubits: " << config.teleportationQubits << "\n";
     printLayering(std::clog);
   }
+  if (config.heuristic == Heuristic::FidelityBestLocation) {
+    resetFidelityCostMemo();
+  }
 
   createInitialMapping();
   if (config.verbose) {
@@ -43,22 +207,33 @@ void HeuristicMapper::map(const Configuration& configuration) {
     printQubits(std::clog);
   }
 
-  for (std::size_t i = 0; i < config.iterativeBidirectionalRoutingPasses; ++i) {
-    if (config.verbose) {
-      std::clog << "\nIterative bidirectional routing (forward pass " << i
-                << "):\n";
-    }
-    pseudoRouteCircuit(false);
-    if (config.verbose) {
-      std::clog << "\nIterative bidirectional routing (backward pass " << i
-                << "):\n";
-    }
-    pseudoRouteCircuit(true);
+  if (config.iterativeBidirectionalRoutingPasses > 0 &&
+      config.iterativeBidirectionalRoutingChains > 1) {
+    routeBidirectionalChains();
+  } else {
+    for (std::size_t i = 0; i < config.iterativeBidirectionalRoutingPasses &&
+                            !deadlineExpired();
+         ++i) {
+      if (config.verbose) {
+        std::clog << "\nIterative bidirectional routing (forward pass " << i
+                  << "):\n";
+      }
+      pseudoRouteCircuit(false);
+      if (config.verbose) {
+        std::clog << "\nIterative bidirectional routing (backward pass " << i
+                  << "):\n";
+      }
+      pseudoRouteCircuit(true);
 
-    if (config.verbose) {
-      std::clog << "\nMain routing:\n";
+      if (config.verbose) {
+        std::clog << "\nMain routing:\n";
+      }
     }
   }
+  if (config.iterativeBidirectionalRoutingPasses > 0) {
+    // the layout found by pseudo-routing is the initial layout of the circuit
+    recordInitialLayout();
+  }
 
   routeCircuit();
 
@@ -69,7 +244,7 @@ void HeuristicMapper::map(const Configuration& configuration) {
   const auto                          end  = std::chrono::steady_clock::now();
   const std::chrono::duration<double> diff = end - start;
   results.time                             = diff.count();
-  results.timeout                          = false;
+  results.timeout                          = !results.degradedLayers.empty();
 
   if (config.dataLoggingEnabled()) {
     dataLogger->logOutputCircuit(qcMapped);
@@ -78,6 +253,12 @@ void HeuristicMapper::map(const Configuration& configuration) {
   }
 }
 
+void HeuristicMapper::checkCancelled() const {
+  if (isCancelled()) {
+    throw QMAPException("Mapping cancelled.");
+  }
+}
+
 void HeuristicMapper::staticInitialMapping() {
   for (const auto& gate : layers.at(0U)) {
     if (gate.singleQubit()) {
@@ -136,10 +317,45 @@ void HeuristicMapper::checkParameters() {
                         "fidelity-aware lookahead heuristics (or no "
                         "lookahead)!");
   }
+  if (!fidelityAwareHeur && isFidelityAware(config.lookaheadHeuristic)) {
+    throw QMAPException("Fidelity-aware lookahead heuristics may only be used "
+                        "with fidelity-aware heuristics!");
+  }
   if (fidelityAwareHeur && config.teleportationQubits > 0) {
     throw QMAPException("Teleportation is not yet supported for heuristic "
                         "mapper using fidelity-aware mapping!");
   }
+  if (config.searchEngine == SearchEngine::HashDistributedAStar) {
+    if (config.teleportationQubits > 0) {
+      throw QMAPException("Teleportation is not yet supported for the "
+                          "hash-distributed search engine!");
+    }
+    if (config.dataLoggingEnabled()) {
+      throw QMAPException("Data logging is not supported for the "
+                          "hash-distributed search engine!");
+    }
+    if (config.earlyTermination != EarlyTermination::None ||
+        config.memoryBoundedSearch) {
+      throw QMAPException("Early termination and memory-bounded search are "
+                          "not supported for the hash-distributed search "
+                          "engine!");
+    }
+  }
+  if (config.iterativeBidirectionalRoutingChains > 1 &&
+      config.teleportationQubits > 0) {
+    throw QMAPException("Teleportation is not yet supported for iterative "
+                        "bidirectional routing with several chains!");
+  }
+  if (config.iterativeBidirectionalRoutingChains > 1 &&
+      config.iterativeBidirectionalRoutingPasses > 0 &&
+      config.layerWindow > 0) {
+    throw QMAPException("Streaming the layers is not supported for iterative "
+                        "bidirectional routing with several chains!");
+  }
+  if (config.memoryBoundedSearch && config.memoryBoundedSearchBeamWidth == 0) {
+    throw QMAPException("Memory-bounded search requires a beam width of at "
+                        "least 1!");
+  }
 }
 
 void HeuristicMapper::createInitialMapping() {
@@ -202,27 +418,94 @@ void HeuristicMapper::createInitialMapping() {
   case InitialLayout::Dynamic:
     // nothing to be done here
     break;
+  case InitialLayout::GraphIsomorphism:
+    graphIsomorphismInitialMapping();
+    break;
+  }
+}
 
-    // TODO: Design strategy that maps most used qubit to most connected qubits
-    // on architecture
+void HeuristicMapper::graphIsomorphismInitialMapping() {
+  const auto& config = results.config;
+
+  LayoutEmbedding embedding(*architecture,
+                            static_cast<std::uint16_t>(locations.size()),
+                            fidelityAwareHeur);
+  double weight = 1.;
+  for (std::size_t layer = 0; layer < layers.size(); ++layer) {
+    loadLayers(layer, layer + 1);
+    const auto& view = getLayerView(layer);
+    for (std::size_t i = 0; i < view.edges.size(); ++i) {
+      embedding.addTwoQubitGates(view.edges[i], view.multiplicities[i], weight);
+    }
+    const auto& singleQubitGateMultiplicity = getSingleQubitMultiplicity(layer);
+    for (std::size_t q = 0; q < singleQubitGateMultiplicity.size(); ++q) {
+      if (singleQubitGateMultiplicity[q] > 0) {
+        embedding.addSingleQubitGates(static_cast<std::uint16_t>(q),
+                                      singleQubitGateMultiplicity[q], weight);
+      }
+    }
+    weight *= LayoutEmbedding::LAYER_DECAY;
+  }
+
+  std::vector<bool> occupied(architecture->getNqubits(), false);
+  for (std::uint16_t physQbit = 0; physQbit < architecture->getNqubits();
+       ++physQbit) {
+    occupied[physQbit] = qubits.at(physQbit) != DEFAULT_POSITION;
+  }
+  // the budget is bounded by the deadline of the whole mapping
+  const auto now   = std::chrono::steady_clock::now();
+  auto       until = deadline;
+  if (deadline > now &&
+      config.initialLayoutTimeout <
+          static_cast<std::size_t>(
+              std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
+                                                                    now)
+                  .count())) {
+    until = now + std::chrono::milliseconds(config.initialLayoutTimeout);
+  }
+  const auto layout = embedding.embed(occupied, until);
+  for (std::size_t logQbit = 0; logQbit < layout.size(); ++logQbit) {
+    if (const auto physQbit = layout[logQbit]; physQbit != DEFAULT_POSITION) {
+      locations.at(logQbit) = physQbit;
+      qubits.at(static_cast<std::uint16_t>(physQbit)) =
+          static_cast<std::int16_t>(logQbit);
+    }
+  }
+  if (config.verbose) {
+    std::clog << "Initial layout cost: " << embedding.getCost()
+              << (embedding.isIsomorphism() ? " (isomorphism)" : "") << "\n";
   }
+
+  // assign remaining logical qubits
+  for (qc::Qubit i = 0U; i < architecture->getNqubits(); ++i) {
+    if (qc.initialLayout.count(i) > 0 && locations.at(i) == DEFAULT_POSITION) {
+      for (qc::Qubit j = 0U; j < architecture->getNqubits(); ++j) {
+        if (qubits.at(j) == DEFAULT_POSITION) {
+          locations.at(i) = static_cast<std::int16_t>(j);
+          qubits.at(j)    = static_cast<std::int16_t>(i);
+          break;
+        }
+      }
+    }
+  }
+  recordInitialLayout();
 }
 
-void HeuristicMapper::mapUnmappedGates(std::size_t layer) {
+void HeuristicMapper::mapUnmappedGates(const std::size_t layer, Node& node,
+                                       const bool recordLayout) {
   if (fidelityAwareHeur) {
-    for (std::size_t q = 0; q < singleQubitMultiplicities.at(layer).size();
-         ++q) {
-      if (singleQubitMultiplicities.at(layer).at(q) == 0) {
+    for (std::size_t q = 0; q < getSingleQubitMultiplicity(layer).size(); ++q) {
+      if (getSingleQubitMultiplicity(layer).at(q) == 0) {
         continue;
       }
-      if (locations.at(q) == DEFAULT_POSITION) {
+      if (node.locations.at(q) == DEFAULT_POSITION) {
         // TODO: consider fidelity
         // map to first free physical qubit
         for (std::uint16_t physQbit = 0; physQbit < architecture->getNqubits();
              ++physQbit) {
-          if (qubits.at(physQbit) == -1) {
-            locations.at(q)     = static_cast<std::int16_t>(physQbit);
-            qubits.at(physQbit) = static_cast<std::int16_t>(q);
+          if (node.qubits.at(physQbit) == -1) {
+            node.locations.at(q)     = static_cast<std::int16_t>(physQbit);
+            node.qubits.at(physQbit) = static_cast<std::int16_t>(q);
             break;
           }
         }
@@ -230,18 +513,18 @@ void HeuristicMapper::mapUnmappedGates(std::size_t layer) {
     }
   }
 
-  for (const auto& [logEdge, _] : twoQubitMultiplicities.at(layer)) {
+  for (const auto& logEdge : getLayerView(layer).edges) {
     const auto& [q1, q2] = logEdge;
 
-    const auto q1Location = locations.at(q1);
-    const auto q2Location = locations.at(q2);
+    const auto q1Location = node.locations.at(q1);
+    const auto q2Location = node.locations.at(q2);
 
     if (q1Location == DEFAULT_POSITION && q2Location == DEFAULT_POSITION) {
       std::set<Edge> possibleEdges{};
       // gather all edges in the architecture for which both qubits are unmapped
       for (const auto& edge : architecture->getCouplingMap()) {
-        if (qubits.at(edge.first) == DEFAULT_POSITION &&
-            qubits.at(edge.second) == DEFAULT_POSITION) {
+        if (node.qubits.at(edge.first) == DEFAULT_POSITION &&
+            node.qubits.at(edge.second) == DEFAULT_POSITION) {
           possibleEdges.emplace(edge);
         }
       }
@@ -253,9 +536,9 @@ void HeuristicMapper::mapUnmappedGates(std::size_t layer) {
 
         for (std::uint16_t i = 0; i < architecture->getNqubits(); i++) {
           for (std::uint16_t j = i + 1; j < architecture->getNqubits(); j++) {
-            if (qubits.at(i) == DEFAULT_POSITION &&
-                qubits.at(j) == DEFAULT_POSITION) {
-              const double dist = architecture->distance(i, j);
+            if (node.qubits.at(i) == DEFAULT_POSITION &&
+                node.qubits.at(j) == DEFAULT_POSITION) {
+              const double dist = physicalDistance(i, j);
               if (dist < bestScore) {
                 bestScore  = dist;
                 chosenEdge = std::make_pair(i, j);
@@ -268,35 +551,38 @@ void HeuristicMapper::mapUnmappedGates(std::size_t layer) {
       }
       // TODO: Consider fidelity here if available. The best available edge
       // should be chosen
-      locations.at(q1) = static_cast<std::int16_t>(chosenEdge.first);
-      locations.at(q2) = static_cast<std::int16_t>(chosenEdge.second);
-      qubits.at(chosenEdge.first)  = static_cast<std::int16_t>(q1);
-      qubits.at(chosenEdge.second) = static_cast<std::int16_t>(q2);
-      qc::QuantumComputation::findAndSWAP(q1, chosenEdge.first,
-                                          qcMapped.initialLayout);
-      qc::QuantumComputation::findAndSWAP(q2, chosenEdge.second,
-                                          qcMapped.initialLayout);
-      qc::QuantumComputation::findAndSWAP(q1, chosenEdge.first,
-                                          qcMapped.outputPermutation);
-      qc::QuantumComputation::findAndSWAP(q2, chosenEdge.second,
-                                          qcMapped.outputPermutation);
+      node.locations.at(q1) = static_cast<std::int16_t>(chosenEdge.first);
+      node.locations.at(q2) = static_cast<std::int16_t>(chosenEdge.second);
+      node.qubits.at(chosenEdge.first)  = static_cast<std::int16_t>(q1);
+      node.qubits.at(chosenEdge.second) = static_cast<std::int16_t>(q2);
+      if (recordLayout) {
+        qc::QuantumComputation::findAndSWAP(q1, chosenEdge.first,
+                                            qcMapped.initialLayout);
+        qc::QuantumComputation::findAndSWAP(q2, chosenEdge.second,
+                                            qcMapped.initialLayout);
+        qc::QuantumComputation::findAndSWAP(q1, chosenEdge.first,
+                                            qcMapped.outputPermutation);
+        qc::QuantumComputation::findAndSWAP(q2, chosenEdge.second,
+                                            qcMapped.outputPermutation);
+      }
     } else if (q1Location == DEFAULT_POSITION) {
-      mapToMinDistance(q2, q1);
+      mapToMinDistance(node, q2, q1, recordLayout);
     } else if (q2Location == DEFAULT_POSITION) {
-      mapToMinDistance(q1, q2);
+      mapToMinDistance(node, q1, q2, recordLayout);
     }
   }
 }
 
-void HeuristicMapper::mapToMinDistance(const std::uint16_t source,
-                                       const std::uint16_t target) {
+void HeuristicMapper::mapToMinDistance(Node& node, const std::uint16_t source,
+                                       const std::uint16_t target,
+                                       const bool          recordLayout) {
   auto                         min = std::numeric_limits<double>::max();
   std::optional<std::uint16_t> pos = std::nullopt;
   for (std::uint16_t i = 0; i < architecture->getNqubits(); ++i) {
-    if (qubits.at(i) == DEFAULT_POSITION) {
+    if (node.qubits.at(i) == DEFAULT_POSITION) {
       // TODO: Consider fidelity here if available
-      const auto distance = architecture->distance(
-          static_cast<std::uint16_t>(locations.at(source)), i);
+      const auto distance = physicalDistance(
+          static_cast<std::uint16_t>(node.locations.at(source)), i);
       if (distance < min) {
         min = distance;
         pos = i;
@@ -304,10 +590,26 @@ void HeuristicMapper::mapToMinDistance(const std::uint16_t source,
     }
   }
   assert(pos.has_value());
-  qubits.at(*pos)      = static_cast<std::int16_t>(target);
-  locations.at(target) = static_cast<std::int16_t>(*pos);
-  qc::QuantumComputation::findAndSWAP(target, *pos, qcMapped.initialLayout);
-  qc::QuantumComputation::findAndSWAP(target, *pos, qcMapped.outputPermutation);
+  node.qubits.at(*pos)      = static_cast<std::int16_t>(target);
+  node.locations.at(target) = static_cast<std::int16_t>(*pos);
+  if (recordLayout) {
+    qc::QuantumComputation::findAndSWAP(target, *pos, qcMapped.initialLayout);
+    qc::QuantumComputation::findAndSWAP(target, *pos,
+                                        qcMapped.outputPermutation);
+  }
+}
+
+void HeuristicMapper::recordInitialLayout() {
+  for (std::size_t physQbit = 0; physQbit < qubits.size(); ++physQbit) {
+    if (const auto logQbit = qubits.at(physQbit); logQbit != DEFAULT_POSITION) {
+      qc::QuantumComputation::findAndSWAP(static_cast<qc::Qubit>(logQbit),
+                                          static_cast<qc::Qubit>(physQbit),
+                                          qcMapped.initialLayout);
+      qc::QuantumComputation::findAndSWAP(static_cast<qc::Qubit>(logQbit),
+                                          static_cast<qc::Qubit>(physQbit),
+                                          qcMapped.outputPermutation);
+    }
+  }
 }
 
 void HeuristicMapper::pseudoRouteCircuit(bool reverse) {
@@ -319,6 +621,8 @@ void HeuristicMapper::pseudoRouteCircuit(bool reverse) {
   const auto originalActiveQubits              = activeQubits;
   const auto originalActiveQubits1QGates       = activeQubits1QGates;
   const auto originalActiveQubits2QGates       = activeQubits2QGates;
+  const auto originalLayerViews                = layerViews;
+  const auto originalLayerWindowBegin          = layerWindowBegin;
 
   auto& config           = results.config;
   config.dataLoggingPath = ""; // disable data logging for pseudo routing
@@ -326,7 +630,8 @@ void HeuristicMapper::pseudoRouteCircuit(bool reverse) {
 
   for (std::size_t i = 0; i < layers.size(); ++i) {
     const auto layerIndex = (reverse ? layers.size() - i - 1 : i);
-    const Node result     = aStarMap(layerIndex, reverse);
+    loadRoutingLayers(layerIndex, reverse);
+    const Node result = aStarMap(layerIndex, reverse);
 
     qubits    = result.qubits;
     locations = result.locations;
@@ -345,15 +650,212 @@ void HeuristicMapper::pseudoRouteCircuit(bool reverse) {
   activeQubits              = originalActiveQubits;
   activeQubits1QGates       = originalActiveQubits1QGates;
   activeQubits2QGates       = originalActiveQubits2QGates;
+  layerViews                = originalLayerViews;
+  layerWindowBegin          = originalLayerWindowBegin;
+}
+
+void HeuristicMapper::routeBidirectionalChains() {
+  const auto& config  = results.config;
+  const auto  nChains = config.iterativeBidirectionalRoutingChains;
+  const auto  width   = static_cast<std::size_t>(architecture->getNqubits());
+
+  struct Chain {
+    Node        layout{};
+    std::size_t estimate = std::numeric_limits<std::size_t>::max();
+    std::size_t passes   = 0;
+  };
+  std::vector<Chain> chains(nChains);
+
+  for (std::size_t c = 0; c < nChains; ++c) {
+    auto& layout     = chains[c].layout;
+    layout.qubits    = qubits;
+    layout.locations = locations;
+    if (c == 0) {
+      continue;
+    }
+    // place the logical qubits of the circuit randomly on all physical qubits
+    // not occupied by teleportation qubits
+    std::mt19937_64            mt(c);
+    std::vector<std::uint16_t> physQubits{};
+    for (std::uint16_t physQbit = 0; physQbit < width; ++physQbit) {
+      const auto logQbit = qubits.at(physQbit);
+      if (logQbit == DEFAULT_POSITION ||
+          static_cast<std::size_t>(logQbit) < qc.getNqubits()) {
+        physQubits.emplace_back(physQbit);
+        layout.qubits.at(physQbit) = DEFAULT_POSITION;
+      }
+    }
+    std::shuffle(physQubits.begin(), physQubits.end(), mt);
+    auto physQbit = physQubits.begin();
+    for (qc::Qubit logQbit = 0; logQbit < width; ++logQbit) {
+      if (qc.initialLayout.count(logQbit) > 0) {
+        assert(physQbit != physQubits.end());
+        layout.locations.at(logQbit) = static_cast<std::int16_t>(*physQbit);
+        layout.qubits.at(*physQbit)  = static_cast<std::int16_t>(logQbit);
+        ++physQbit;
+      } else if (logQbit < qc.getNqubits()) {
+        layout.locations.at(logQbit) = DEFAULT_POSITION;
+      }
+    }
+  }
+
+  const auto route = [this, &config, &chains, width](const std::size_t c) {
+    auto&        chain = chains[c];
+    SearchWorker worker(width, 1);
+    auto         layout = chain.layout;
+    while (true) {
+      // the forward pass from a layout estimates the cost of routing from it
+      auto       mapping  = layout;
+      const auto estimate = pseudoRouteChain(mapping, false, worker);
+      if (estimate >= chain.estimate) {
+        break;
+      }
+      chain.estimate = estimate;
+      chain.layout   = layout;
+      if (chain.passes == config.iterativeBidirectionalRoutingPasses ||
+          estimate == 0) {
+        break;
+      }
+      pseudoRouteChain(mapping, true, worker);
+      layout = std::move(mapping);
+      ++chain.passes;
+    }
+  };
+  if (threadPool) {
+    threadPool->parallelFor(
+        nChains,
+        [&route](std::size_t /*thread*/, const std::size_t c) { route(c); });
+  } else {
+    for (std::size_t c = 0; c < nChains; ++c) {
+      route(c);
+    }
+  }
+
+  // ties are broken by the index of the chain to be independent of the timing
+  // of the threads
+  std::size_t best = 0;
+  for (std::size_t c = 0; c < nChains; ++c) {
+    if (config.verbose) {
+      std::clog << "Iterative bidirectional routing chain " << c << ": "
+                << chains[c].passes << " passes, estimated swaps "
+                << chains[c].estimate << "\n";
+    }
+    if (chains[c].estimate < chains[best].estimate) {
+      best = c;
+    }
+  }
+  qubits    = chains[best].layout.qubits;
+  locations = chains[best].layout.locations;
+}
+
+std::size_t HeuristicMapper::pseudoRouteChain(Node& mapping, const bool reverse,
+                                              SearchWorker& worker) {
+  const auto& config = results.config;
+  auto&       node   = worker.node;
+  std::size_t nSwaps = 0;
+  for (std::size_t i = 0; i < layers.size(); ++i) {
+    checkCancelled();
+    if (deadlineExpired()) {
+      return std::numeric_limits<std::size_t>::max();
+    }
+    const auto layer = (reverse ? layers.size() - i - 1 : i);
+
+    Node root{};
+    root.qubits    = mapping.qubits;
+    root.locations = mapping.locations;
+    mapUnmappedGates(layer, root, false);
+    recalculateFixedCost(layer, root);
+    updateHeuristicCost(layer, root);
+    updateLookaheadPenalty(layer, root);
+
+    if (config.warmStartSearch && root.validMapping) {
+      mapping.qubits    = root.qubits;
+      mapping.locations = root.locations;
+      continue;
+    }
+
+    worker.reset();
+    NodeArena::Entry rootEntry{};
+    rootEntry.costFixed                = root.costFixed;
+    rootEntry.costFixedReversals       = root.costFixedReversals;
+    rootEntry.costHeur                 = root.costHeur;
+    rootEntry.lookaheadPenalty         = root.lookaheadPenalty;
+    rootEntry.sharedSwaps              = root.sharedSwaps;
+    rootEntry.depth                    = root.depth;
+    rootEntry.validMappedTwoQubitGates = root.validMappedTwoQubitGates.size();
+    rootEntry.validMapping             = root.validMapping;
+    rootEntry.hash = worker.arena.hashMapping(root.qubits.data());
+    worker.receive(rootEntry, root.qubits.data(), 0);
+
+    // sequential A*-search on the nodes of the worker (as in `aStarMap`)
+    while (!worker.open.empty() &&
+           (!worker.foundGoal ||
+            worker.arena.at(worker.open.top()).getTotalCost() <
+                worker.arena.at(worker.bestGoal).getTotalFixedCost())) {
+      if (deadlineExpired()) {
+        return std::numeric_limits<std::size_t>::max();
+      }
+      const auto current = worker.open.top();
+      worker.open.pop();
+      if (worker.arena.at(current).validMapping) {
+        if (!worker.foundGoal ||
+            worker.arena.at(current).getTotalFixedCost() <
+                worker.arena.at(worker.bestGoal).getTotalFixedCost()) {
+          worker.bestGoal = current;
+        }
+        worker.foundGoal = true;
+        if (tightHeur) {
+          break;
+        }
+      }
+
+      restoreNodeState(worker.arena, current, layer, node);
+      node.swaps.clear();
+      collectExpansionCandidates(node, layer, {}, worker.candidates,
+                                 worker.usedSwaps);
+      if (!worker.candidates.empty()) {
+        cacheGateCosts(layer, node);
+      }
+      for (const auto& swap : worker.candidates) {
+        const auto child =
+            applyExchange(worker.arena, swap, current, node, layer);
+        worker.receive(child, node.qubits.data(), 0);
+        revertExchange(worker.arena, swap, current, layer, node);
+      }
+    }
+    if (!worker.foundGoal) {
+      throw QMAPException("No viable mapping found.");
+    }
+
+    restoreNodeState(worker.arena, worker.bestGoal, layer, mapping);
+    if (i != 0 || config.swapOnFirstLayer) {
+      nSwaps += worker.arena.at(worker.bestGoal).depth;
+    }
+  }
+  return nSwaps;
 }
 
 void HeuristicMapper::routeCircuit() {
   const auto& config = results.config;
 
-  std::size_t              gateidx = 0;
-  std::vector<std::size_t> gatesToAdjust{};
+  // reserve the mapped circuit for the gates of the circuit and the barriers
+  // between the layers, only SWAPs and direction reversals are added on top
+  std::size_t nOps = 0U;
+  for (const auto& layer : layers) {
+    nOps += layer.size();
+  }
+  if (config.addBarriersBetweenLayers && !layers.empty()) {
+    nOps += layers.size() - 1;
+  }
+  qcMapped.reserve(qcMapped.size() + nOps);
+
+  std::vector<Edge>         swaps{};
+  std::vector<DeferredGate> deferred{};
   results.output.gates = 0U;
+  const auto start     = std::chrono::steady_clock::now();
   for (std::size_t layerIndex = 0; layerIndex < layers.size(); ++layerIndex) {
+    checkCancelled();
+    loadRoutingLayers(layerIndex, false);
     const Node result = aStarMap(layerIndex, false);
 
     qubits    = result.qubits;
@@ -366,7 +868,6 @@ void HeuristicMapper::routeCircuit() {
 
     if (layerIndex != 0 && config.addBarriersBetweenLayers) {
       qcMapped.barrier();
-      gateidx++;
     }
 
     // initial layer needs no swaps
@@ -381,7 +882,9 @@ void HeuristicMapper::routeCircuit() {
           assert(
               architecture->isEdgeConnected({swap.first, swap.second}, false));
           qcMapped.swap(swap.first, swap.second);
+          swaps.emplace_back(swap.first, swap.second);
           results.output.swaps++;
+          committedExchanges.fetch_add(1, std::memory_order_relaxed);
         } else if (swap.op == qc::Teleportation) {
           if (config.verbose) {
             std::clog << "TELE: " << swap.first << " <-> " << swap.second
@@ -393,8 +896,8 @@ void HeuristicMapper::routeCircuit() {
                           static_cast<qc::Qubit>(swap.middleAncilla)},
               qc::Teleportation);
           results.output.teleportations++;
+          committedExchanges.fetch_add(1, std::memory_order_relaxed);
         }
-        gateidx++;
       }
     }
 
@@ -409,14 +912,13 @@ void HeuristicMapper::routeCircuit() {
 
       if (gate.singleQubit()) {
         if (locations.at(gate.target) == DEFAULT_POSITION) {
-          qcMapped.emplace_back<qc::StandardOperation>(
+          auto deferredOp = std::make_unique<qc::StandardOperation>(
               gate.target, op->getType(), op->getParameter());
-          gatesToAdjust.push_back(gateidx);
-          gateidx++;
+          deferred.push_back({deferredOp.get(), swaps.size()});
+          qcMapped.emplace_back(std::move(deferredOp));
         } else {
           qcMapped.emplace_back<qc::StandardOperation>(
               locations.at(gate.target), op->getType(), op->getParameter());
-          gateidx++;
         }
       } else {
         const Edge cnot = {
@@ -434,14 +936,26 @@ void HeuristicMapper::routeCircuit() {
           qcMapped.h(reversed.first);
 
           results.output.directionReverse++;
-          gateidx += 5;
         } else {
           qcMapped.cx(qc::Control{static_cast<qc::Qubit>(cnot.first)},
                       cnot.second);
-          gateidx++;
         }
       }
     }
+
+    if (config.layerWindow > 0) {
+      // the layer is not needed anymore
+      std::vector<Gate>().swap(layers.at(layerIndex));
+    }
+  }
+
+  if (config.debug) {
+    const std::chrono::duration<double> diff =
+        std::chrono::steady_clock::now() - start;
+    if (diff.count() > 0.) {
+      results.heuristicBenchmark.layersPerSecond =
+          static_cast<double>(layers.size()) / diff.count();
+    }
   }
 
   if (config.debug && results.heuristicBenchmark.expandedNodes > 0) {
@@ -474,53 +988,8 @@ void HeuristicMapper::routeCircuit() {
   }
 
   // fix single qubit gates
-  if (!gatesToAdjust.empty()) {
-    gateidx--; // index of last operation
-    for (auto it = qcMapped.rbegin(); it != qcMapped.rend(); ++it, --gateidx) {
-      auto* op = dynamic_cast<qc::StandardOperation*>(it->get());
-      if (op == nullptr) {
-        throw QMAPException(
-            "Cast to StandardOperation not possible during mapping. Check that "
-            "circuit contains only StandardOperations");
-      }
-      if (op->getType() == qc::SWAP) {
-        const auto q0                     = qubits.at(op->getTargets().at(0));
-        const auto q1                     = qubits.at(op->getTargets().at(1));
-        qubits.at(op->getTargets().at(0)) = q1;
-        qubits.at(op->getTargets().at(1)) = q0;
-
-        if (q0 != DEFAULT_POSITION) {
-          locations.at(static_cast<std::size_t>(q0)) =
-              static_cast<std::int16_t>(op->getTargets().at(1));
-        }
-        if (q1 != DEFAULT_POSITION) {
-          locations.at(static_cast<std::size_t>(q1)) =
-              static_cast<std::int16_t>(op->getTargets().at(0));
-        }
-      }
-      if (!gatesToAdjust.empty() && gatesToAdjust.back() == gateidx) {
-        gatesToAdjust.pop_back();
-        const auto target         = op->getTargets().at(0);
-        const auto targetLocation = locations.at(target);
-
-        if (targetLocation == -1) {
-          // qubit only occurs in single qubit gates, can be mapped to an
-          // arbitrary free qubit
-          std::uint16_t loc = 0;
-          while (qubits.at(loc) != DEFAULT_POSITION) {
-            ++loc;
-          }
-          locations.at(target) = static_cast<std::int16_t>(loc);
-          qubits.at(loc)       = static_cast<std::int16_t>(target);
-          op->setTargets({static_cast<qc::Qubit>(loc)});
-          qcMapped.initialLayout.at(loc)                          = target;
-          qcMapped.outputPermutation[static_cast<qc::Qubit>(loc)] = target;
-          qcMapped.garbage.at(loc)                                = false;
-        } else {
-          op->setTargets({static_cast<qc::Qubit>(targetLocation)});
-        }
-      }
-    }
+  if (!deferred.empty()) {
+    placeDeferredGates(swaps, deferred);
   }
 
   // mark every qubit that is not mapped to a logical qubit as garbage
@@ -534,22 +1003,67 @@ void HeuristicMapper::routeCircuit() {
   }
 }
 
+void HeuristicMapper::placeDeferredGates(
+    const std::vector<Edge>& swaps, const std::vector<DeferredGate>& deferred) {
+  auto remaining = swaps.size();
+  for (auto it = deferred.rbegin(); it != deferred.rend(); ++it) {
+    // undo the SWAPs after the gate
+    for (; remaining > it->swapsBefore; --remaining) {
+      const auto [p0, p1] = swaps.at(remaining - 1);
+      const auto q0       = qubits.at(p0);
+      const auto q1       = qubits.at(p1);
+      qubits.at(p0)       = q1;
+      qubits.at(p1)       = q0;
+      if (q0 != DEFAULT_POSITION) {
+        locations.at(static_cast<std::size_t>(q0)) =
+            static_cast<std::int16_t>(p1);
+      }
+      if (q1 != DEFAULT_POSITION) {
+        locations.at(static_cast<std::size_t>(q1)) =
+            static_cast<std::int16_t>(p0);
+      }
+    }
+
+    auto*      op             = it->op;
+    const auto target         = op->getTargets().at(0);
+    const auto targetLocation = locations.at(target);
+    if (targetLocation == DEFAULT_POSITION) {
+      // qubit only occurs in single qubit gates, can be mapped to an
+      // arbitrary free qubit
+      std::uint16_t loc = 0;
+      while (qubits.at(loc) != DEFAULT_POSITION) {
+        ++loc;
+      }
+      locations.at(target) = static_cast<std::int16_t>(loc);
+      qubits.at(loc)       = static_cast<std::int16_t>(target);
+      op->setTargets({static_cast<qc::Qubit>(loc)});
+      qcMapped.initialLayout.at(loc)                          = target;
+      qcMapped.outputPermutation[static_cast<qc::Qubit>(loc)] = target;
+      qcMapped.garbage.at(loc)                                = false;
+    } else {
+      op->setTargets({static_cast<qc::Qubit>(targetLocation)});
+    }
+  }
+}
+
 HeuristicMapper::Node HeuristicMapper::aStarMap(size_t layer, bool reverse) {
   const auto& config = results.config;
   nextNodeId         = 0;
 
-  const SingleQubitMultiplicity& singleQubitMultiplicity =
-      singleQubitMultiplicities.at(layer);
-  const TwoQubitMultiplicity& twoQubitMultiplicity =
-      twoQubitMultiplicities.at(layer);
-  Node node(nextNodeId++);
-  Node bestDoneNode(0);
-  bool validMapping = false;
+  Node             node(nextNodeId++);
+  NodeArena::Index bestDoneNode = 0;
+  bool             validMapping = false;
 
-  mapUnmappedGates(layer);
+  if (nodes.empty()) {
+    // no nodes of a previous search are referenced anymore
+    arena.reset(architecture->getNqubits());
+  }
 
   node.locations = locations;
   node.qubits    = qubits;
+  mapUnmappedGates(layer, node, true);
+  locations = node.locations;
+  qubits    = node.qubits;
   recalculateFixedCost(layer, node);
   updateHeuristicCost(layer, node);
   updateLookaheadPenalty(layer, node);
@@ -560,7 +1074,19 @@ HeuristicMapper::Node HeuristicMapper::aStarMap(size_t layer, bool reverse) {
                               node.costHeur, node.lookaheadPenalty, node.qubits,
                               node.validMapping, node.swaps, node.depth);
   }
-  nodes.push(node);
+  if (config.warmStartSearch && node.validMapping) {
+    // the mapping of the previous layer already satisfies this layer
+    if (config.debug) {
+      addLayerBenchmark(0, nextNodeId, 0, 0, 0.);
+      ++results.heuristicBenchmark.skippedLayers;
+    }
+    logLayerResult(layer, node);
+    return node;
+  }
+  if (config.searchEngine == SearchEngine::HashDistributedAStar) {
+    return hashDistributedAStarMap(layer, reverse, node);
+  }
+  pushRootNode(node);
 
   const auto  start         = std::chrono::steady_clock::now();
   std::size_t expandedNodes = 0;
@@ -568,41 +1094,27 @@ HeuristicMapper::Node HeuristicMapper::aStarMap(size_t layer, bool reverse) {
   std::size_t expandedNodesAfterOptimalSolution = 0;
   std::size_t solutionNodes                     = 0;
   std::size_t solutionNodesAfterOptimalSolution = 0;
+  std::size_t prunings                          = 0;
   bool        earlyTermination                  = false;
+  bool        degraded                          = false;
 
   const bool splittable =
       config.automaticLayerSplits ? isLayerSplittable(layer) : false;
 
+  std::size_t peakMemory = arena.memoryUsage() + nodes.memoryUsage();
+
   while (!nodes.empty() &&
-         (!validMapping ||
-          nodes.top().getTotalCost() < bestDoneNode.getTotalFixedCost())) {
+         (!validMapping || arena.at(nodes.top()).getTotalCost() <
+                               arena.at(bestDoneNode).getTotalFixedCost())) {
     if (splittable && expandedNodes >= config.automaticLayerSplitsNodeLimit) {
-      if (config.dataLoggingEnabled()) {
-        qc::CompoundOperation compOp{};
-        for (const auto& gate : layers.at(layer)) {
-          compOp.emplace_back(gate.op->clone());
-        }
-
-        dataLogger->logFinalizeLayer(layer, compOp, singleQubitMultiplicity,
-                                     twoQubitMultiplicity, qubits, 0, 0, 0, 0,
-                                     {}, {}, 0);
-        dataLogger->splitLayer();
-      }
-      splitLayer(layer, *architecture);
-      if (config.verbose) {
-        std::clog << "Split layer\n";
-      }
-      // recursively restart search with newly split layer
-      // (step to the end of the circuit, if reverse mapping is active, since
-      // the split layer is inserted in this direction, otherwise 1 layer would
-      // be skipped)
-      return aStarMap(reverse ? layer + 1 : layer, reverse);
-    }
-    Node current = nodes.top();
-    if (current.validMapping) {
+      return splitLayerAndRestart(layer, reverse);
+    }
+    checkCancelled();
+    const NodeArena::Index current = nodes.top();
+    if (arena.at(current).validMapping) {
       ++solutionNodes;
-      if (!validMapping ||
-          current.getTotalFixedCost() < bestDoneNode.getTotalFixedCost()) {
+      if (!validMapping || arena.at(current).getTotalFixedCost() <
+                               arena.at(bestDoneNode).getTotalFixedCost()) {
         bestDoneNode                      = current;
         expandedNodesAfterOptimalSolution = 0;
         solutionNodesAfterOptimalSolution = 0;
@@ -614,9 +1126,29 @@ HeuristicMapper::Node HeuristicMapper::aStarMap(size_t layer, bool reverse) {
         break;
       }
     }
+    if (deadlineExpired()) {
+      // a goal node found so far is still accepted below
+      degraded = !validMapping;
+      break;
+    }
     nodes.pop();
-    expandNode(current, layer);
+    if (config.dataLoggingEnabled()) {
+      // the children are logged together with all swaps on their path
+      restoreNode(current, layer, node);
+    } else {
+      // expanding a node does not depend on the swaps leading to it
+      restoreNodeState(arena, current, layer, node);
+      node.swaps.clear();
+    }
+    expandNode(current, node, layer);
     ++expandedNodes;
+    const auto memory = arena.memoryUsage() + nodes.memoryUsage();
+    peakMemory        = std::max(peakMemory, memory);
+    if (config.memoryBoundedSearch &&
+        memory > config.memoryBoundedSearchBudget) {
+      pruneSearch(bestDoneNode, validMapping);
+      ++prunings;
+    }
     if (validMapping) {
       ++expandedNodesAfterFirstSolution;
       ++expandedNodesAfterOptimalSolution;
@@ -650,81 +1182,555 @@ HeuristicMapper::Node HeuristicMapper::aStarMap(size_t layer, bool reverse) {
     }
   }
 
-  if (!validMapping) {
+  if (!validMapping && !degraded) {
     throw QMAPException("No viable mapping found.");
   }
+  if (!validMapping && getLayerView(layer).edges.size() > 1) {
+    // route the 2Q-gates of the layer one at a time
+    nodes.deleteQueue();
+    return splitLayerAndRestart(layer, reverse);
+  }
 
-  Node result = bestDoneNode;
+  Node result{};
+  if (validMapping) {
+    restoreNode(bestDoneNode, layer, result);
+  } else {
+    restoreNode(nodes.top(), layer, result);
+    routeLayerGreedily(layer, result);
+  }
+  if (degraded) {
+    results.degradedLayers.emplace_back(layer);
+  }
   if (config.debug) {
-    const auto end = std::chrono::steady_clock::now();
-    results.layerHeuristicBenchmark.emplace_back();
-    auto layerResultsIt           = results.layerHeuristicBenchmark.rbegin();
-    layerResultsIt->expandedNodes = expandedNodes;
-    results.heuristicBenchmark.expandedNodes += expandedNodes;
-
-    layerResultsIt->solutionDepth = result.depth;
-    layerResultsIt->expandedNodesAfterFirstSolution =
+    const std::chrono::duration<double> diff =
+        std::chrono::steady_clock::now() - start;
+    auto& layerResults =
+        addLayerBenchmark(expandedNodes, nextNodeId, result.depth, peakMemory,
+                          diff.count());
+    layerResults.expandedNodesAfterFirstSolution =
         expandedNodesAfterFirstSolution;
-    layerResultsIt->expandedNodesAfterOptimalSolution =
+    layerResults.expandedNodesAfterOptimalSolution =
         expandedNodesAfterOptimalSolution;
-    layerResultsIt->solutionNodes = solutionNodes;
-    layerResultsIt->solutionNodesAfterOptimalSolution =
+    layerResults.solutionNodes = solutionNodes;
+    layerResults.solutionNodesAfterOptimalSolution =
         solutionNodesAfterOptimalSolution;
-    layerResultsIt->earlyTermination = earlyTermination;
+    layerResults.earlyTermination = earlyTermination;
+    layerResults.prunings         = prunings;
+  }
+
+  logLayerResult(layer, result);
 
-    const std::chrono::duration<double> diff = end - start;
-    results.heuristicBenchmark.secondsPerNode += diff.count();
+  // clear nodes
+  nodes.deleteQueue();
 
-    layerResultsIt->generatedNodes = nextNodeId;
-    results.heuristicBenchmark.generatedNodes += layerResultsIt->generatedNodes;
+  return result;
+}
 
-    if (layerResultsIt->expandedNodes > 0) {
-      layerResultsIt->secondsPerNode =
-          diff.count() / static_cast<double>(layerResultsIt->expandedNodes);
-      layerResultsIt->averageBranchingFactor =
-          static_cast<double>(layerResultsIt->generatedNodes - 1) /
-          static_cast<double>(layerResultsIt->expandedNodes);
+void HeuristicMapper::routeLayerGreedily(const std::size_t layer, Node& node) {
+  const auto& distances = architecture->getDistanceTable(false);
+  for (const auto& [q1, q2] : getLayerView(layer).edges) {
+    auto       source = static_cast<std::uint16_t>(node.locations.at(q1));
+    const auto target = static_cast<std::uint16_t>(node.locations.at(q2));
+    while (!architecture->isEdgeConnected({source, target}, false)) {
+      // a neighbour on a shortest path is strictly closer to the target
+      std::uint16_t next = source;
+      for (const auto& edge : architecture->getIncidentEdges(source)) {
+        const auto neighbour =
+            (edge.first == source ? edge.second : edge.first);
+        if (distances(neighbour, target) < distances(next, target)) {
+          next = neighbour;
+        }
+      }
+      if (next == source) {
+        throw QMAPException("No viable mapping found.");
+      }
+      applySWAP({source, next}, layer, node);
+      ++node.depth;
+      source = next;
     }
+  }
+}
+
+void HeuristicMapper::logLayerResult(const std::size_t layer,
+                                     const Node&       result) {
+  if (!results.config.dataLoggingEnabled()) {
+    return;
+  }
+  qc::CompoundOperation compOp{};
+  for (const auto& gate : layers.at(layer)) {
+    compOp.emplace_back(gate.op->clone());
+  }
+
+  dataLogger->logFinalizeLayer(
+      layer, compOp, getSingleQubitMultiplicity(layer),
+      getTwoQubitMultiplicity(layer), qubits, result.id, result.costFixed,
+      result.costHeur, result.lookaheadPenalty, result.qubits, result.swaps,
+      result.depth);
+}
+
+HeuristicMapper::Node
+HeuristicMapper::hashDistributedAStarMap(const std::size_t layer,
+                                         const bool reverse, const Node& root) {
+  const auto& config = results.config;
+  const auto  start  = std::chrono::steady_clock::now();
+  const auto  width  = static_cast<std::size_t>(architecture->getNqubits());
+  const auto  nWorkers   = threadPool ? threadPool->size() : std::size_t{1};
+  const bool  splittable =
+      config.automaticLayerSplits ? isLayerSplittable(layer) : false;
+
+  auto& workers = searchWorkers;
+  if (workers.size() != nWorkers ||
+      workers.front()->arena.getWidth() != width) {
+    workers.clear();
+    workers.reserve(nWorkers);
+    for (std::size_t w = 0; w < nWorkers; ++w) {
+      workers.emplace_back(std::make_shared<SearchWorker>(width, nWorkers));
+    }
+  } else {
+    for (const auto& worker : workers) {
+      worker->reset();
+    }
+  }
+
+  // number of nodes in open lists, in transit between workers, or currently
+  // being expanded; the search is finished once it drops to zero
+  std::atomic<std::size_t> pendingNodes{0};
+  std::atomic<std::size_t> expandedNodes{0};
+  // fixed cost of the best goal node found by any worker
+  std::atomic<double> incumbent{std::numeric_limits<double>::max()};
+  std::atomic<bool>   stop{false};
+  std::atomic<bool>   split{false};
+  std::atomic<bool>   expired{false};
+
+  NodeArena::Entry rootEntry{};
+  rootEntry.costFixed                = root.costFixed;
+  rootEntry.costFixedReversals       = root.costFixedReversals;
+  rootEntry.costHeur                 = root.costHeur;
+  rootEntry.lookaheadPenalty         = root.lookaheadPenalty;
+  rootEntry.sharedSwaps              = root.sharedSwaps;
+  rootEntry.depth                    = root.depth;
+  rootEntry.validMappedTwoQubitGates = root.validMappedTwoQubitGates.size();
+  rootEntry.validMapping             = root.validMapping;
+  rootEntry.hash = workers.front()->arena.hashMapping(root.qubits.data());
+  workers[ownerOf(rootEntry.hash, nWorkers)]->receive(rootEntry,
+                                                      root.qubits.data(), 0);
+  pendingNodes = 1;
+
+  const auto receive = [&pendingNodes](SearchWorker&           worker,
+                                       const NodeArena::Entry& entry,
+                                       const std::int16_t*     mapping,
+                                       const std::size_t       parentWorker) {
+    if (worker.receive(entry, mapping, parentWorker) <= 0) {
+      // either the node itself or the node it replaced left the open lists
+      --pendingNodes;
+    }
+  };
+
+  const auto work = [&](const std::size_t w) {
+    auto& worker = *workers[w];
+    auto& node   = worker.node;
+    try {
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (isCancelled()) {
+          // reported once all workers have been joined
+          stop = true;
+          break;
+        }
+        worker.inbox.consumeAll([&](NodeBatch&& batch) {
+          for (std::size_t i = 0; i < batch.entries.size(); ++i) {
+            receive(worker, batch.entries[i], batch.mappings.data() + i * width,
+                    batch.sender);
+          }
+          // hand the batch back to its sender to be filled again
+          batch.entries.clear();
+          batch.mappings.clear();
+          const auto sender = batch.sender;
+          workers[sender]->returnedBatches.push(std::move(batch));
+        });
+
+        if (worker.open.empty()) {
+          if (pendingNodes.load() == 0) {
+            break;
+          }
+          std::this_thread::yield();
+          continue;
+        }
+
+        const auto current = worker.open.top();
+        worker.open.pop();
+        const auto currentCost = worker.arena.at(current).getTotalCost();
+        if (currentCost >= incumbent.load()) {
+          // cannot improve the best goal node found so far
+          --pendingNodes;
+          continue;
+        }
+
+        if (worker.arena.at(current).validMapping) {
+          const auto fixedCost = worker.arena.at(current).getTotalFixedCost();
+          if (!worker.foundGoal ||
+              fixedCost <
+                  worker.arena.at(worker.bestGoal).getTotalFixedCost()) {
+            worker.foundGoal = true;
+            worker.bestGoal  = current;
+          }
+          auto best = incumbent.load();
+          while (fixedCost < best &&
+                 !incumbent.compare_exchange_weak(best, fixedCost)) {
+            // `best` has been updated to the current incumbent, retry
+          }
+          if (tightHeur) {
+            --pendingNodes;
+            continue;
+          }
+        }
+        if (deadlineExpired()) {
+          // goal nodes are accepted above, only their expansion is skipped
+          expired = true;
+          stop    = true;
+          break;
+        }
+
+        restoreNodeState(worker.arena, current, layer, node);
+        node.swaps.clear();
+        collectExpansionCandidates(node, layer, {}, worker.candidates,
+                                   worker.usedSwaps);
+        if (!worker.candidates.empty()) {
+          cacheGateCosts(layer, node);
+        }
+        // count all children before any of them can be received by another
+        // worker, so that the number of pending nodes cannot drop to zero
+        // prematurely
+        pendingNodes += worker.candidates.size();
+        for (const auto& swap : worker.candidates) {
+          const auto child =
+              applyExchange(worker.arena, swap, current, node, layer);
+          const auto owner = ownerOf(child.hash, nWorkers);
+          if (owner == w) {
+            receive(worker, child, node.qubits.data(), w);
+          } else {
+            auto& batch = worker.outboxes[owner];
+            batch.entries.emplace_back(child);
+            batch.mappings.insert(batch.mappings.end(), node.qubits.data(),
+                                  node.qubits.data() + width);
+          }
+          revertExchange(worker.arena, swap, current, layer, node);
+        }
+        worker.generatedNodes += worker.candidates.size();
+        ++worker.expandedNodes;
+
+        for (std::size_t owner = 0; owner < nWorkers; ++owner) {
+          if (auto& batch = worker.outboxes[owner]; !batch.entries.empty()) {
+            batch.sender = w;
+            workers[owner]->inbox.push(std::move(batch));
+            batch = worker.takeSpareBatch();
+          }
+        }
+        --pendingNodes;
+
+        if (splittable &&
+            ++expandedNodes >= config.automaticLayerSplitsNodeLimit) {
+          split = true;
+          stop  = true;
+        }
+      }
+    } catch (...) {
+      stop = true;
+      throw;
+    }
+  };
+
+  if (threadPool) {
+    threadPool->parallelFor(
+        nWorkers, [&work](std::size_t /*thread*/, const std::size_t w) {
+          work(w);
+        });
+  } else {
+    work(0);
+  }
+
+  checkCancelled();
+  if (split) {
+    return splitLayerAndRestart(layer, reverse);
+  }
+
+  // choose the best goal node among all workers (ties are broken by the
+  // mapping to be independent of the timing of the workers)
+  std::size_t bestWorker = nWorkers;
+  for (std::size_t w = 0; w < nWorkers; ++w) {
+    const auto& worker = *workers[w];
+    if (!worker.foundGoal) {
+      continue;
+    }
+    if (bestWorker == nWorkers) {
+      bestWorker = w;
+      continue;
+    }
+    const auto& other = *workers[bestWorker];
+    const auto  cost  = worker.arena.at(worker.bestGoal).getTotalFixedCost();
+    const auto  otherCost = other.arena.at(other.bestGoal).getTotalFixedCost();
+    const auto* mapping   = worker.arena.mapping(worker.bestGoal);
+    const auto* otherMapping = other.arena.mapping(other.bestGoal);
+    if (cost < otherCost ||
+        (cost == otherCost &&
+         std::lexicographical_compare(mapping, mapping + width, otherMapping,
+                                      otherMapping + width))) {
+      bestWorker = w;
+    }
+  }
+  if (bestWorker == nWorkers && !expired) {
+    throw QMAPException("No viable mapping found.");
+  }
+  if (bestWorker == nWorkers && getLayerView(layer).edges.size() > 1) {
+    // route the 2Q-gates of the layer one at a time
+    return splitLayerAndRestart(layer, reverse);
+  }
+
+  Node result{};
+  if (bestWorker != nWorkers) {
+    auto index = workers[bestWorker]->bestGoal;
+    restoreNodeState(workers[bestWorker]->arena, index, layer, result);
+    result.swaps.clear();
+    for (auto w = bestWorker;
+         workers[w]->arena.at(index).parent != NodeArena::NO_PARENT;) {
+      const auto& entry = workers[w]->arena.at(index);
+      result.swaps.emplace_back(entry.swap);
+      w     = workers[w]->parentWorkers[index];
+      index = entry.parent;
+    }
+    std::reverse(result.swaps.begin(), result.swaps.end());
+  } else {
+    result = root;
+    routeLayerGreedily(layer, result);
+    results.degradedLayers.emplace_back(layer);
+  }
+
+  if (config.debug) {
+    std::size_t expanded   = 0;
+    std::size_t generated  = 1;
+    std::size_t peakMemory = 0;
+    for (const auto& worker : workers) {
+      expanded += worker->expandedNodes;
+      generated += worker->generatedNodes;
+      peakMemory += worker->arena.memoryUsage() + worker->open.memoryUsage();
+    }
+    const std::chrono::duration<double> diff =
+        std::chrono::steady_clock::now() - start;
+    addLayerBenchmark(expanded, generated, result.depth, peakMemory,
+                      diff.count());
+  }
+
+  return result;
+}
+
+HeuristicMapper::Node HeuristicMapper::splitLayerAndRestart(std::size_t layer,
+                                                            bool reverse) {
+  const auto& config = results.config;
+  if (config.dataLoggingEnabled()) {
+    qc::CompoundOperation compOp{};
+    for (const auto& gate : layers.at(layer)) {
+      compOp.emplace_back(gate.op->clone());
+    }
+
+    dataLogger->logFinalizeLayer(
+        layer, compOp, getSingleQubitMultiplicity(layer),
+        getTwoQubitMultiplicity(layer), qubits, 0, 0, 0, 0, {}, {}, 0);
+    dataLogger->splitLayer();
+  }
+  splitLayer(layer, *architecture);
+  if (config.verbose) {
+    std::clog << "Split layer\n";
+  }
+  // recursively restart search with newly split layer
+  // (step to the end of the circuit, if reverse mapping is active, since
+  // the split layer is inserted in this direction, otherwise 1 layer would
+  // be skipped)
+  const auto restartLayer = reverse ? layer + 1 : layer;
+  loadRoutingLayers(restartLayer, reverse);
+  return aStarMap(restartLayer, reverse);
+}
+
+void HeuristicMapper::loadRoutingLayers(const std::size_t layer,
+                                        const bool        reverse) {
+  const auto& config = results.config;
+  if (config.layerWindow == 0) {
+    return;
+  }
+
+  // the lookahead considers the next layers containing 2Q-gates
+  std::size_t last = layer;
+  for (std::size_t i = 0; i < config.nrLookaheads; ++i) {
+    const auto next = getNextLayer(last);
+    if (next == std::numeric_limits<std::size_t>::max()) {
+      break;
+    }
+    last = next;
+  }
+  std::size_t first = layer;
+  if (reverse) {
+    for (std::size_t i = 0; i < config.nrLookaheads && first > 0;) {
+      --first;
+      if (std::any_of(layers.at(first).begin(), layers.at(first).end(),
+                      [](const Gate& gate) { return !gate.singleQubit(); })) {
+        ++i;
+      }
+    }
+  }
+  loadLayers(first, last + 1);
+}
+
+MappingResults::LayerHeuristicBenchmarkInfo&
+HeuristicMapper::addLayerBenchmark(const std::size_t expandedNodes,
+                                   const std::size_t generatedNodes,
+                                   const std::size_t solutionDepth,
+                                   const std::size_t peakMemory,
+                                   const double      seconds) {
+  auto& layerResults         = results.layerHeuristicBenchmark.emplace_back();
+  layerResults.expandedNodes = expandedNodes;
+  results.heuristicBenchmark.expandedNodes += expandedNodes;
+
+  layerResults.solutionDepth = solutionDepth;
+  layerResults.peakMemory    = peakMemory;
+  results.heuristicBenchmark.peakMemory =
+      std::max(results.heuristicBenchmark.peakMemory, peakMemory);
+
+  results.heuristicBenchmark.secondsPerNode += seconds;
+
+  layerResults.generatedNodes = generatedNodes;
+  results.heuristicBenchmark.generatedNodes += generatedNodes;
+
+  if (layerResults.expandedNodes > 0) {
+    layerResults.secondsPerNode =
+        seconds / static_cast<double>(layerResults.expandedNodes);
+    layerResults.averageBranchingFactor =
+        static_cast<double>(layerResults.generatedNodes - 1) /
+        static_cast<double>(layerResults.expandedNodes);
+  }
+
+  layerResults.effectiveBranchingFactor =
+      computeEffectiveBranchingRate(layerResults.expandedNodes + 1, solutionDepth);
+  return layerResults;
+}
+
+void HeuristicMapper::pruneSearch(NodeArena::Index& bestDoneNode,
+                                  const bool        validMapping) {
+  const auto& config = results.config;
+
+  std::vector<NodeArena::Index> keep{};
+  keep.reserve(config.memoryBoundedSearchBeamWidth + 1);
+  while (!nodes.empty() && keep.size() < config.memoryBoundedSearchBeamWidth) {
+    keep.emplace_back(nodes.top());
+    nodes.pop();
+  }
+  nodes.deleteQueue();
+  nodes.shrinkToFit();
+
+  if (validMapping) {
+    keep.emplace_back(bestDoneNode);
+  }
+  const auto newIndex = arena.compact(keep);
+  if (validMapping) {
+    bestDoneNode = newIndex.at(bestDoneNode);
+    keep.pop_back();
+  }
+  for (const auto index : keep) {
+    nodes.push(newIndex.at(index));
+  }
+}
+
+void HeuristicMapper::pushRootNode(const Node& node) {
+  NodeArena::Entry entry{};
+  entry.id                       = node.id;
+  entry.costFixed                = node.costFixed;
+  entry.costFixedReversals       = node.costFixedReversals;
+  entry.costHeur                 = node.costHeur;
+  entry.lookaheadPenalty         = node.lookaheadPenalty;
+  entry.sharedSwaps              = node.sharedSwaps;
+  entry.depth                    = node.depth;
+  entry.validMappedTwoQubitGates = node.validMappedTwoQubitGates.size();
+  entry.validMapping             = node.validMapping;
+  entry.hash                     = arena.hashMapping(node.qubits.data());
+
+  if (!nodes.push(arena.add(entry, node.qubits.data()))) {
+    arena.discardLast();
+  }
+}
 
-    layerResultsIt->effectiveBranchingFactor = computeEffectiveBranchingRate(
-        layerResultsIt->expandedNodes + 1, result.depth);
-  }
+void HeuristicMapper::restoreNode(const NodeArena::Index index,
+                                  const std::size_t layer, Node& node) {
+  restoreNodeState(arena, index, layer, node);
+  arena.collectSwaps(index, node.swaps);
+  const auto& entry = arena.at(index);
+  node.parent =
+      (entry.parent == NodeArena::NO_PARENT ? 0 : arena.at(entry.parent).id);
+}
 
-  if (config.dataLoggingEnabled()) {
-    qc::CompoundOperation compOp{};
-    for (const auto& gate : layers.at(layer)) {
-      compOp.emplace_back(gate.op->clone());
+void HeuristicMapper::restoreNodeState(const NodeArena&       nodeArena,
+                                       const NodeArena::Index index,
+                                       const std::size_t layer, Node& node) {
+  const auto& entry = nodeArena.at(index);
+
+  node.qubits.assign(architecture->getNqubits(), DEFAULT_POSITION);
+  node.locations.assign(architecture->getNqubits(), DEFAULT_POSITION);
+  const auto* mapping = nodeArena.mapping(index);
+  std::copy(mapping, mapping + nodeArena.getWidth(), node.qubits.begin());
+  for (std::size_t physQbit = 0; physQbit < nodeArena.getWidth(); ++physQbit) {
+    if (const auto logQbit = node.qubits.at(physQbit);
+        logQbit != DEFAULT_POSITION) {
+      node.locations.at(static_cast<std::size_t>(logQbit)) =
+          static_cast<std::int16_t>(physQbit);
     }
-
-    dataLogger->logFinalizeLayer(
-        layer, compOp, singleQubitMultiplicities.at(layer),
-        twoQubitMultiplicities.at(layer), qubits, result.id, result.costFixed,
-        result.costHeur, result.lookaheadPenalty, result.qubits, result.swaps,
-        result.depth);
   }
 
-  // clear nodes
-  while (!nodes.empty()) {
-    nodes.pop();
+  node.validMappedTwoQubitGates.clear();
+  const auto& view = getLayerView(layer);
+  for (std::size_t i = 0; i < view.edges.size(); ++i) {
+    const auto& edge    = view.edges[i];
+    const auto [q1, q2] = edge;
+    const auto physQ1   = static_cast<std::uint16_t>(node.locations.at(q1));
+    const auto physQ2   = static_cast<std::uint16_t>(node.locations.at(q2));
+    if (architecture->isEdgeConnected({physQ1, physQ2}, false)) {
+      node.validMappedTwoQubitGates.emplace(q1, q2);
+    }
   }
 
-  return result;
+  node.costFixed          = entry.costFixed;
+  node.costFixedReversals = entry.costFixedReversals;
+  node.costHeur           = entry.costHeur;
+  node.lookaheadPenalty   = entry.lookaheadPenalty;
+  node.sharedSwaps        = entry.sharedSwaps;
+  node.depth              = entry.depth;
+  node.id                 = entry.id;
+  node.validMapping       = entry.validMapping;
+  node.gateCosts.nSwaps   = GateCostCache::INVALID;
 }
 
-void HeuristicMapper::expandNode(Node& node, std::size_t layer) {
-  const auto&                    consideredQubits = getConsideredQubits(layer);
-  std::vector<std::vector<bool>> usedSwaps;
-  usedSwaps.reserve(architecture->getNqubits());
-  for (int p = 0; p < architecture->getNqubits(); ++p) {
-    usedSwaps.emplace_back(architecture->getNqubits());
+void HeuristicMapper::setCurrentTeleportations(CouplingMap teleportations) {
+  currentTeleportations = std::move(teleportations);
+  if (currentTeleportations.empty()) {
+    teleportationDistanceTable.reset();
+    return;
+  }
+  if (const auto it = teleportationDistanceTables.find(currentTeleportations);
+      it != teleportationDistanceTables.end()) {
+    teleportationDistanceTable = it->second;
+    return;
+  }
+  if (teleportationDistanceTables.size() >= TELEPORTATION_DISTANCE_CACHE_SIZE) {
+    teleportationDistanceTables.clear();
   }
+  teleportationDistanceTable = std::make_shared<const Matrix>(
+      architecture->createTeleportationDistanceTable(currentTeleportations));
+  teleportationDistanceTables.emplace(currentTeleportations,
+                                      teleportationDistanceTable);
+}
 
+void HeuristicMapper::expandNode(const NodeArena::Index nodeIndex, Node& node,
+                                 const std::size_t layer) {
   // set up new teleportation qubits
-  std::set<Edge> perms = architecture->getCouplingMap();
-  architecture->getCurrentTeleportations().clear();
-  architecture->getTeleportationQubits().clear();
+  CouplingMap teleportations{};
+  teleportationQubits.clear();
   for (std::size_t i = 0; i < results.config.teleportationQubits; i += 2) {
-    architecture->getTeleportationQubits().emplace_back(
+    teleportationQubits.emplace_back(
         node.locations.at(qc.getNqubits() + i),
         node.locations.at(qc.getNqubits() + i + 1));
     Edge e;
@@ -734,83 +1740,269 @@ void HeuristicMapper::expandNode(Node& node, std::size_t layer) {
         e.first  = g.second;
         e.second = static_cast<std::uint16_t>(
             node.locations.at(qc.getNqubits() + i + 1));
-        architecture->getCurrentTeleportations().insert(e);
-        perms.insert(e);
+        teleportations.insert(e);
       }
       if (g.second == node.locations.at(qc.getNqubits() + i) &&
           g.first != node.locations.at(qc.getNqubits() + i + 1)) {
         e.first  = g.first;
         e.second = static_cast<std::uint16_t>(
             node.locations.at(qc.getNqubits() + i + 1));
-        architecture->getCurrentTeleportations().insert(e);
-        perms.insert(e);
+        teleportations.insert(e);
       }
       if (g.first == node.locations.at(qc.getNqubits() + i + 1) &&
           g.second != node.locations.at(qc.getNqubits() + i)) {
         e.first = g.second;
         e.second =
             static_cast<std::uint16_t>(node.locations.at(qc.getNqubits() + i));
-        architecture->getCurrentTeleportations().insert(e);
-        perms.insert(e);
+        teleportations.insert(e);
       }
       if (g.second == node.locations.at(qc.getNqubits() + i + 1) &&
           g.first != node.locations.at(qc.getNqubits() + i)) {
         e.first = g.first;
         e.second =
             static_cast<std::uint16_t>(node.locations.at(qc.getNqubits() + i));
-        architecture->getCurrentTeleportations().insert(e);
-        perms.insert(e);
+        teleportations.insert(e);
       }
     }
   }
+  // distances of the children are looked up in the table of this set
+  setCurrentTeleportations(std::move(teleportations));
 
-  for (const auto& q : consideredQubits) {
-    for (const auto& edge : perms) {
-      if (edge.first == node.locations.at(q) ||
-          edge.second == node.locations.at(q)) {
-        const auto q1 = node.qubits.at(edge.first);
-        const auto q2 = node.qubits.at(edge.second);
-        if (q2 == -1 || q1 == -1) {
-          expandNodeAddOneSwap(edge, node, layer);
-        } else if (!usedSwaps.at(static_cast<std::size_t>(q1))
-                        .at(static_cast<std::size_t>(q2))) {
-          usedSwaps.at(static_cast<std::size_t>(q1))
-              .at(static_cast<std::size_t>(q2)) = true;
-          usedSwaps.at(static_cast<std::size_t>(q2))
-              .at(static_cast<std::size_t>(q1)) = true;
-          expandNodeAddOneSwap(edge, node, layer);
-        }
+  const bool parallel = threadPool && !results.config.dataLoggingEnabled();
+  collectExpansionCandidates(node, layer, currentTeleportations,
+                             expansionCandidates, expansionUsedSwaps);
+  if (expansionCandidates.empty()) {
+    return;
+  }
+  cacheGateCosts(layer, node);
+
+  if (parallel &&
+      expansionCandidates.size() >= PARALLEL_EXPANSION_MIN_CHILDREN) {
+    expandNodeParallel(nodeIndex, node, layer);
+    return;
+  }
+  for (const auto& edge : expansionCandidates) {
+    expandNodeAddOneSwap(edge, nodeIndex, node, layer);
+  }
+}
+
+void HeuristicMapper::collectExpansionCandidates(
+    const Node& node, const std::size_t layer, const CouplingMap& teleportations,
+    std::vector<Edge>& candidates, std::vector<QubitSet>& usedSwaps) {
+  const auto& consideredQubits = getConsideredQubits(layer);
+  usedSwaps.resize(architecture->getNqubits());
+
+  candidates.clear();
+  const auto addCandidate = [&node, &candidates, &usedSwaps](const Edge& edge) {
+    const auto q1 = node.qubits.at(edge.first);
+    const auto q2 = node.qubits.at(edge.second);
+    if (q2 == -1 || q1 == -1) {
+      candidates.emplace_back(edge);
+    } else if (!usedSwaps[static_cast<std::size_t>(q1)].test(
+                   static_cast<std::size_t>(q2))) {
+      usedSwaps[static_cast<std::size_t>(q1)].set(static_cast<std::size_t>(q2));
+      usedSwaps[static_cast<std::size_t>(q2)].set(static_cast<std::size_t>(q1));
+      candidates.emplace_back(edge);
+    }
+  };
+
+  for (std::uint16_t q = 0U; q < architecture->getNqubits(); ++q) {
+    if (!consideredQubits.test(q) ||
+        node.locations.at(q) == DEFAULT_POSITION) {
+      continue;
+    }
+    const auto physQ    = static_cast<std::uint16_t>(node.locations.at(q));
+    const auto incident = architecture->getIncidentEdges(physQ);
+    const auto* edge    = incident.begin();
+    // merge the teleportations into the incident edges, so that all exchanges
+    // are considered in the order of the ordered set of both
+    for (const auto& teleportation : teleportations) {
+      if (teleportation.first != physQ && teleportation.second != physQ) {
+        continue;
+      }
+      for (; edge != incident.end() && *edge < teleportation; ++edge) {
+        addCandidate(*edge);
       }
+      if (edge != incident.end() && *edge == teleportation) {
+        ++edge;
+      }
+      addCandidate(teleportation);
+    }
+    for (; edge != incident.end(); ++edge) {
+      addCandidate(*edge);
     }
   }
-}
 
-void HeuristicMapper::expandNodeAddOneSwap(const Edge& swap, Node& node,
-                                           const std::size_t layer) {
-  Node newNode =
-      Node(nextNodeId++, node.id, node.qubits, node.locations, node.swaps,
-           node.validMappedTwoQubitGates, node.costFixed,
-           node.costFixedReversals, node.depth + 1, node.sharedSwaps);
+  // only the bits of the collected exchanges have been set
+  for (const auto& [physQ1, physQ2] : candidates) {
+    const auto q1 = node.qubits.at(physQ1);
+    const auto q2 = node.qubits.at(physQ2);
+    if (q1 != -1 && q2 != -1) {
+      usedSwaps[static_cast<std::size_t>(q1)].reset(
+          static_cast<std::size_t>(q2));
+      usedSwaps[static_cast<std::size_t>(q2)].reset(
+          static_cast<std::size_t>(q1));
+    }
+  }
+}
 
-  if (architecture->isEdgeConnected(swap, false)) {
-    applySWAP(swap, layer, newNode);
-  } else {
-    applyTeleportation(swap, layer, newNode);
+void HeuristicMapper::expandNodeParallel(const NodeArena::Index nodeIndex,
+                                         Node&                  node,
+                                         const std::size_t      layer) {
+  // only the state modified by applying an exchange is copied, the cost
+  // contributions cached for the node are shared by all threads
+  expansionScratch.resize(threadPool->size());
+  for (auto& scratch : expansionScratch) {
+    scratch.qubits                   = node.qubits;
+    scratch.locations                = node.locations;
+    scratch.validMappedTwoQubitGates = node.validMappedTwoQubitGates;
+    scratch.swaps                    = node.swaps;
+    scratch.costFixed                = node.costFixed;
+    scratch.costFixedReversals       = node.costFixedReversals;
+    scratch.costHeur                 = node.costHeur;
+    scratch.lookaheadPenalty         = node.lookaheadPenalty;
+    scratch.sharedSwaps              = node.sharedSwaps;
+    scratch.depth                    = node.depth;
+    scratch.validMapping             = node.validMapping;
+    scratch.sharedGateCosts          = &node.cachedGateCosts();
+  }
+  expansionChildren.resize(expansionCandidates.size());
+
+  threadPool->parallelFor(
+      expansionCandidates.size(),
+      [this, nodeIndex, layer](const std::size_t thread, const std::size_t i) {
+        auto&       scratch = expansionScratch[thread];
+        const auto& swap    = expansionCandidates[i];
+        expansionChildren[i] =
+            applyExchange(arena, swap, nodeIndex, scratch, layer);
+        revertExchange(arena, swap, nodeIndex, layer, scratch);
+      });
+
+  // merge sequentially in candidate order, so that ids and tie-breaking in the
+  // priority queue are the same as in a sequential expansion
+  for (std::size_t i = 0; i < expansionCandidates.size(); ++i) {
+    const auto& swap  = expansionCandidates[i];
+    auto&       child = expansionChildren[i];
+    child.id          = nextNodeId++;
+
+    std::swap(node.qubits.at(swap.first), node.qubits.at(swap.second));
+    if (!nodes.push(arena.add(child, node.qubits.data()))) {
+      // an equivalent node with lower cost is already queued
+      arena.discardLast();
+    }
+    std::swap(node.qubits.at(swap.first), node.qubits.at(swap.second));
   }
+}
 
-  nodes.push(newNode);
+void HeuristicMapper::expandNodeAddOneSwap(const Edge&            swap,
+                                           const NodeArena::Index nodeIndex,
+                                           Node&                  node,
+                                           const std::size_t      layer) {
+  auto newNode = applyExchange(arena, swap, nodeIndex, node, layer);
+  newNode.id   = nextNodeId++;
+
+  if (!nodes.push(arena.add(newNode, node.qubits.data()))) {
+    // an equivalent node with lower cost is already queued
+    arena.discardLast();
+  }
   if (results.config.dataLoggingEnabled()) {
-    dataLogger->logSearchNode(layer, newNode.id, newNode.parent,
+    dataLogger->logSearchNode(layer, newNode.id, node.id,
                               newNode.costFixed + newNode.costFixedReversals,
                               newNode.costHeur, newNode.lookaheadPenalty,
-                              newNode.qubits, newNode.validMapping,
-                              newNode.swaps, newNode.depth);
+                              node.qubits, newNode.validMapping, node.swaps,
+                              newNode.depth);
+  }
+
+  revertExchange(arena, swap, nodeIndex, layer, node);
+}
+
+NodeArena::Entry HeuristicMapper::applyExchange(const NodeArena& nodeArena,
+                                                const Edge&      swap,
+                                                const NodeArena::Index nodeIndex,
+                                                Node&                  node,
+                                                const std::size_t      layer) {
+  // both, SWAPs and teleportations, exchange the logical qubits at the two
+  // physical qubits, which allows updating the hash of the mapping in O(1)
+  const auto hash = nodeArena.at(nodeIndex).hash ^
+                    nodeArena.hashExchange(swap.first, swap.second,
+                                           node.qubits.at(swap.first),
+                                           node.qubits.at(swap.second));
+
+  if (architecture->isEdgeConnected(swap, false)) {
+    applySWAP(swap, layer, node);
+  } else {
+    applyTeleportation(swap, layer, node);
+  }
+
+  NodeArena::Entry newNode{};
+  newNode.swap                     = node.swaps.back();
+  newNode.parent                   = nodeIndex;
+  newNode.costFixed                = node.costFixed;
+  newNode.costFixedReversals       = node.costFixedReversals;
+  newNode.costHeur                 = node.costHeur;
+  newNode.lookaheadPenalty         = node.lookaheadPenalty;
+  newNode.sharedSwaps              = node.sharedSwaps;
+  newNode.depth                    = node.depth + 1;
+  newNode.validMappedTwoQubitGates = node.validMappedTwoQubitGates.size();
+  newNode.validMapping             = node.validMapping;
+  newNode.hash                     = hash;
+  return newNode;
+}
+
+void HeuristicMapper::revertExchange(const NodeArena&       nodeArena,
+                                     const Edge&            swap,
+                                     const NodeArena::Index nodeIndex,
+                                     const std::size_t layer, Node& node) {
+  // the exchange of two qubits is its own inverse
+  const auto q1 = node.qubits.at(swap.first);
+  const auto q2 = node.qubits.at(swap.second);
+
+  node.qubits.at(swap.first)  = q2;
+  node.qubits.at(swap.second) = q1;
+
+  if (q1 != -1) {
+    node.locations.at(static_cast<std::size_t>(q1)) =
+        static_cast<std::int16_t>(swap.second);
+  }
+  if (q2 != -1) {
+    node.locations.at(static_cast<std::size_t>(q2)) =
+        static_cast<std::int16_t>(swap.first);
+  }
+
+  node.swaps.pop_back();
+
+  // restore the valid mappings of all qubit pairs affected by the exchange
+  const auto& view = getLayerView(layer);
+  for (std::size_t i = 0; i < view.edges.size(); ++i) {
+    const auto& edge    = view.edges[i];
+    const auto [q3, q4] = edge;
+    if (q3 == q1 || q3 == q2 || q4 == q1 || q4 == q2) {
+      const auto physQ3 = static_cast<std::uint16_t>(node.locations.at(q3));
+      const auto physQ4 = static_cast<std::uint16_t>(node.locations.at(q4));
+      if (architecture->isEdgeConnected({physQ3, physQ4}, false)) {
+        node.validMappedTwoQubitGates.emplace(edge);
+      } else {
+        node.validMappedTwoQubitGates.erase(edge);
+      }
+    }
   }
+
+  // the node was restored from its entry in the arena, i.e. the costs stored
+  // there are exactly the ones before the exchange
+  const auto& parent      = nodeArena.at(nodeIndex);
+  node.costFixed          = parent.costFixed;
+  node.costFixedReversals = parent.costFixedReversals;
+  node.costHeur           = parent.costHeur;
+  node.lookaheadPenalty   = parent.lookaheadPenalty;
+  node.sharedSwaps        = parent.sharedSwaps;
+  node.validMapping       = parent.validMapping;
 }
 
 void HeuristicMapper::recalculateFixedCost(std::size_t layer, Node& node) {
   node.validMappedTwoQubitGates.clear();
-  for (const auto& [edge, mult] : twoQubitMultiplicities.at(layer)) {
+  const auto& view = getLayerView(layer);
+  for (std::size_t i = 0; i < view.edges.size(); ++i) {
+    const auto& edge    = view.edges[i];
     const auto [q1, q2] = edge;
     const auto physQ1   = static_cast<std::uint16_t>(node.locations.at(q1));
     const auto physQ2   = static_cast<std::uint16_t>(node.locations.at(q2));
@@ -831,10 +2023,10 @@ void HeuristicMapper::recalculateFixedCost(std::size_t layer, Node& node) {
 
 void HeuristicMapper::recalculateFixedCostReversals(std::size_t layer,
                                                     Node&       node) {
+  const auto& view        = getLayerView(layer);
   node.costFixedReversals = 0.;
   if (architecture->bidirectional() || fidelityAwareHeur ||
-      node.validMappedTwoQubitGates.size() !=
-          twoQubitMultiplicities.at(layer).size()) {
+      node.validMappedTwoQubitGates.size() != view.edges.size()) {
     // costFixedReversals should only be non-zero in goal nodes for
     // non-fidelity-aware heuristics and if there are unidirectional
     // edges in the architecture
@@ -842,9 +2034,9 @@ void HeuristicMapper::recalculateFixedCostReversals(std::size_t layer,
   }
 
   // only consider reversal costs as fixed in goal nodes
-  for (const auto& [edge, mult] : twoQubitMultiplicities.at(layer)) {
-    const auto [q1, q2]                   = edge;
-    const auto [forwardMult, reverseMult] = mult;
+  for (std::size_t i = 0; i < view.edges.size(); ++i) {
+    const auto [q1, q2]                   = view.edges[i];
+    const auto [forwardMult, reverseMult] = view.multiplicities[i];
     const auto physQ1 = static_cast<std::uint16_t>(node.locations.at(q1));
     const auto physQ2 = static_cast<std::uint16_t>(node.locations.at(q2));
 
@@ -883,8 +2075,8 @@ void HeuristicMapper::recalculateFixedCostNonFidelity(Node& node) {
 
 void HeuristicMapper::recalculateFixedCostFidelity(std::size_t layer,
                                                    Node&       node) {
-  const auto& singleQubitGateMultiplicity = singleQubitMultiplicities.at(layer);
-  const auto& twoQubitGateMultiplicity    = twoQubitMultiplicities.at(layer);
+  const auto& singleQubitGateMultiplicity = getSingleQubitMultiplicity(layer);
+  const auto& view                        = getLayerView(layer);
 
   node.costFixed = 0;
   // adding costs of single qubit gates
@@ -907,14 +2099,15 @@ void HeuristicMapper::recalculateFixedCostFidelity(std::size_t layer,
     }
   }
   // adding cost of two qubit gates that are already mapped next to each other
-  for (const auto& [edge, mult] : twoQubitGateMultiplicity) {
+  for (std::size_t i = 0; i < view.edges.size(); ++i) {
+    const auto& edge = view.edges[i];
     if (node.validMappedTwoQubitGates.find(edge) ==
         node.validMappedTwoQubitGates.end()) {
       // 2-qubit-gates not yet validly mapped are handled in the heuristic
       continue;
     }
     const auto [q1, q2]                   = edge;
-    const auto [forwardMult, reverseMult] = mult;
+    const auto [forwardMult, reverseMult] = view.multiplicities[i];
     const auto physQ1 = static_cast<std::uint16_t>(node.locations.at(q1));
     const auto physQ2 = static_cast<std::uint16_t>(node.locations.at(q2));
 
@@ -927,7 +2120,7 @@ void HeuristicMapper::recalculateFixedCostFidelity(std::size_t layer,
 void HeuristicMapper::applySWAP(const Edge& swap, std::size_t layer,
                                 Node& node) {
   assert(architecture->isEdgeConnected(swap, false));
-  const auto& singleQubitGateMultiplicity = singleQubitMultiplicities.at(layer);
+  const auto& singleQubitGateMultiplicity = getSingleQubitMultiplicity(layer);
 
   const auto q1 = node.qubits.at(swap.first);
   const auto q2 = node.qubits.at(swap.second);
@@ -949,7 +2142,10 @@ void HeuristicMapper::applySWAP(const Edge& swap, std::size_t layer,
   node.swaps.emplace_back(swap.first, swap.second, qc::SWAP);
 
   // check if swap created or destroyed any valid mappings of qubit pairs
-  for (const auto& [edge, mult] : twoQubitMultiplicities.at(layer)) {
+  const auto& view = getLayerView(layer);
+  for (std::size_t i = 0; i < view.edges.size(); ++i) {
+    const auto& edge    = view.edges[i];
+    const auto& mult    = view.multiplicities[i];
     const auto [q3, q4] = edge;
     if (q3 == q1 || q3 == q2 || q4 == q1 || q4 == q2) {
       const auto physQ3 = static_cast<std::uint16_t>(node.locations.at(q3));
@@ -1058,7 +2254,7 @@ void HeuristicMapper::applyTeleportation(const Edge& swap, std::size_t layer,
   }
 
   std::uint16_t middleAnc = std::numeric_limits<decltype(middleAnc)>::max();
-  for (const auto& qpair : architecture->getTeleportationQubits()) {
+  for (const auto& qpair : teleportationQubits) {
     if (swap.first == qpair.first || swap.second == qpair.first) {
       middleAnc = static_cast<std::uint16_t>(qpair.second);
     } else if (swap.first == qpair.second || swap.second == qpair.second) {
@@ -1091,7 +2287,9 @@ void HeuristicMapper::applyTeleportation(const Edge& swap, std::size_t layer,
   node.costFixed += COST_TELEPORTATION;
 
   // check if swap created or destroyed any valid mappings of qubit pairs
-  for (const auto& [edge, mult] : twoQubitMultiplicities.at(layer)) {
+  const auto& view = getLayerView(layer);
+  for (std::size_t i = 0; i < view.edges.size(); ++i) {
+    const auto& edge    = view.edges[i];
     const auto [q3, q4] = edge;
     if (q3 == q1 || q3 == q2 || q4 == q1 || q4 == q2) {
       const auto physQ3 = static_cast<std::uint16_t>(node.locations.at(q3));
@@ -1115,16 +2313,13 @@ void HeuristicMapper::applyTeleportation(const Edge& swap, std::size_t layer,
 
 void HeuristicMapper::updateSharedSwaps(const Edge& swap, std::size_t layer,
                                         Node& node) {
-  const auto& consideredQubits         = getConsideredQubits(layer);
-  const auto& twoQubitGateMultiplicity = twoQubitMultiplicities.at(layer);
+  const auto& consideredQubits = getConsideredQubits(layer);
 
   const auto q1 = node.qubits.at(swap.first);
   const auto q2 = node.qubits.at(swap.second);
   if (q1 == -1 || q2 == -1 ||
-      consideredQubits.find(static_cast<std::uint16_t>(q1)) ==
-          consideredQubits.end() ||
-      consideredQubits.find(static_cast<std::uint16_t>(q2)) ==
-          consideredQubits.end()) {
+      !consideredQubits.test(static_cast<std::size_t>(q1)) ||
+      !consideredQubits.test(static_cast<std::size_t>(q2))) {
     // the given swap can only be a shared swap if both qubits are active in
     // the current layer
     return;
@@ -1134,7 +2329,7 @@ void HeuristicMapper::updateSharedSwaps(const Edge& swap, std::size_t layer,
   //        `Node::sharedSwaps` is ever used in a fidelity aware heuristic
   Edge logEdge1 = {q1, q1};
   Edge logEdge2 = {q2, q2};
-  for (const auto& [edge, multiplicity] : twoQubitGateMultiplicity) {
+  for (const auto& edge : getLayerView(layer).edges) {
     if (edge.first == q1) {
       logEdge1.second = edge.second;
     } else if (edge.second == q1) {
@@ -1174,17 +2369,17 @@ void HeuristicMapper::updateSharedSwaps(const Edge& swap, std::size_t layer,
                    architecture->fidelityDistance(physQ4, swap.first));
     } else {
       logEdge1DistanceBefore =
-          std::min(architecture->distance(swap.first, physQ3, false),
-                   architecture->distance(physQ3, swap.first, false));
+          std::min(physicalDistance(swap.first, physQ3, false),
+                   physicalDistance(physQ3, swap.first, false));
       logEdge1DistanceNew =
-          std::min(architecture->distance(swap.second, physQ3, false),
-                   architecture->distance(physQ3, swap.second, false));
+          std::min(physicalDistance(swap.second, physQ3, false),
+                   physicalDistance(physQ3, swap.second, false));
       logEdge2DistanceBefore =
-          std::min(architecture->distance(swap.second, physQ4, false),
-                   architecture->distance(physQ4, swap.second, false));
+          std::min(physicalDistance(swap.second, physQ4, false),
+                   physicalDistance(physQ4, swap.second, false));
       logEdge2DistanceNew =
-          std::min(architecture->distance(swap.first, physQ4, false),
-                   architecture->distance(physQ4, swap.first, false));
+          std::min(physicalDistance(swap.first, physQ4, false),
+                   physicalDistance(physQ4, swap.first, false));
     }
     if (logEdge1DistanceNew < logEdge1DistanceBefore &&
         logEdge2DistanceNew < logEdge2DistanceBefore) {
@@ -1196,7 +2391,7 @@ void HeuristicMapper::updateSharedSwaps(const Edge& swap, std::size_t layer,
 void HeuristicMapper::updateHeuristicCost(std::size_t layer, Node& node) {
   // the mapping is valid, only if all qubit pairs are mapped next to each other
   node.validMapping = (node.validMappedTwoQubitGates.size() ==
-                       twoQubitMultiplicities.at(layer).size());
+                       getLayerView(layer).edges.size());
 
   switch (results.config.heuristic) {
   case Heuristic::GateCountMaxDistance:
@@ -1220,41 +2415,293 @@ void HeuristicMapper::updateHeuristicCost(std::size_t layer, Node& node) {
   }
 }
 
-double HeuristicMapper::heuristicGateCountMaxDistance(std::size_t layer,
-                                                      Node&       node) {
-  if (node.validMapping) {
-    return 0.;
+void HeuristicMapper::cacheGateCosts(const std::size_t layer, Node& node) {
+  computeGateCosts(layer, node, node.gateCosts, true, true);
+  node.gateCosts.nSwaps = node.swaps.size();
+}
+
+void HeuristicMapper::computeGateCosts(const std::size_t layer,
+                                       const Node&       node,
+                                       GateCostCache&    cache,
+                                       const bool        currentLayer,
+                                       const bool        lookahead) {
+  const auto& config = results.config;
+
+  cache.gates.clear();
+  if (currentLayer) {
+    const auto& view = getLayerView(layer);
+    for (std::size_t i = 0; i < view.edges.size(); ++i) {
+      auto& gate        = cache.gates.emplace_back(heuristicGateCost(
+          layer, view.edges[i], view.multiplicities[i], node));
+      gate.edge         = view.edges[i];
+      gate.multiplicity = view.multiplicities[i];
+    }
+  }
+  cache.currentGates = cache.gates.size();
+
+  cache.lookaheadLayers.clear();
+  if (lookahead && config.lookaheadHeuristic != LookaheadHeuristic::None) {
+    auto nextLayer = getNextLayer(layer);
+    for (std::size_t i = 0; i < config.nrLookaheads &&
+                            nextLayer != std::numeric_limits<std::size_t>::max();
+         ++i) {
+      auto& lookahead     = cache.lookaheadLayers.emplace_back();
+      lookahead.layer     = nextLayer;
+      lookahead.firstGate = cache.gates.size();
+      const auto& view    = getLayerView(nextLayer);
+      for (std::size_t j = 0; j < view.edges.size(); ++j) {
+        const auto& edge  = view.edges[j];
+        auto&       gate  = cache.gates.emplace_back();
+        gate.edge         = edge;
+        gate.multiplicity = view.multiplicities[j];
+        gate.cost =
+            isFidelityAware(config.lookaheadHeuristic)
+                ? lookaheadFidelityGateCost(nextLayer, j, node)
+                : lookaheadGateCost(edge, gate.multiplicity, node);
+        // same as in `lookaheadGateCountMaxDistance`,
+        // `lookaheadGateCountSumDistance` and `lookaheadFidelityBestLocation`
+        if (config.lookaheadHeuristic ==
+            LookaheadHeuristic::GateCountMaxDistance) {
+          lookahead.penalty = std::max(lookahead.penalty, gate.cost);
+        } else {
+          lookahead.penalty += gate.cost;
+        }
+        lookahead.unmappedQubits =
+            lookahead.unmappedQubits ||
+            node.locations.at(edge.first) == DEFAULT_POSITION ||
+            node.locations.at(edge.second) == DEFAULT_POSITION;
+      }
+      lookahead.nGates = cache.gates.size() - lookahead.firstGate;
+      nextLayer        = getNextLayer(nextLayer); // TODO: consider single
+                                                  // qubits here for better
+                                                  // fidelity lookahead
+    }
   }
-  double costHeur = 0.;
 
-  for (const auto& [edge, multiplicity] : twoQubitMultiplicities.at(layer)) {
-    const auto& [q1, q2]                  = edge;
-    const auto [forwardMult, reverseMult] = multiplicity;
-    const auto physQ1 = static_cast<std::uint16_t>(node.locations.at(q1));
-    const auto physQ2 = static_cast<std::uint16_t>(node.locations.at(q2));
+  cache.qubits.clear();
+  if (currentLayer && config.heuristic == Heuristic::FidelityBestLocation) {
+    for (std::uint16_t logQbit = 0U; logQbit < architecture->getNqubits();
+         ++logQbit) {
+      cache.qubits.emplace_back(singleQubitSavings(layer, logQbit, node));
+    }
+  }
+}
+
+const HeuristicMapper::GateCostCache&
+HeuristicMapper::gateCostsFor(const std::size_t layer, const Node& node,
+                              GateCostReuse& reuse,
+                              GateCostCache& scratch, const bool lookahead) {
+  if (reuse.parentCached) {
+    return node.cachedGateCosts();
+  }
+  // e.g. the root node of a search
+  computeGateCosts(layer, node, scratch, !lookahead, lookahead);
+  reuse.allUnchanged = true;
+  return scratch;
+}
 
-    if (!architecture->bidirectional() &&
-        node.validMappedTwoQubitGates.find(edge) !=
-            node.validMappedTwoQubitGates.end()) {
+HeuristicMapper::GateCost HeuristicMapper::heuristicGateCost(
+    const std::size_t layer, const Edge& edge,
+    const std::pair<std::uint16_t, std::uint16_t>& multiplicity,
+    const Node&                                    node) const {
+  const auto& [q1, q2]                  = edge;
+  const auto [forwardMult, reverseMult] = multiplicity;
+  const auto physQ1 = static_cast<std::uint16_t>(node.locations.at(q1));
+  const auto physQ2 = static_cast<std::uint16_t>(node.locations.at(q2));
+
+  GateCost gate{};
+  gate.validlyMapped = node.validMappedTwoQubitGates.find(edge) !=
+                       node.validMappedTwoQubitGates.end();
+
+  const auto heuristic = results.config.heuristic;
+  if (heuristic == Heuristic::GateCountMaxDistance ||
+      heuristic == Heuristic::GateCountMaxDistanceOrSumDistanceMinusSharedSwaps) {
+    if (!architecture->bidirectional() && gate.validlyMapped) {
       // validly mapped 2-qubit-gates
       if (!architecture->isEdgeConnected({physQ1, physQ2})) {
-        costHeur =
-            std::max(costHeur,
-                     static_cast<double>(forwardMult * COST_DIRECTION_REVERSE));
+        gate.cost = static_cast<double>(forwardMult * COST_DIRECTION_REVERSE);
       } else if (!architecture->isEdgeConnected({physQ2, physQ1})) {
-        costHeur =
-            std::max(costHeur,
-                     static_cast<double>(reverseMult * COST_DIRECTION_REVERSE));
+        gate.cost = static_cast<double>(reverseMult * COST_DIRECTION_REVERSE);
       }
     } else {
       // not validly mapped 2-qubit-gates
       if (forwardMult > 0) {
-        costHeur = std::max(costHeur, architecture->distance(physQ1, physQ2));
+        gate.cost = std::max(gate.cost, physicalDistance(physQ1, physQ2));
       }
       if (reverseMult > 0) {
-        costHeur = std::max(costHeur, architecture->distance(physQ2, physQ1));
+        gate.cost = std::max(gate.cost, physicalDistance(physQ2, physQ1));
+      }
+    }
+  }
+
+  if (heuristic == Heuristic::GateCountSumDistance) {
+    if (!architecture->bidirectional() && gate.validlyMapped) {
+      // validly mapped 2-qubit-gates
+      if (!architecture->isEdgeConnected({physQ1, physQ2})) {
+        gate.cost = forwardMult * COST_DIRECTION_REVERSE;
+      } else if (!architecture->isEdgeConnected({physQ2, physQ1})) {
+        gate.cost = reverseMult * COST_DIRECTION_REVERSE;
       }
+    } else if (forwardMult == 0) {
+      // forwardMult == 0 && reverseMult > 0
+      gate.cost = physicalDistance(physQ2, physQ1);
+    } else if (reverseMult == 0) {
+      // forwardMult > 0 && reverseMult == 0
+      gate.cost = physicalDistance(physQ1, physQ2);
+    } else {
+      // forwardMult > 0 && reverseMult > 0
+      gate.cost = std::max(physicalDistance(physQ1, physQ2),
+                           physicalDistance(physQ2, physQ1));
+    }
+  }
+
+  if ((heuristic == Heuristic::GateCountSumDistanceMinusSharedSwaps ||
+       heuristic ==
+           Heuristic::GateCountMaxDistanceOrSumDistanceMinusSharedSwaps) &&
+      !gate.validlyMapped) {
+    if (forwardMult == 0) {
+      // forwardMult == 0 && reverseMult > 0
+      gate.swapCost = physicalDistance(physQ2, physQ1, false);
+    } else if (reverseMult == 0) {
+      // forwardMult > 0 && reverseMult == 0
+      gate.swapCost = physicalDistance(physQ1, physQ2, false);
+    } else {
+      // forwardMult > 0 && reverseMult > 0
+      gate.swapCost = std::min(physicalDistance(physQ1, physQ2, false),
+                               physicalDistance(physQ2, physQ1, false));
+    }
+  }
+
+  if (heuristic == Heuristic::FidelityBestLocation) {
+    const auto skipEdges = fidelitySkipEdges(layer);
+    const auto swapCost  = fidelityCostMemo.twoQubit(
+        skipEdges, forwardMult, reverseMult, physQ1, physQ2, [&]() {
+          return bestEdgeCost(multiplicity, skipEdges, physQ1, physQ2);
+        });
+
+    if (gate.validlyMapped) {
+      // savings potential of moving the gate to the optimal edge
+      const double currEdgeCost =
+          (forwardMult * architecture->getTwoQubitFidelityCost(physQ1, physQ2) +
+           reverseMult * architecture->getTwoQubitFidelityCost(physQ2, physQ1));
+      gate.cost = currEdgeCost - swapCost;
+    } else {
+      gate.cost = swapCost;
+    }
+  }
+
+  return gate;
+}
+
+double HeuristicMapper::bestEdgeCost(
+    const std::pair<std::uint16_t, std::uint16_t>& multiplicity,
+    const std::size_t skipEdges, const std::uint16_t physQ1,
+    const std::uint16_t physQ2) const {
+  const auto [forwardMult, reverseMult] = multiplicity;
+
+  // find the optimal edge, to which to remap the given virtual qubit
+  // pair and take the cost of moving it there via swaps plus the
+  // fidelity cost  of executing all their shared gates on that edge
+  // as the qubit pairs cost
+  double swapCost = std::numeric_limits<double>::max();
+  for (const auto& [q3, q4] : architecture->getCouplingMap()) {
+    swapCost = std::min(
+        swapCost,
+        forwardMult * architecture->getTwoQubitFidelityCost(q3, q4) +
+            reverseMult * architecture->getTwoQubitFidelityCost(q4, q3) +
+            architecture->fidelityDistance(physQ1, q3, skipEdges) +
+            architecture->fidelityDistance(physQ2, q4, skipEdges));
+    swapCost = std::min(
+        swapCost,
+        forwardMult * architecture->getTwoQubitFidelityCost(q4, q3) +
+            reverseMult * architecture->getTwoQubitFidelityCost(q3, q4) +
+            architecture->fidelityDistance(physQ2, q3, skipEdges) +
+            architecture->fidelityDistance(physQ1, q4, skipEdges));
+  }
+  return swapCost;
+}
+
+double HeuristicMapper::singleQubitSavings(const std::size_t   layer,
+                                           const std::uint16_t logQbit,
+                                           const Node&         node) const {
+  const auto& singleQubitGateMultiplicity = getSingleQubitMultiplicity(layer);
+  const auto  multiplicity = singleQubitGateMultiplicity.at(logQbit);
+  if (multiplicity == 0) {
+    return 0.;
+  }
+  const auto skipEdges = fidelitySkipEdges(layer);
+  const auto location  = static_cast<std::uint16_t>(node.locations.at(logQbit));
+  return fidelityCostMemo.singleQubit(
+      skipEdges, multiplicity, location, [&]() {
+        return bestQubitSavings(multiplicity, skipEdges, location);
+      });
+}
+
+double HeuristicMapper::bestQubitSavings(const std::uint16_t multiplicity,
+                                         const std::size_t   skipEdges,
+                                         const std::uint16_t location) const {
+  double       qbitSavings  = 0;
+  const double currFidelity = architecture->getSingleQubitFidelityCost(location);
+  for (std::uint16_t physQbit = 0U; physQbit < architecture->getNqubits();
+       ++physQbit) {
+    if (architecture->getSingleQubitFidelityCost(physQbit) >= currFidelity) {
+      continue;
+    }
+    const double curSavings =
+        multiplicity * (currFidelity -
+                        architecture->getSingleQubitFidelityCost(physQbit)) -
+        architecture->fidelityDistance(location, physQbit, skipEdges);
+    qbitSavings = std::max(qbitSavings, curSavings);
+  }
+  return qbitSavings;
+}
+
+void HeuristicMapper::resetFidelityCostMemo() {
+  // splitting layers only ever lowers the multiplicities
+  std::uint16_t maxForward = 0;
+  std::uint16_t maxReverse = 0;
+  std::uint16_t maxSingle  = 0;
+  for (std::size_t layer = 0; layer < layers.size(); ++layer) {
+    loadLayers(layer, layer + 1);
+    for (const auto& [forwardMult, reverseMult] :
+         getLayerView(layer).multiplicities) {
+      maxForward = std::max(maxForward, forwardMult);
+      maxReverse = std::max(maxReverse, reverseMult);
     }
+    for (const auto multiplicity : getSingleQubitMultiplicity(layer)) {
+      maxSingle = std::max(maxSingle, multiplicity);
+    }
+  }
+  fidelityCostMemo.reset(architecture->getNqubits(),
+                         architecture->getFidelityDistanceTables().size(),
+                         maxForward, maxReverse, maxSingle);
+}
+
+std::size_t HeuristicMapper::fidelitySkipEdges(const std::size_t layer) const {
+  // as many edges may be skipped as other qubits could move towards the gate
+  // (beyond the number of fidelity distance tables, distances are 0 anyway)
+  const auto consideredQubits = getConsideredQubits(layer).count();
+  return std::min(consideredQubits - 1,
+                  architecture->getFidelityDistanceTables().size());
+}
+
+double HeuristicMapper::heuristicGateCountMaxDistance(std::size_t layer,
+                                                      Node&       node) {
+  if (node.validMapping) {
+    return 0.;
+  }
+  GateCostReuse reuse(node);
+  GateCostCache scratch{};
+  const auto&   cache    = gateCostsFor(layer, node, reuse, scratch, false);
+  double        costHeur = 0.;
+
+  for (std::size_t i = 0; i < cache.currentGates; ++i) {
+    const auto& gate = cache.gates[i];
+    const auto  cost =
+        reuse.unchanged(gate.edge)
+             ? gate.cost
+             : heuristicGateCost(layer, gate.edge, gate.multiplicity, node).cost;
+    costHeur = std::max(costHeur, cost);
   }
 
   return costHeur;
@@ -1265,40 +2712,17 @@ double HeuristicMapper::heuristicGateCountSumDistance(std::size_t layer,
   if (node.validMapping) {
     return 0.;
   }
-  double costHeur = 0.;
-
-  for (const auto& [edge, multiplicity] : twoQubitMultiplicities.at(layer)) {
-    const auto& [q1, q2]                  = edge;
-    const auto [forwardMult, reverseMult] = multiplicity;
-    const auto physQ1 = static_cast<std::uint16_t>(node.locations.at(q1));
-    const auto physQ2 = static_cast<std::uint16_t>(node.locations.at(q2));
+  GateCostReuse reuse(node);
+  GateCostCache scratch{};
+  const auto&   cache    = gateCostsFor(layer, node, reuse, scratch, false);
+  double        costHeur = 0.;
 
-    if (!architecture->bidirectional() &&
-        node.validMappedTwoQubitGates.find(edge) !=
-            node.validMappedTwoQubitGates.end()) {
-      // validly mapped 2-qubit-gates
-      if (!architecture->isEdgeConnected({physQ1, physQ2})) {
-        costHeur += forwardMult * COST_DIRECTION_REVERSE;
-      } else if (!architecture->isEdgeConnected({physQ2, physQ1})) {
-        costHeur += reverseMult * COST_DIRECTION_REVERSE;
-      }
-    } else {
-      // not validly mapped 2-qubit-gates
-      double swapCost = 0.;
-
-      if (forwardMult == 0) {
-        // forwardMult == 0 && reverseMult > 0
-        swapCost = architecture->distance(physQ2, physQ1);
-      } else if (reverseMult == 0) {
-        // forwardMult > 0 && reverseMult == 0
-        swapCost = architecture->distance(physQ1, physQ2);
-      } else {
-        // forwardMult > 0 && reverseMult > 0
-        swapCost = std::max(architecture->distance(physQ1, physQ2),
-                            architecture->distance(physQ2, physQ1));
-      }
-      costHeur += swapCost;
-    }
+  for (std::size_t i = 0; i < cache.currentGates; ++i) {
+    const auto& gate = cache.gates[i];
+    costHeur +=
+        reuse.unchanged(gate.edge)
+            ? gate.cost
+            : heuristicGateCost(layer, gate.edge, gate.multiplicity, node).cost;
   }
 
   return costHeur;
@@ -1309,17 +2733,21 @@ double HeuristicMapper::heuristicGateCountSumDistanceMinusSharedSwaps(
   if (node.validMapping) {
     return 0.;
   }
-  const auto& twoQubitGateMultiplicity = twoQubitMultiplicities.at(layer);
-  double      costHeur                 = 0.;
-  double      costReversals            = 0.;
+  GateCostReuse reuse(node);
+  GateCostCache scratch{};
+  const auto& cache = gateCostsFor(layer, node, reuse, scratch, false);
+  double      costHeur      = 0.;
+  double      costReversals = 0.;
   std::vector<std::size_t> nSwaps{};
-  nSwaps.reserve(twoQubitGateMultiplicity.size());
+  nSwaps.reserve(cache.currentGates);
 
-  for (const auto& [edge, multiplicity] : twoQubitGateMultiplicity) {
-    const auto& [q1, q2]                  = edge;
-    const auto [forwardMult, reverseMult] = multiplicity;
-    const auto physQ1 = static_cast<std::uint16_t>(node.locations.at(q1));
-    const auto physQ2 = static_cast<std::uint16_t>(node.locations.at(q2));
+  for (std::size_t i = 0; i < cache.currentGates; ++i) {
+    const auto& cached = cache.gates[i];
+    const auto [forwardMult, reverseMult] = cached.multiplicity;
+    const auto gate =
+        reuse.unchanged(cached.edge)
+            ? cached
+            : heuristicGateCost(layer, cached.edge, cached.multiplicity, node);
 
     if (architecture->unidirectional()) {
       // only for purely unidirectional architectures is it certain that at
@@ -1328,33 +2756,20 @@ double HeuristicMapper::heuristicGateCountSumDistanceMinusSharedSwaps(
           std::min(forwardMult, reverseMult) * COST_DIRECTION_REVERSE;
     }
 
-    if (node.validMappedTwoQubitGates.find(edge) !=
-        node.validMappedTwoQubitGates.end()) {
+    if (gate.validlyMapped) {
       // validly mapped 2-qubit-gates
       continue;
     }
 
-    double swapCost = 0.;
-    if (forwardMult == 0) {
-      // forwardMult == 0 && reverseMult > 0
-      swapCost = architecture->distance(physQ2, physQ1, false);
-    } else if (reverseMult == 0) {
-      // forwardMult > 0 && reverseMult == 0
-      swapCost = architecture->distance(physQ1, physQ2, false);
-    } else {
-      // forwardMult > 0 && reverseMult > 0
-      swapCost = std::min(architecture->distance(physQ1, physQ2, false),
-                          architecture->distance(physQ2, physQ1, false));
-    }
-    costHeur += swapCost;
+    costHeur += gate.swapCost;
 
     // infer maximum number of swaps in this distance
     if (architecture->unidirectional()) {
       nSwaps.emplace_back(
-          static_cast<std::size_t>(swapCost / COST_UNIDIRECTIONAL_SWAP));
+          static_cast<std::size_t>(gate.swapCost / COST_UNIDIRECTIONAL_SWAP));
     } else {
       nSwaps.emplace_back(
-          static_cast<std::size_t>(swapCost / COST_BIDIRECTIONAL_SWAP));
+          static_cast<std::size_t>(gate.swapCost / COST_BIDIRECTIONAL_SWAP));
     }
   }
 
@@ -1402,9 +2817,10 @@ HeuristicMapper::heuristicGateCountMaxDistanceOrSumDistanceMinusSharedSwaps(
 
 double HeuristicMapper::heuristicFidelityBestLocation(std::size_t layer,
                                                       Node&       node) {
-  const auto& consideredQubits            = getConsideredQubits(layer);
-  const auto& singleQubitGateMultiplicity = singleQubitMultiplicities.at(layer);
-  const auto& twoQubitGateMultiplicity    = twoQubitMultiplicities.at(layer);
+  const auto& singleQubitGateMultiplicity = getSingleQubitMultiplicity(layer);
+  GateCostReuse reuse(node);
+  GateCostCache scratch{};
+  const auto&   cache = gateCostsFor(layer, node, reuse, scratch, false);
 
   double costHeur = 0.;
 
@@ -1416,78 +2832,23 @@ double HeuristicMapper::heuristicFidelityBestLocation(std::size_t layer,
     if (singleQubitGateMultiplicity.at(logQbit) == 0) {
       continue;
     }
-    double       qbitSavings  = 0;
-    const double currFidelity = architecture->getSingleQubitFidelityCost(
-        static_cast<std::uint16_t>(node.locations.at(logQbit)));
-    for (std::uint16_t physQbit = 0U; physQbit < architecture->getNqubits();
-         ++physQbit) {
-      if (architecture->getSingleQubitFidelityCost(physQbit) >= currFidelity) {
-        continue;
-      }
-      const double curSavings =
-          singleQubitGateMultiplicity.at(logQbit) *
-              (currFidelity -
-               architecture->getSingleQubitFidelityCost(physQbit)) -
-          architecture->fidelityDistance(
-              static_cast<std::uint16_t>(node.locations.at(logQbit)), physQbit,
-              consideredQubits.size() - 1);
-      qbitSavings = std::max(qbitSavings, curSavings);
-    }
-    savingsPotential += qbitSavings;
+    savingsPotential += reuse.unchanged(logQbit)
+                            ? cache.qubits[logQbit]
+                            : singleQubitSavings(layer, logQbit, node);
   }
 
   // iterating over all virtual qubit pairs, that share a gate on the
   // current layer
-  for (const auto& [edge, mult] : twoQubitGateMultiplicity) {
-    const auto [q1, q2]                   = edge;
-    const auto [forwardMult, reverseMult] = mult;
-
-    const bool edgeDone = (node.validMappedTwoQubitGates.find(edge) !=
-                               node.validMappedTwoQubitGates.end() ||
-                           node.validMappedTwoQubitGates.find({q1, q2}) !=
-                               node.validMappedTwoQubitGates.end());
-
-    // find the optimal edge, to which to remap the given virtual qubit
-    // pair and take the cost of moving it there via swaps plus the
-    // fidelity cost  of executing all their shared gates on that edge
-    // as the qubit pairs cost
-    double swapCost = std::numeric_limits<double>::max();
-    for (const auto& [q3, q4] : architecture->getCouplingMap()) {
-      swapCost = std::min(
-          swapCost,
-          forwardMult * architecture->getTwoQubitFidelityCost(q3, q4) +
-              reverseMult * architecture->getTwoQubitFidelityCost(q4, q3) +
-              architecture->fidelityDistance(
-                  static_cast<std::uint16_t>(node.locations.at(q1)), q3,
-                  consideredQubits.size() - 1) +
-              architecture->fidelityDistance(
-                  static_cast<std::uint16_t>(node.locations.at(q2)), q4,
-                  consideredQubits.size() - 1));
-      swapCost = std::min(
-          swapCost,
-          forwardMult * architecture->getTwoQubitFidelityCost(q4, q3) +
-              reverseMult * architecture->getTwoQubitFidelityCost(q3, q4) +
-              architecture->fidelityDistance(
-                  static_cast<std::uint16_t>(node.locations.at(q2)), q3,
-                  consideredQubits.size() - 1) +
-              architecture->fidelityDistance(
-                  static_cast<std::uint16_t>(node.locations.at(q1)), q4,
-                  consideredQubits.size() - 1));
-    }
-
-    if (edgeDone) {
-      const double currEdgeCost =
-          (forwardMult *
-               architecture->getTwoQubitFidelityCost(
-                   static_cast<std::uint16_t>(node.locations.at(q1)),
-                   static_cast<std::uint16_t>(node.locations.at(q2))) +
-           reverseMult *
-               architecture->getTwoQubitFidelityCost(
-                   static_cast<std::uint16_t>(node.locations.at(q2)),
-                   static_cast<std::uint16_t>(node.locations.at(q1))));
-      savingsPotential += (currEdgeCost - swapCost);
+  for (std::size_t i = 0; i < cache.currentGates; ++i) {
+    const auto& cached = cache.gates[i];
+    const auto  gate =
+        reuse.unchanged(cached.edge)
+             ? cached
+             : heuristicGateCost(layer, cached.edge, cached.multiplicity, node);
+    if (gate.validlyMapped) {
+      savingsPotential += gate.cost;
     } else {
-      costHeur += swapCost;
+      costHeur += gate.cost;
     }
   }
 
@@ -1498,156 +2859,171 @@ void HeuristicMapper::updateLookaheadPenalty(const std::size_t      layer,
                                              HeuristicMapper::Node& node) {
   const auto& config    = results.config;
   node.lookaheadPenalty = 0.;
-  auto   nextLayer      = getNextLayer(layer);
-  double factor         = config.firstLookaheadFactor;
-
-  for (std::size_t i = 0; i < config.nrLookaheads; ++i) {
-    if (nextLayer == std::numeric_limits<std::size_t>::max()) {
-      break;
-    }
-
-    double penalty = 0.;
-    switch (config.lookaheadHeuristic) {
-    case LookaheadHeuristic::GateCountMaxDistance:
-      penalty = lookaheadGateCountMaxDistance(nextLayer, node);
-      break;
-    case LookaheadHeuristic::GateCountSumDistance:
-      penalty = lookaheadGateCountSumDistance(nextLayer, node);
-      break;
-    default:
-      break;
-    }
-
+  if (config.lookaheadHeuristic == LookaheadHeuristic::None) {
+    return;
+  }
+  double factor = config.firstLookaheadFactor;
+
+  GateCostReuse reuse(node);
+  GateCostCache scratch{};
+  const auto&   cache = gateCostsFor(layer, node, reuse, scratch, true);
+  for (const auto& lookahead : cache.lookaheadLayers) {
+    // layers not acting on the exchanged qubits keep their penalty
+    const auto penalty =
+        reuse.unchangedLookahead(lookahead,
+                                 getLayerView(lookahead.layer)
+                                     .activeQubits2QGates)
+            ? lookahead.penalty
+            : lookaheadLayerPenalty(lookahead, cache, reuse, node);
     node.lookaheadPenalty += factor * penalty;
     factor *= config.lookaheadFactor;
-    nextLayer = getNextLayer(nextLayer); // TODO: consider single qubits here
-                                         // for better fidelity lookahead
   }
 }
 
-double
-HeuristicMapper::lookaheadGateCountMaxDistance(const std::size_t      layer,
-                                               HeuristicMapper::Node& node) {
-  double penalty = 0.;
+double HeuristicMapper::lookaheadLayerPenalty(
+    const GateCostCache::LookaheadLayer& lookahead, const GateCostCache& cache,
+    const GateCostReuse& reuse, const Node& node) const {
+  switch (results.config.lookaheadHeuristic) {
+  case LookaheadHeuristic::GateCountMaxDistance:
+    return lookaheadGateCountMaxDistance(lookahead, cache, reuse, node);
+  case LookaheadHeuristic::GateCountSumDistance:
+    return lookaheadGateCountSumDistance(lookahead, cache, reuse, node);
+  case LookaheadHeuristic::FidelityBestLocation:
+    return lookaheadFidelityBestLocation(lookahead, cache, reuse, node);
+  default:
+    return 0.;
+  }
+}
 
-  for (const auto& [edge, multiplicity] : twoQubitMultiplicities.at(layer)) {
-    const auto& [q1, q2]                  = edge;
-    const auto [forwardMult, reverseMult] = multiplicity;
-
-    const auto loc1 = node.locations.at(q1);
-    const auto loc2 = node.locations.at(q2);
-    if (loc1 == DEFAULT_POSITION && loc2 == DEFAULT_POSITION) {
-      // no penalty
-    } else if (loc1 == DEFAULT_POSITION) {
-      auto min = std::numeric_limits<double>::max();
-      for (std::uint16_t j = 0; j < architecture->getNqubits(); ++j) {
-        if (node.qubits.at(j) == DEFAULT_POSITION) {
-          // TODO: Consider fidelity here if available
-          if (forwardMult > 0) {
-            min = std::min(min, architecture->distance(
-                                    j, static_cast<std::uint16_t>(loc2)));
-          }
-          if (reverseMult > 0) {
-            min = std::min(min, architecture->distance(
-                                    static_cast<std::uint16_t>(loc2), j));
-          }
+double HeuristicMapper::lookaheadGateCost(
+    const Edge& edge, const std::pair<std::uint16_t, std::uint16_t>& multiplicity,
+    const Node& node) const {
+  const auto& [q1, q2]                  = edge;
+  const auto [forwardMult, reverseMult] = multiplicity;
+
+  const auto loc1 = node.locations.at(q1);
+  const auto loc2 = node.locations.at(q2);
+  if (loc1 == DEFAULT_POSITION && loc2 == DEFAULT_POSITION) {
+    // no penalty
+    return 0.;
+  }
+  if (loc1 == DEFAULT_POSITION) {
+    auto min = std::numeric_limits<double>::max();
+    for (std::uint16_t j = 0; j < architecture->getNqubits(); ++j) {
+      if (node.qubits.at(j) == DEFAULT_POSITION) {
+        // TODO: Consider fidelity here if available
+        if (forwardMult > 0) {
+          min = std::min(min, physicalDistance(
+                                  j, static_cast<std::uint16_t>(loc2)));
         }
-      }
-      penalty = std::max(penalty, min);
-    } else if (loc2 == DEFAULT_POSITION) {
-      auto min = std::numeric_limits<double>::max();
-      for (std::uint16_t j = 0; j < architecture->getNqubits(); ++j) {
-        if (node.qubits.at(j) == DEFAULT_POSITION) {
-          // TODO: Consider fidelity here if available
-          if (forwardMult > 0) {
-            min = std::min(min, architecture->distance(
-                                    static_cast<std::uint16_t>(loc1), j));
-          }
-          if (reverseMult > 0) {
-            min = std::min(min, architecture->distance(
-                                    j, static_cast<std::uint16_t>(loc1)));
-          }
+        if (reverseMult > 0) {
+          min = std::min(min, physicalDistance(
+                                  static_cast<std::uint16_t>(loc2), j));
         }
       }
-      penalty = std::max(penalty, min);
-    } else {
-      double cost = std::numeric_limits<double>::max();
-      if (forwardMult > 0) {
-        cost = std::min(
-            cost, architecture->distance(static_cast<std::uint16_t>(loc1),
-                                         static_cast<std::uint16_t>(loc2)));
-      }
-      if (reverseMult > 0) {
-        cost = std::min(
-            cost, architecture->distance(static_cast<std::uint16_t>(loc2),
-                                         static_cast<std::uint16_t>(loc1)));
+    }
+    return min;
+  }
+  if (loc2 == DEFAULT_POSITION) {
+    auto min = std::numeric_limits<double>::max();
+    for (std::uint16_t j = 0; j < architecture->getNqubits(); ++j) {
+      if (node.qubits.at(j) == DEFAULT_POSITION) {
+        // TODO: Consider fidelity here if available
+        if (forwardMult > 0) {
+          min = std::min(min, physicalDistance(
+                                  static_cast<std::uint16_t>(loc1), j));
+        }
+        if (reverseMult > 0) {
+          min = std::min(min, physicalDistance(
+                                  j, static_cast<std::uint16_t>(loc1)));
+        }
       }
-      penalty = std::max(penalty, cost);
     }
+    return min;
+  }
+  double cost = std::numeric_limits<double>::max();
+  if (forwardMult > 0) {
+    cost = std::min(cost, physicalDistance(static_cast<std::uint16_t>(loc1),
+                                           static_cast<std::uint16_t>(loc2)));
+  }
+  if (reverseMult > 0) {
+    cost = std::min(cost, physicalDistance(static_cast<std::uint16_t>(loc2),
+                                           static_cast<std::uint16_t>(loc1)));
+  }
+  return cost;
+}
+
+double HeuristicMapper::lookaheadFidelityGateCost(const std::size_t layer,
+                                                  const std::size_t gate,
+                                                  const Node& node) const {
+  const auto& view                      = getLayerView(layer);
+  const auto& [q1, q2]                  = view.edges.at(gate);
+  const auto [forwardMult, reverseMult] = view.multiplicities.at(gate);
+  const auto bestEdgeCost               = view.bestEdgeCosts.at(gate);
+
+  const auto loc1 = node.locations.at(q1);
+  const auto loc2 = node.locations.at(q2);
+  if (loc1 == DEFAULT_POSITION || loc2 == DEFAULT_POSITION) {
+    // an unmapped qubit may still be placed at the best edge
+    return bestEdgeCost;
+  }
+  const auto physQ1 = static_cast<std::uint16_t>(loc1);
+  const auto physQ2 = static_cast<std::uint16_t>(loc2);
+  if (architecture->isEdgeConnected({physQ1, physQ2}, false)) {
+    return forwardMult * architecture->getTwoQubitFidelityCost(physQ1, physQ2) +
+           reverseMult * architecture->getTwoQubitFidelityCost(physQ2, physQ1);
+  }
+  // the qubits only have to be moved next to each other, i.e. the last edge
+  // of the path between them is skipped
+  return bestEdgeCost + architecture->fidelityDistance(physQ1, physQ2, 1);
+}
+
+double HeuristicMapper::lookaheadGateCountMaxDistance(
+    const GateCostCache::LookaheadLayer& lookahead, const GateCostCache& cache,
+    const GateCostReuse& reuse, const Node& node) const {
+  double penalty = 0.;
+
+  for (std::size_t i = lookahead.firstGate;
+       i < lookahead.firstGate + lookahead.nGates; ++i) {
+    const auto& gate = cache.gates[i];
+    penalty          = std::max(
+        penalty, reuse.unchangedLookahead(gate.edge, node)
+                              ? gate.cost
+                              : lookaheadGateCost(gate.edge, gate.multiplicity,
+                                                  node));
   }
 
   return penalty;
 }
 
-double
-HeuristicMapper::lookaheadGateCountSumDistance(const std::size_t      layer,
-                                               HeuristicMapper::Node& node) {
+double HeuristicMapper::lookaheadGateCountSumDistance(
+    const GateCostCache::LookaheadLayer& lookahead, const GateCostCache& cache,
+    const GateCostReuse& reuse, const Node& node) const {
   double penalty = 0.;
 
-  for (const auto& [edge, multiplicity] : twoQubitMultiplicities.at(layer)) {
-    const auto& [q1, q2]                  = edge;
-    const auto [forwardMult, reverseMult] = multiplicity;
-
-    const auto loc1 = node.locations.at(q1);
-    const auto loc2 = node.locations.at(q2);
-    if (loc1 == DEFAULT_POSITION && loc2 == DEFAULT_POSITION) {
-      // no penalty
-    } else if (loc1 == DEFAULT_POSITION) {
-      auto min = std::numeric_limits<double>::max();
-      for (std::uint16_t j = 0; j < architecture->getNqubits(); ++j) {
-        if (node.qubits.at(j) == DEFAULT_POSITION) {
-          // TODO: Consider fidelity here if available
-          if (forwardMult > 0) {
-            min = std::min(min, architecture->distance(
-                                    j, static_cast<std::uint16_t>(loc2)));
-          }
-          if (reverseMult > 0) {
-            min = std::min(min, architecture->distance(
-                                    static_cast<std::uint16_t>(loc2), j));
-          }
-        }
-      }
-      penalty += min;
-    } else if (loc2 == DEFAULT_POSITION) {
-      auto min = std::numeric_limits<double>::max();
-      for (std::uint16_t j = 0; j < architecture->getNqubits(); ++j) {
-        if (node.qubits.at(j) == DEFAULT_POSITION) {
-          // TODO: Consider fidelity here if available
-          if (forwardMult > 0) {
-            min = std::min(min, architecture->distance(
-                                    static_cast<std::uint16_t>(loc1), j));
-          }
-          if (reverseMult > 0) {
-            min = std::min(min, architecture->distance(
-                                    j, static_cast<std::uint16_t>(loc1)));
-          }
-        }
-      }
-      penalty += min;
-    } else {
-      double cost = std::numeric_limits<double>::max();
-      if (forwardMult > 0) {
-        cost = std::min(
-            cost, architecture->distance(static_cast<std::uint16_t>(loc1),
-                                         static_cast<std::uint16_t>(loc2)));
-      }
-      if (reverseMult > 0) {
-        cost = std::min(
-            cost, architecture->distance(static_cast<std::uint16_t>(loc2),
-                                         static_cast<std::uint16_t>(loc1)));
-      }
-      penalty += cost;
-    }
+  for (std::size_t i = lookahead.firstGate;
+       i < lookahead.firstGate + lookahead.nGates; ++i) {
+    const auto& gate = cache.gates[i];
+    penalty += reuse.unchangedLookahead(gate.edge, node)
+                   ? gate.cost
+                   : lookaheadGateCost(gate.edge, gate.multiplicity, node);
+  }
+
+  return penalty;
+}
+
+double HeuristicMapper::lookaheadFidelityBestLocation(
+    const GateCostCache::LookaheadLayer& lookahead, const GateCostCache& cache,
+    const GateCostReuse& reuse, const Node& node) const {
+  double penalty = 0.;
+
+  for (std::size_t i = lookahead.firstGate;
+       i < lookahead.firstGate + lookahead.nGates; ++i) {
+    const auto& gate = cache.gates[i];
+    penalty += reuse.unchangedLookahead(gate.edge, node)
+                   ? gate.cost
+                   : lookaheadFidelityGateCost(lookahead.layer,
+                                               i - lookahead.firstGate, node);
   }
 
   return penalty;
@@ -0,0 +1,483 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "heuristic/LayoutEmbedding.hpp"
+
+#include "Mapper.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+LayoutEmbedding::LayoutEmbedding(const Architecture& arch,
+                                 const std::uint16_t nLogical,
+                                 const bool          fidelityAware)
+    : architecture(arch), nqubits(arch.getNqubits()), nlogical(nLogical),
+      fidelity(fidelityAware), interactions(nLogical),
+      singleWeights(nLogical, 0.), neighbors(arch.getNqubits()) {
+  for (std::uint16_t q = 0; q < nqubits; ++q) {
+    for (const auto& [q1, q2] : architecture.getIncidentEdges(q)) {
+      const auto other = (q1 == q) ? q2 : q1;
+      if (std::find(neighbors[q].begin(), neighbors[q].end(), other) ==
+          neighbors[q].end()) {
+        neighbors[q].emplace_back(other);
+      }
+    }
+  }
+
+  // gates on qubits which are not connected at all are assigned a cost larger
+  // than that of any connected positions
+  double maxCost = 0.;
+  for (std::uint16_t q1 = 0; q1 < nqubits; ++q1) {
+    for (std::uint16_t q2 = 0; q2 < nqubits; ++q2) {
+      const auto cost =
+          fidelity ? architecture.fidelityDistance(q1, q2)
+                   : architecture.getDistanceTable()(q1, q2);
+      if (isFinite(cost)) {
+        maxCost = std::max(maxCost, cost);
+      }
+    }
+  }
+  unreachableCost = 2 * maxCost + COST_UNIDIRECTIONAL_SWAP;
+
+  if (fidelity) {
+    // the edge to which a pair of qubits is best moved to execute a gate there
+    meetingEdges.resize(static_cast<std::size_t>(nqubits) * nqubits);
+    for (std::uint16_t q1 = 0; q1 < nqubits; ++q1) {
+      for (std::uint16_t q2 = 0; q2 < nqubits; ++q2) {
+        double best = std::numeric_limits<double>::max();
+        for (const auto& [q3, q4] : architecture.getCouplingMap()) {
+          const auto cost = moveCost(q1, q3) + moveCost(q2, q4) +
+                            architecture.getTwoQubitFidelityCost(q3, q4);
+          if (cost < best) {
+            best                            = cost;
+            meetingEdges[q1 * nqubits + q2] = {q3, q4};
+          }
+        }
+      }
+    }
+  }
+}
+
+bool LayoutEmbedding::isFinite(const double cost) {
+  return cost >= 0. && cost < std::numeric_limits<double>::max() / 4;
+}
+
+double LayoutEmbedding::moveCost(const std::uint16_t from,
+                                 const std::uint16_t to) const {
+  const auto cost = architecture.fidelityDistance(from, to);
+  return isFinite(cost) ? cost : unreachableCost;
+}
+
+void LayoutEmbedding::addTwoQubitGates(
+    const Edge&                                    edge,
+    const std::pair<std::uint16_t, std::uint16_t>& multiplicity,
+    const double                                   weight) {
+  const auto& [q1, q2]                  = edge;
+  const auto [forwardMult, reverseMult] = multiplicity;
+  const auto forward                    = weight * forwardMult;
+  const auto reverse                    = weight * reverseMult;
+
+  auto add = [this](const std::uint16_t from, const std::uint16_t to,
+                    const double fwd, const double rev) {
+    auto& list = interactions.at(from);
+    auto  it   = std::find_if(list.begin(), list.end(),
+                              [to](const Interaction& interaction) {
+                                return interaction.partner == to;
+                              });
+    if (it == list.end()) {
+      list.emplace_back(Interaction{to, fwd, rev});
+    } else {
+      it->forward += fwd;
+      it->reverse += rev;
+    }
+  };
+  add(q1, q2, forward, reverse);
+  add(q2, q1, reverse, forward);
+}
+
+void LayoutEmbedding::addSingleQubitGates(const std::uint16_t logQbit,
+                                          const std::uint16_t multiplicity,
+                                          const double        weight) {
+  if (fidelity) {
+    singleWeights.at(logQbit) += weight * multiplicity;
+  }
+}
+
+double LayoutEmbedding::pairCost(const Interaction&  interaction,
+                                 const std::uint16_t physQ1,
+                                 const std::uint16_t physQ2) const {
+  if (!fidelity) {
+    const auto& distances = architecture.getDistanceTable();
+    auto        distance  = [this, &distances](const std::uint16_t from,
+                                           const std::uint16_t to) {
+      const auto cost = distances(from, to);
+      return isFinite(cost) ? cost : unreachableCost;
+    };
+    return interaction.forward * distance(physQ1, physQ2) +
+           interaction.reverse * distance(physQ2, physQ1);
+  }
+
+  // cost of moving the qubits to the given edge and executing the gates there
+  auto costAt = [this, &interaction, physQ1,
+                 physQ2](const std::uint16_t q3, const std::uint16_t q4) {
+    return moveCost(physQ1, q3) + moveCost(physQ2, q4) +
+           interaction.forward * architecture.getTwoQubitFidelityCost(q3, q4) +
+           interaction.reverse * architecture.getTwoQubitFidelityCost(q4, q3);
+  };
+  const auto& [q3, q4] = meetingEdges[physQ1 * nqubits + physQ2];
+  const auto& [q5, q6] = meetingEdges[physQ2 * nqubits + physQ1];
+  auto cost            = std::min(costAt(q3, q4), costAt(q6, q5));
+  if (architecture.isEdgeConnected({physQ1, physQ2}, false)) {
+    cost = std::min(cost, costAt(physQ1, physQ2));
+  }
+  return cost;
+}
+
+double LayoutEmbedding::singleCost(const std::uint16_t logQbit,
+                                   const std::uint16_t physQbit) const {
+  if (singleWeights[logQbit] == 0.) {
+    return 0.;
+  }
+  return singleWeights[logQbit] *
+         architecture.getSingleQubitFidelityCost(physQbit);
+}
+
+double LayoutEmbedding::qubitCost(const std::uint16_t logQbit) const {
+  const auto physQbit = static_cast<std::uint16_t>(locations[logQbit]);
+  double     cost     = singleCost(logQbit, physQbit);
+  for (const auto& interaction : interactions[logQbit]) {
+    const auto partnerLocation = locations[interaction.partner];
+    if (partnerLocation != DEFAULT_POSITION) {
+      cost += pairCost(interaction, physQbit,
+                       static_cast<std::uint16_t>(partnerLocation));
+    }
+  }
+  return cost;
+}
+
+double LayoutEmbedding::layoutCost() const {
+  double cost = 0.;
+  for (const auto logQbit : order) {
+    const auto physQbit = static_cast<std::uint16_t>(locations[logQbit]);
+    cost += singleCost(logQbit, physQbit);
+    for (const auto& interaction : interactions[logQbit]) {
+      // each pair is counted once
+      if (interaction.partner > logQbit) {
+        cost += pairCost(interaction, physQbit,
+                         static_cast<std::uint16_t>(
+                             locations[interaction.partner]));
+      }
+    }
+  }
+  return cost;
+}
+
+void LayoutEmbedding::orderQubits() {
+  order.clear();
+  std::vector<double> totalWeights(nlogical, 0.);
+  std::vector<double> placedWeights(nlogical, 0.);
+  std::vector<bool>   ordered(nlogical, false);
+  std::size_t         nInteracting = 0;
+  for (std::uint16_t q = 0; q < nlogical; ++q) {
+    for (const auto& interaction : interactions[q]) {
+      totalWeights[q] += interaction.forward + interaction.reverse;
+    }
+    if (!interactions[q].empty()) {
+      ++nInteracting;
+    }
+  }
+
+  // interacting qubits: always continue with the qubit that interacts most
+  // with the qubits ordered so far (starting a new component of the
+  // interaction graph with its heaviest qubit)
+  while (order.size() < nInteracting) {
+    std::optional<std::uint16_t> next{};
+    for (std::uint16_t q = 0; q < nlogical; ++q) {
+      if (ordered[q] || interactions[q].empty()) {
+        continue;
+      }
+      if (!next.has_value() || placedWeights[q] > placedWeights[*next] ||
+          (placedWeights[q] == placedWeights[*next] &&
+           totalWeights[q] > totalWeights[*next])) {
+        next = q;
+      }
+    }
+    ordered[*next] = true;
+    order.emplace_back(*next);
+    for (const auto& interaction : interactions[*next]) {
+      placedWeights[interaction.partner] +=
+          interaction.forward + interaction.reverse;
+    }
+  }
+
+  // qubits with only 1Q-gates
+  for (std::uint16_t q = 0; q < nlogical; ++q) {
+    if (!ordered[q] && singleWeights[q] > 0.) {
+      order.emplace_back(q);
+    }
+  }
+}
+
+void LayoutEmbedding::computeRemainingBounds() {
+  std::vector<std::size_t> positions(nlogical, order.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    positions[order[i]] = i;
+  }
+  remainingBounds.assign(order.size() + 1, 0.);
+  for (std::size_t i = order.size(); i-- > 0;) {
+    const auto logQbit = order[i];
+    double     bound   = std::numeric_limits<double>::max();
+    for (std::uint16_t physQbit = 0; physQbit < nqubits; ++physQbit) {
+      bound = std::min(bound, singleCost(logQbit, physQbit));
+    }
+    for (const auto& interaction : interactions[logQbit]) {
+      if (positions[interaction.partner] > i) {
+        // counted once the partner is placed
+        continue;
+      }
+      double pairBound = std::numeric_limits<double>::max();
+      for (const auto& [q1, q2] : architecture.getCouplingMap()) {
+        pairBound = std::min({pairBound, pairCost(interaction, q1, q2),
+                              pairCost(interaction, q2, q1)});
+      }
+      bound += pairBound;
+    }
+    remainingBounds[i] = remainingBounds[i + 1] + bound;
+  }
+}
+
+void LayoutEmbedding::place(const std::uint16_t logQbit,
+                            const std::uint16_t physQbit) {
+  locations[logQbit] = static_cast<std::int16_t>(physQbit);
+  qubits[physQbit]   = static_cast<std::int16_t>(logQbit);
+}
+
+void LayoutEmbedding::unplace(const std::uint16_t logQbit) {
+  qubits[static_cast<std::uint16_t>(locations[logQbit])] = DEFAULT_POSITION;
+  locations[logQbit]                                     = DEFAULT_POSITION;
+}
+
+void LayoutEmbedding::greedyLayout() {
+  for (const auto logQbit : order) {
+    std::optional<std::uint16_t> best{};
+    double                       bestPlacementCost = 0.;
+    for (std::uint16_t physQbit = 0; physQbit < nqubits; ++physQbit) {
+      if (qubits[physQbit] != DEFAULT_POSITION) {
+        continue;
+      }
+      place(logQbit, physQbit);
+      const auto cost = qubitCost(logQbit);
+      unplace(logQbit);
+      // ties are broken in favor of better connected physical qubits, which
+      // leave more room for the partners placed later
+      if (!best.has_value() || cost < bestPlacementCost ||
+          (cost == bestPlacementCost &&
+           neighbors[physQbit].size() > neighbors[*best].size())) {
+        best              = physQbit;
+        bestPlacementCost = cost;
+      }
+    }
+    if (!best.has_value()) {
+      // no free physical qubits left
+      return;
+    }
+    place(logQbit, *best);
+  }
+}
+
+void LayoutEmbedding::localSearch() {
+  bool improved = true;
+  while (improved && !deadlineExpired()) {
+    improved = false;
+    for (const auto logQbit : order) {
+      for (std::uint16_t physQbit = 0; physQbit < nqubits; ++physQbit) {
+        const auto from  = static_cast<std::uint16_t>(locations[logQbit]);
+        const auto other = qubits[physQbit];
+        if (physQbit == from || other == static_cast<std::int16_t>(nlogical)) {
+          // not a move, or the physical qubit is occupied
+          continue;
+        }
+
+        // cost of the affected qubits before and after the move (interactions
+        // between the two qubits are counted twice in both cases)
+        double before = qubitCost(logQbit);
+        if (other != DEFAULT_POSITION) {
+          before += qubitCost(static_cast<std::uint16_t>(other));
+        }
+        unplace(logQbit);
+        if (other != DEFAULT_POSITION) {
+          unplace(static_cast<std::uint16_t>(other));
+          place(static_cast<std::uint16_t>(other), from);
+        }
+        place(logQbit, physQbit);
+        double after = qubitCost(logQbit);
+        if (other != DEFAULT_POSITION) {
+          after += qubitCost(static_cast<std::uint16_t>(other));
+        }
+
+        if (after < before - 1e-9) {
+          improved = true;
+          continue;
+        }
+        // revert the move
+        unplace(logQbit);
+        if (other != DEFAULT_POSITION) {
+          unplace(static_cast<std::uint16_t>(other));
+          place(static_cast<std::uint16_t>(other), physQbit);
+        }
+        place(logQbit, from);
+      }
+      if (deadlineExpired()) {
+        return;
+      }
+    }
+  }
+}
+
+void LayoutEmbedding::isomorphismSearch(const std::size_t index,
+                                        const double      cost) {
+  if (cost + remainingBounds[index] >= bestCost ||
+      (++searchNodes % DEADLINE_CHECK_INTERVAL == 0 && deadlineExpired()) ||
+      expired) {
+    return;
+  }
+  if (index == order.size()) {
+    bestCost      = cost;
+    bestLocations = locations;
+    isomorphism   = true;
+    return;
+  }
+
+  const auto logQbit = order[index];
+  if (interactions[logQbit].empty()) {
+    // qubits with only 1Q-gates are placed at their cheapest position
+    std::optional<std::uint16_t> best{};
+    for (std::uint16_t physQbit = 0; physQbit < nqubits; ++physQbit) {
+      if (qubits[physQbit] == DEFAULT_POSITION &&
+          (!best.has_value() ||
+           singleCost(logQbit, physQbit) < singleCost(logQbit, *best))) {
+        best = physQbit;
+      }
+    }
+    if (best.has_value()) {
+      place(logQbit, *best);
+      isomorphismSearch(index + 1, cost + singleCost(logQbit, *best));
+      unplace(logQbit);
+    }
+    return;
+  }
+
+  // the qubit has to be placed next to all its placed partners, i.e. next to
+  // any one of them (if there is none, it starts a new component)
+  std::optional<std::uint16_t> anchor{};
+  for (const auto& interaction : interactions[logQbit]) {
+    if (locations[interaction.partner] != DEFAULT_POSITION) {
+      anchor = static_cast<std::uint16_t>(locations[interaction.partner]);
+      break;
+    }
+  }
+  std::vector<std::pair<double, std::uint16_t>> candidates{};
+  auto consider = [&](const std::uint16_t physQbit) {
+    if (qubits[physQbit] != DEFAULT_POSITION ||
+        neighbors[physQbit].size() < interactions[logQbit].size()) {
+      return;
+    }
+    for (const auto& interaction : interactions[logQbit]) {
+      const auto partnerLocation = locations[interaction.partner];
+      if (partnerLocation != DEFAULT_POSITION &&
+          !architecture.isEdgeConnected(
+              {physQbit, static_cast<std::uint16_t>(partnerLocation)},
+              false)) {
+        return;
+      }
+    }
+    place(logQbit, physQbit);
+    candidates.emplace_back(qubitCost(logQbit), physQbit);
+    unplace(logQbit);
+  };
+  if (anchor.has_value()) {
+    for (const auto physQbit : neighbors[*anchor]) {
+      consider(physQbit);
+    }
+  } else {
+    for (std::uint16_t physQbit = 0; physQbit < nqubits; ++physQbit) {
+      consider(physQbit);
+    }
+  }
+  std::stable_sort(
+      candidates.begin(), candidates.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  for (const auto& [placementCost, physQbit] : candidates) {
+    if (cost + placementCost + remainingBounds[index + 1] >= bestCost) {
+      // the remaining candidates are at least as expensive
+      return;
+    }
+    place(logQbit, physQbit);
+    isomorphismSearch(index + 1, cost + placementCost);
+    unplace(logQbit);
+    if (expired) {
+      return;
+    }
+  }
+}
+
+bool LayoutEmbedding::deadlineExpired() {
+  if (!expired && std::chrono::steady_clock::now() >= deadline) {
+    expired = true;
+  }
+  return expired;
+}
+
+std::vector<std::int16_t>
+LayoutEmbedding::embed(const std::vector<bool>&                    occupied,
+                       const std::chrono::steady_clock::time_point until) {
+  deadline    = until;
+  expired     = false;
+  searchNodes = 0;
+  isomorphism = false;
+  locations.assign(nlogical, DEFAULT_POSITION);
+  qubits.assign(nqubits, DEFAULT_POSITION);
+  for (std::uint16_t physQbit = 0; physQbit < nqubits; ++physQbit) {
+    if (physQbit < occupied.size() && occupied[physQbit]) {
+      // marks the qubit as used without assigning it to a logical qubit
+      qubits[physQbit] = static_cast<std::int16_t>(nlogical);
+    }
+  }
+
+  orderQubits();
+  computeRemainingBounds();
+  greedyLayout();
+  if (std::any_of(order.begin(), order.end(), [this](const auto logQbit) {
+        return locations[logQbit] == DEFAULT_POSITION;
+      })) {
+    // more qubits than free physical qubits
+    bestLocations = locations;
+    bestCost      = std::numeric_limits<double>::max();
+    return bestLocations;
+  }
+  localSearch();
+  bestLocations = locations;
+  bestCost      = layoutCost();
+  isomorphism   = std::all_of(order.begin(), order.end(), [this](const auto q) {
+    return std::all_of(
+        interactions[q].begin(), interactions[q].end(),
+        [this, q](const Interaction& interaction) {
+          return architecture.isEdgeConnected(
+              {static_cast<std::uint16_t>(locations[q]),
+               static_cast<std::uint16_t>(locations[interaction.partner])},
+              false);
+        });
+  });
+
+  if (bestCost > remainingBounds.front()) {
+    for (const auto logQbit : order) {
+      unplace(logQbit);
+    }
+    isomorphismSearch(0, 0.);
+  }
+  return bestLocations;
+}
@@ -0,0 +1,240 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "heuristic/PortfolioMapper.hpp"
+
+#include "heuristic/SabreMapper.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+/**
+ * @brief state of one configuration of the portfolio
+ */
+struct Run {
+  Architecture                     architecture{};
+  std::unique_ptr<HeuristicMapper> mapper{};
+  std::thread                      thread{};
+  /** set by the thread of the run once `map` has returned (guarded by the
+   * mutex of the portfolio) */
+  bool done = false;
+  /** whether the result of the run has already been compared to the best one
+   */
+  bool evaluated = false;
+};
+} // namespace
+
+std::vector<Configuration>
+PortfolioMapper::portfolioFor(const Configuration& config) {
+  if (!config.portfolio.empty()) {
+    return config.portfolio;
+  }
+
+  auto base   = config;
+  base.method = Method::Heuristic;
+
+  std::vector<Heuristic> heuristics{config.heuristic};
+  if (!isFidelityAware(config.heuristic)) {
+    for (const auto heuristic :
+         {Heuristic::GateCountMaxDistance,
+          Heuristic::GateCountSumDistanceMinusSharedSwaps}) {
+      if (heuristic != config.heuristic) {
+        heuristics.emplace_back(heuristic);
+      }
+    }
+  }
+
+  std::vector<Configuration> portfolio{};
+  for (const auto heuristic : heuristics) {
+    auto& member     = portfolio.emplace_back(base);
+    member.heuristic = heuristic;
+  }
+  if (!config.iterativeBidirectionalRouting) {
+    auto& member                               = portfolio.emplace_back(base);
+    member.iterativeBidirectionalRouting       = true;
+    member.iterativeBidirectionalRoutingPasses = DEFAULT_BIDIRECTIONAL_PASSES;
+  }
+  return portfolio;
+}
+
+bool PortfolioMapper::isBetter(const MappingResults& a, const MappingResults& b,
+                               const bool fidelityObjective) {
+  if (fidelityObjective &&
+      std::abs(a.output.totalLogFidelity - b.output.totalLogFidelity) >
+          FIDELITY_TOLERANCE) {
+    // the log fidelity is the negative logarithm of the fidelity
+    return a.output.totalLogFidelity < b.output.totalLogFidelity;
+  }
+  const auto exchangesA = a.output.swaps + a.output.teleportations;
+  const auto exchangesB = b.output.swaps + b.output.teleportations;
+  if (exchangesA != exchangesB) {
+    return exchangesA < exchangesB;
+  }
+  return a.output.gates < b.output.gates;
+}
+
+void PortfolioMapper::map(const Configuration& config) {
+  results                  = MappingResults{};
+  results.config           = config;
+  results.config.portfolio = portfolioFor(config);
+  const auto& members      = results.config.portfolio;
+  for (const auto& member : members) {
+    if (member.method != Method::Heuristic && member.method != Method::Sabre) {
+      throw QMAPException("Portfolio mapper only supports configurations "
+                          "using the heuristic or SABRE method!");
+    }
+    if (member.dataLoggingEnabled()) {
+      throw QMAPException("Data logging is not supported for the portfolio "
+                          "mapper!");
+    }
+  }
+  // runs can only be cancelled early when comparing exchanges, since the
+  // exchanges committed by a run are no lower bound on its fidelity cost
+  const bool fidelityObjective = isFidelityAware(config.heuristic);
+
+  const auto start = std::chrono::steady_clock::now();
+
+  results.portfolio.resize(members.size());
+  std::vector<Run>        runs(members.size());
+  std::mutex              mutex;
+  std::condition_variable runFinished;
+  for (std::size_t i = 0; i < runs.size(); ++i) {
+    auto& run        = runs[i];
+    run.architecture = *architecture;
+    if (members[i].method == Method::Sabre) {
+      run.mapper = std::make_unique<SabreMapper>(qc, run.architecture);
+    } else {
+      run.mapper = std::make_unique<HeuristicMapper>(qc, run.architecture);
+    }
+  }
+  for (std::size_t i = 0; i < runs.size(); ++i) {
+    runs[i].thread = std::thread([&, i]() {
+      // only accessed by this thread until it is done
+      auto& info = results.portfolio[i];
+      // each run gets the rest of the shared budget as its own deadline, so
+      // it returns a (possibly degraded) result in time on its own
+      auto       member    = members[i];
+      const auto used      = static_cast<std::size_t>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - start)
+              .count());
+      const auto remaining = config.timeout - std::min(config.timeout, used);
+      member.timeout       = std::min(member.timeout, remaining);
+      try {
+        runs[i].mapper->map(member);
+        info.status = "finished";
+      } catch (const std::exception& e) {
+        if (runs[i].mapper->exceededExchangeLimit()) {
+          info.status = "cancelled";
+        } else {
+          info.status = "failed";
+          info.error  = e.what();
+        }
+      }
+      const std::chrono::duration<double> diff =
+          std::chrono::steady_clock::now() - start;
+      info.time = diff.count();
+      {
+        const std::lock_guard<std::mutex> lock(mutex);
+        runs[i].done = true;
+      }
+      runFinished.notify_one();
+    });
+  }
+
+  // index of the best finished run (`runs.size()` if there is none)
+  std::size_t best = runs.size();
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    std::size_t                  evaluated = 0;
+    while (evaluated < runs.size()) {
+      runFinished.wait(lock, [&]() {
+        return std::any_of(runs.cbegin(), runs.cend(), [](const Run& run) {
+          return run.done && !run.evaluated;
+        });
+      });
+
+      bool improved = false;
+      for (std::size_t i = 0; i < runs.size(); ++i) {
+        auto& run = runs[i];
+        if (!run.done || run.evaluated) {
+          continue;
+        }
+        run.evaluated = true;
+        ++evaluated;
+        if (results.portfolio[i].status == "finished" &&
+            (best == runs.size() ||
+             isBetter(run.mapper->getResults(),
+                      runs[best].mapper->getResults(), fidelityObjective))) {
+          best     = i;
+          improved = true;
+        }
+      }
+
+      // the remaining runs stop themselves once they are beaten
+      if (improved && !fidelityObjective) {
+        const auto& output = runs[best].mapper->getResults().output;
+        for (auto& run : runs) {
+          if (!run.done) {
+            run.mapper->limitExchanges(output.swaps + output.teleportations);
+          }
+        }
+      }
+    }
+  }
+  for (auto& run : runs) {
+    run.thread.join();
+  }
+
+  // the winner is determined in the order of the portfolio (instead of the
+  // order in which the runs finished) to be independent of the timing
+  best = runs.size();
+  for (std::size_t i = 0; i < runs.size(); ++i) {
+    auto& info = results.portfolio[i];
+    if (info.status != "finished") {
+      continue;
+    }
+    const auto& output    = runs[i].mapper->getResults().output;
+    info.swaps            = output.swaps;
+    info.teleportations   = output.teleportations;
+    info.gates            = output.gates;
+    info.totalLogFidelity = output.totalLogFidelity;
+    info.timeout          = runs[i].mapper->getResults().timeout;
+    if (best == runs.size() ||
+        isBetter(runs[i].mapper->getResults(),
+                 runs[best].mapper->getResults(), fidelityObjective)) {
+      best = i;
+    }
+  }
+  if (best == runs.size()) {
+    for (const auto& info : results.portfolio) {
+      if (info.status == "failed") {
+        throw QMAPException("No configuration of the portfolio succeeded: " +
+                            info.error);
+      }
+    }
+    throw QMAPException("No configuration of the portfolio finished!");
+  }
+
+  auto& winner = *runs[best].mapper;
+  qcMapped     = std::move(winner.getMappedCircuit());
+
+  auto info         = std::move(results.portfolio);
+  auto settings     = std::move(results.config);
+  results           = winner.getResults();
+  results.config    = std::move(settings);
+  results.portfolio = std::move(info);
+
+  results.portfolio[best].selected = true;
+
+  const std::chrono::duration<double> diff =
+      std::chrono::steady_clock::now() - start;
+  results.time = diff.count();
+}
@@ -0,0 +1,203 @@
+//
+// This file is part of the MQT QMAP library released under the MIT license.
+// See README.md or go to https://github.com/cda-tum/qmap for more information.
+//
+
+#include "heuristic/SabreMapper.hpp"
+
+void SabreMapper::checkParameters() {
+  HeuristicMapper::checkParameters();
+  const auto& config = results.config;
+  if (config.teleportationQubits > 0) {
+    throw QMAPException("Teleportation is not yet supported for the SABRE "
+                        "router!");
+  }
+  if (config.dataLoggingEnabled()) {
+    throw QMAPException("Data logging is not supported for the SABRE router!");
+  }
+  if (config.iterativeBidirectionalRoutingChains > 1) {
+    throw QMAPException("Iterative bidirectional routing with several chains "
+                        "is not supported for the SABRE router!");
+  }
+}
+
+HeuristicMapper::Node SabreMapper::aStarMap(const std::size_t layer,
+                                            const bool        reverse) {
+  const auto& config = results.config;
+  checkCancelled();
+  const auto start = std::chrono::steady_clock::now();
+
+  Node node{};
+  node.locations = locations;
+  node.qubits    = qubits;
+  mapUnmappedGates(layer, node, true);
+  locations = node.locations;
+  qubits    = node.qubits;
+
+  const auto& front       = getLayerView(layer).edges;
+  const auto& distances   = architecture->getDistanceTable(false);
+  const auto  physicalLoc = [&node](const std::uint16_t logical) {
+    return static_cast<std::uint16_t>(node.locations.at(logical));
+  };
+  const auto frontDistance = [&front, &distances, &physicalLoc]() {
+    double distance = 0.;
+    for (const auto& [q1, q2] : front) {
+      distance += distances(physicalLoc(q1), physicalLoc(q2));
+    }
+    return distance;
+  };
+
+  collectExtendedSet(layer, reverse, node);
+  decay.assign(architecture->getNqubits(), 1.);
+
+  std::size_t steps     = 0;
+  std::size_t evaluated = 0;
+  std::size_t stalled   = 0;
+  double      best      = frontDistance();
+  while (true) {
+    candidates.clear();
+    for (const auto& [q1, q2] : front) {
+      const auto p1 = physicalLoc(q1);
+      const auto p2 = physicalLoc(q2);
+      if (architecture->isEdgeConnected({p1, p2}, false)) {
+        continue;
+      }
+      for (const auto p : {p1, p2}) {
+        for (const auto& edge : architecture->getIncidentEdges(p)) {
+          const Edge swap{std::min(edge.first, edge.second),
+                          std::max(edge.first, edge.second)};
+          if (std::find(candidates.begin(), candidates.end(), swap) ==
+              candidates.end()) {
+            candidates.emplace_back(swap);
+          }
+        }
+      }
+    }
+    if (candidates.empty()) {
+      // all gates of the layer are routed
+      break;
+    }
+
+    if (stalled >= architecture->getNqubits()) {
+      // the greedy selection is stuck in a cycle
+      if (front.size() > 1) {
+        return splitLayerAndRestart(layer, reverse);
+      }
+      routeLayerGreedily(layer, node);
+      break;
+    }
+
+    // ties are broken by the order of the candidates
+    auto   bestSwap  = candidates.front();
+    double bestScore = std::numeric_limits<double>::max();
+    for (const auto& swap : candidates) {
+      const auto score = swapScore(layer, node, swap) *
+                         std::max(decay.at(swap.first), decay.at(swap.second));
+      if (score < bestScore) {
+        bestScore = score;
+        bestSwap  = swap;
+      }
+    }
+    evaluated += candidates.size();
+
+    applySwap(node, bestSwap);
+    decay.at(bestSwap.first) += DECAY_INCREMENT;
+    decay.at(bestSwap.second) += DECAY_INCREMENT;
+    if (++steps % DECAY_RESET == 0) {
+      std::fill(decay.begin(), decay.end(), 1.);
+    }
+
+    const auto distance = frontDistance();
+    if (distance < best) {
+      best    = distance;
+      stalled = 0;
+    } else {
+      ++stalled;
+    }
+  }
+  node.depth = node.swaps.size();
+
+  if (config.debug) {
+    const std::chrono::duration<double> diff =
+        std::chrono::steady_clock::now() - start;
+    addLayerBenchmark(steps, evaluated + 1, node.depth, 0, diff.count());
+  }
+  return node;
+}
+
+void SabreMapper::collectExtendedSet(const std::size_t layer,
+                                     const bool reverse, const Node& node) {
+  const auto& config = results.config;
+  extendedSet.clear();
+  if (config.lookaheadHeuristic == LookaheadHeuristic::None) {
+    return;
+  }
+
+  double      weight = config.firstLookaheadFactor;
+  std::size_t next   = layer;
+  for (std::size_t i = 0; i < config.nrLookaheads; ++i) {
+    // skip layers without 2Q-gates
+    do {
+      if (reverse ? next == 0 : next + 1 >= layers.size()) {
+        return;
+      }
+      next = reverse ? next - 1 : next + 1;
+    } while (getLayerView(next).edges.empty());
+
+    for (const auto& gate : getLayerView(next).edges) {
+      // qubits which are not mapped yet are placed once they are needed
+      if (node.locations.at(gate.first) != DEFAULT_POSITION &&
+          node.locations.at(gate.second) != DEFAULT_POSITION) {
+        extendedSet.emplace_back(gate, weight);
+      }
+    }
+    weight *= config.lookaheadFactor;
+  }
+}
+
+double SabreMapper::swapScore(const std::size_t layer, const Node& node,
+                              const Edge& swap) const {
+  const auto& distances = architecture->getDistanceTable(false);
+  const auto  moved     = [&node, &swap](const std::uint16_t logical) {
+    const auto physical = static_cast<std::uint16_t>(node.locations.at(logical));
+    if (physical == swap.first) {
+      return swap.second;
+    }
+    if (physical == swap.second) {
+      return swap.first;
+    }
+    return physical;
+  };
+
+  const auto& front     = getLayerView(layer).edges;
+  double      frontCost = 0.;
+  for (const auto& [q1, q2] : front) {
+    frontCost += distances(moved(q1), moved(q2));
+  }
+  auto score = frontCost / static_cast<double>(front.size());
+
+  if (!extendedSet.empty()) {
+    double extendedCost = 0.;
+    for (const auto& [gate, weight] : extendedSet) {
+      extendedCost += weight * distances(moved(gate.first), moved(gate.second));
+    }
+    score += extendedCost / static_cast<double>(extendedSet.size());
+  }
+  return score;
+}
+
+void SabreMapper::applySwap(Node& node, const Edge& swap) {
+  const auto q1               = node.qubits.at(swap.first);
+  const auto q2               = node.qubits.at(swap.second);
+  node.qubits.at(swap.first)  = q2;
+  node.qubits.at(swap.second) = q1;
+  if (q1 != DEFAULT_POSITION) {
+    node.locations.at(static_cast<std::size_t>(q1)) =
+        static_cast<std::int16_t>(swap.second);
+  }
+  if (q2 != DEFAULT_POSITION) {
+    node.locations.at(static_cast<std::size_t>(q2)) =
+        static_cast<std::int16_t>(swap.first);
+  }
+  node.swaps.emplace_back(swap.first, swap.second, qc::SWAP);
+}
@@ -29,6 +29,7 @@ from .pyqmap import (
     LookaheadHeuristic,
     MappingResults,
     Method,
+    SearchEngine,
     SwapReduction,
     map,
 )
@@ -90,6 +91,17 @@ def compile(  # noqa: A001
     verbose: bool = False,
     debug: bool = False,
     visualizer: SearchVisualizer | None = None,
+    *,
+    memory_bounded_search_budget: int | None = None,
+    memory_bounded_search_beam_width: int = 1000,
+    n_threads: int = 1,
+    search_engine: str | SearchEngine = "astar",
+    warm_start_search: bool = False,
+    iterative_bidirectional_routing_chains: int = 1,
+    portfolio: list[Configuration] | None = None,
+    timeout: int | None = None,
+    initial_layout_timeout: int = 1000,
+    layer_window: int = 0,
 ) -> tuple[QuantumCircuit, MappingResults]:
     """Interface to the MQT QMAP tool for mapping quantum circuits.
 
@@ -97,15 +109,15 @@ def compile(  # noqa: A001
         circ: The circuit to map.
         arch: The architecture to map to.
         calibration: The calibration to use.
-        method: The mapping method to use. Either "heuristic" or "exact". Defaults to "heuristic".
+        method: The mapping method to use. Either "heuristic", "exact", "portfolio" (racing several heuristic configurations and keeping the best result) or "sabre" (greedy routing in linear time, using the lookahead settings for its extended set). Defaults to "heuristic".
         heuristic: The heuristic function to use for the routing search. Defaults to "gate_count_max_distance".
-        initial_layout: The initial layout to use. Defaults to "dynamic".
+        initial_layout: The initial layout to use. "graph_isomorphism" embeds the interaction graph of the circuit into the coupling graph (scored by the fidelity data for fidelity-aware heuristics). Defaults to "dynamic".
         iterative_bidirectional_routing_passes: Number of iterative bidirectional routing passes to perform or None to disable. Defaults to None.
         layering: The layering strategy to use. Defaults to "individual_gates".
         automatic_layer_splits_node_limit: The number of expanded nodes after which to split a layer or None to disable automatic layer splitting. Defaults to 5000.
         early_termination: The early termination strategy to use, i.e. terminating the search after a goal node has been found, but before it is guarantueed to be optimal. Defaults to "none".
         early_termination_limit: The number of nodes (counted according to the early termination strategy) after which to terminate the search early. Defaults to 0.
-        lookahead_heuristic: The heuristic function to use as a lookahead penalty during search or None to disable lookahead. Defaults to "gate_count_max_distance".
+        lookahead_heuristic: The heuristic function to use as a lookahead penalty during search or None to disable lookahead. Fidelity-aware heuristics require "fidelity_best_location" (or None). Defaults to "gate_count_max_distance".
         lookaheads: The number of lookaheads to be used or None if no lookahead should be used. Defaults to 15.
         lookahead_factor: The rate at which the contribution of future layers to the lookahead decreases. Defaults to 0.5.
         encoding: The encoding to use for the AMO and exactly one constraints. Defaults to "naive".
@@ -125,6 +137,16 @@ def compile(  # noqa: A001
         verbose: Print more detailed information during the mapping process. Defaults to False.
         debug: Gather additional information during the mapping process (e.g. number of generated nodes, branching factors, ...). Defaults to False.
         visualizer: A SearchVisualizer object to log the search process to. Defaults to None.
+        memory_bounded_search_budget: The memory (in bytes) the search nodes of a layer may use before the search is pruned to the best nodes (turning it into a beam search) or None to disable memory-bounded search. Defaults to None.
+        memory_bounded_search_beam_width: The number of nodes kept when pruning the search in memory-bounded search. Defaults to 1000.
+        n_threads: The number of threads used to expand search nodes in the heuristic mapper (0 to use all available hardware threads). The result does not depend on the number of threads. Defaults to 1.
+        search_engine: The search engine used by the heuristic mapper. "hash_distributed_astar" distributes the search nodes themselves among n_threads workers, which scales to more threads, but may yield a different mapping of equal cost. Defaults to "astar".
+        warm_start_search: Keep the current mapping without searching for layers whose gates it already satisfies (instead of searching for swaps that only improve the lookahead or fidelity), which speeds up circuits with many layers. Defaults to False.
+        iterative_bidirectional_routing_chains: Number of independent chains of iterative bidirectional routing passes, each starting from a different initial layout and running concurrently on n_threads threads. A chain stops early once its estimated swap count stops improving and the best layout of all chains is used. Defaults to 1.
+        portfolio: The configurations (each using the heuristic or sabre method) raced against each other by the portfolio method or None to race variants of the given settings using different heuristics and iterative bidirectional routing. Defaults to None.
+        timeout: The timeout (in ms) of the exact method, the wall-clock budget shared by all configurations of the portfolio method, and the deadline of the heuristic method, after which the remaining layers are routed with the best solution found so far or greedily along shortest paths (see MappingResults.degraded_layers), or None to use the default of 60 minutes. Defaults to None.
+        initial_layout_timeout: The time budget (in ms) of the embedding search of the "graph_isomorphism" initial layout. Defaults to 1000.
+        layer_window: The number of layers whose gate multiplicities are held at a time by the heuristic and sabre methods (around the layer being routed and its lookahead) or 0 to create them for all layers up front. Bounds the memory needed for the layers of huge circuits. Defaults to 0.
 
     Returns:
         The mapped circuit and the mapping results.
@@ -143,17 +165,33 @@ def compile(  # noqa: A001
     config.method = Method(method)
     config.heuristic = Heuristic(heuristic)
     config.initial_layout = InitialLayout(initial_layout)
+    config.initial_layout_timeout = initial_layout_timeout
     if iterative_bidirectional_routing_passes is None:
         config.iterative_bidirectional_routing = False
     else:
         config.iterative_bidirectional_routing = True
         config.iterative_bidirectional_routing_passes = iterative_bidirectional_routing_passes
+        config.iterative_bidirectional_routing_chains = iterative_bidirectional_routing_chains
+    if portfolio is not None:
+        config.portfolio = portfolio
+    if timeout is not None:
+        config.timeout = timeout
     config.layering = Layering(layering)
     if automatic_layer_splits_node_limit is None:
         config.automatic_layer_splits = False
     else:
         config.automatic_layer_splits = True
         config.automatic_layer_splits_node_limit = automatic_layer_splits_node_limit
+    if memory_bounded_search_budget is None:
+        config.memory_bounded_search = False
+    else:
+        config.memory_bounded_search = True
+        config.memory_bounded_search_budget = memory_bounded_search_budget
+        config.memory_bounded_search_beam_width = memory_bounded_search_beam_width
+    config.warm_start_search = warm_start_search
+    config.layer_window = layer_window
+    config.n_threads = n_threads
+    config.search_engine = SearchEngine(search_engine)
     config.early_termination = EarlyTermination(early_termination)
     config.early_termination_limit = early_termination_limit
     config.encoding = Encoding(encoding)
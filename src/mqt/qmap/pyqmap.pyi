@@ -56,6 +56,7 @@ class Architecture:
     name: str
     num_qubits: int
     properties: Architecture.Properties
+    table_threads: int
 
     @overload
     def __init__(self) -> None: ...
@@ -73,6 +74,11 @@ class Architecture:
     def load_properties(self, properties: Architecture.Properties) -> None: ...
     @overload
     def load_properties(self, properties: str) -> None: ...
+    def update_properties(self, properties: Architecture.Properties) -> None: ...
+    @staticmethod
+    def set_table_cache_directory(directory: str) -> None: ...
+    @staticmethod
+    def get_table_cache_directory() -> str: ...
 
 class CircuitInfo:
     cnots: int
@@ -124,11 +130,20 @@ class Configuration:
     first_lookahead_factor: float
     include_WCNF: bool  # noqa: N815
     initial_layout: InitialLayout
+    initial_layout_timeout: int
     iterative_bidirectional_routing: bool
     iterative_bidirectional_routing_passes: int
+    iterative_bidirectional_routing_chains: int
     layering: Layering
     automatic_layer_splits: bool
     automatic_layer_splits_node_limit: int
+    memory_bounded_search: bool
+    memory_bounded_search_budget: int
+    memory_bounded_search_beam_width: int
+    warm_start_search: bool
+    layer_window: int
+    n_threads: int
+    search_engine: SearchEngine
     early_termination: EarlyTermination
     early_termination_limit: int
     lookahead_heuristic: LookaheadHeuristic
@@ -144,6 +159,7 @@ class Configuration:
     teleportation_qubits: int
     teleportation_seed: int
     timeout: int
+    portfolio: list[Configuration]
     use_subsets: bool
     use_teleportation: bool
     verbose: bool
@@ -180,6 +196,29 @@ class EarlyTermination:
     @property
     def value(self) -> int: ...
 
+class SearchEngine:
+    __members__: ClassVar[dict[SearchEngine, int]] = ...  # read-only
+    astar: ClassVar[SearchEngine] = ...
+    hash_distributed_astar: ClassVar[SearchEngine] = ...
+
+    @overload
+    def __init__(self, value: int) -> None: ...
+    @overload
+    def __init__(self, arg0: str) -> None: ...
+    @overload
+    def __init__(self, arg0: SearchEngine) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __getstate__(self) -> int: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    def __setstate__(self, state: int) -> None: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
 class Encoding:
     __members__: ClassVar[dict[Encoding, int]] = ...  # read-only
     bimander: ClassVar[Encoding] = ...
@@ -207,6 +246,7 @@ class Encoding:
 class InitialLayout:
     __members__: ClassVar[dict[InitialLayout, int]] = ...  # read-only
     dynamic: ClassVar[InitialLayout] = ...
+    graph_isomorphism: ClassVar[InitialLayout] = ...
     identity: ClassVar[InitialLayout] = ...
     static: ClassVar[InitialLayout] = ...
 
@@ -259,6 +299,7 @@ class LookaheadHeuristic:
     none: ClassVar[LookaheadHeuristic] = ...
     gate_count_max_distance: ClassVar[LookaheadHeuristic] = ...
     gate_count_sum_distance: ClassVar[LookaheadHeuristic] = ...
+    fidelity_best_location: ClassVar[LookaheadHeuristic] = ...
 
     @overload
     def __init__(self, value: int) -> None: ...
@@ -310,6 +351,23 @@ class HeuristicBenchmarkInfo:
     seconds_per_node: float
     average_branching_factor: float
     effective_branching_factor: float
+    peak_memory: int
+    layers_per_second: float
+    skipped_layers: int
+
+    def __init__(self) -> None: ...
+    def json(self) -> dict[str, Any]: ...
+
+class PortfolioInfo:
+    status: str
+    time: float
+    selected: bool
+    swaps: int
+    teleportations: int
+    gates: int
+    total_log_fidelity: float
+    timeout: bool
+    error: str
 
     def __init__(self) -> None: ...
     def json(self) -> dict[str, Any]: ...
@@ -326,6 +384,8 @@ class LayerHeuristicBenchmarkInfo:
     average_branching_factor: float
     effective_branching_factor: float
     early_termination: bool
+    peak_memory: int
+    prunings: int
 
     def __init__(self) -> None: ...
     def json(self) -> dict[str, Any]: ...
@@ -340,6 +400,8 @@ class MappingResults:
     wcnf: str
     heuristic_benchmark: HeuristicBenchmarkInfo
     layer_heuristic_benchmark: LayerHeuristicBenchmarkInfo
+    portfolio: list[PortfolioInfo]
+    degraded_layers: list[int]
 
     def __init__(self) -> None: ...
     def csv(self) -> str: ...
@@ -349,6 +411,8 @@ class Method:
     __members__: ClassVar[dict[Method, int]] = ...  # read-only
     exact: ClassVar[Method] = ...
     heuristic: ClassVar[Method] = ...
+    portfolio: ClassVar[Method] = ...
+    sabre: ClassVar[Method] = ...
 
     @overload
     def __init__(self, value: int) -> None: ...
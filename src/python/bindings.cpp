@@ -6,6 +6,8 @@
 #include "cliffordsynthesis/CliffordSynthesizer.hpp"
 #include "exact/ExactMapper.hpp"
 #include "heuristic/HeuristicMapper.hpp"
+#include "heuristic/PortfolioMapper.hpp"
+#include "heuristic/SabreMapper.hpp"
 #include "hybridmap/HybridNeutralAtomMapper.hpp"
 #include "hybridmap/NeutralAtomScheduler.hpp"
 #include "nlohmann/json.hpp"
@@ -52,6 +54,10 @@ MappingResults map(const py::object& circ, Architecture& arch,
       mapper = std::make_unique<HeuristicMapper>(qc, arch);
     } else if (config.method == Method::Exact) {
       mapper = std::make_unique<ExactMapper>(qc, arch);
+    } else if (config.method == Method::Portfolio) {
+      mapper = std::make_unique<PortfolioMapper>(qc, arch);
+    } else if (config.method == Method::Sabre) {
+      mapper = std::make_unique<SabreMapper>(qc, arch);
     }
   } catch (std::exception const& e) {
     std::stringstream ss{};
@@ -109,6 +115,8 @@ PYBIND11_MODULE(pyqmap, m) {
   py::enum_<Method>(m, "Method")
       .value("heuristic", Method::Heuristic)
       .value("exact", Method::Exact)
+      .value("portfolio", Method::Portfolio)
+      .value("sabre", Method::Sabre)
       .export_values()
       // allow construction from string
       .def(py::init([](const std::string& str) -> Method {
@@ -120,6 +128,7 @@ PYBIND11_MODULE(pyqmap, m) {
       .value("identity", InitialLayout::Identity)
       .value("static", InitialLayout::Static)
       .value("dynamic", InitialLayout::Dynamic)
+      .value("graph_isomorphism", InitialLayout::GraphIsomorphism)
       .export_values()
       // allow construction from string
       .def(py::init([](const std::string& str) -> InitialLayout {
@@ -148,6 +157,8 @@ PYBIND11_MODULE(pyqmap, m) {
              LookaheadHeuristic::GateCountMaxDistance)
       .value("gate_count_sum_distance",
              LookaheadHeuristic::GateCountSumDistance)
+      .value("fidelity_best_location",
+             LookaheadHeuristic::FidelityBestLocation)
       .export_values()
       // allow construction from string
       .def(py::init([](const std::string& str) -> LookaheadHeuristic {
@@ -184,6 +195,16 @@ PYBIND11_MODULE(pyqmap, m) {
         return earlyTerminationFromString(str);
       }));
 
+  // Search engine in heuristic mapper
+  py::enum_<SearchEngine>(m, "SearchEngine")
+      .value("astar", SearchEngine::AStar)
+      .value("hash_distributed_astar", SearchEngine::HashDistributedAStar)
+      .export_values()
+      // allow construction from string
+      .def(py::init([](const std::string& str) -> SearchEngine {
+        return searchEngineFromString(str);
+      }));
+
   // Encoding settings for at-most-one and exactly-one constraints
   py::enum_<Encoding>(m, "Encoding")
       .value("naive", Encoding::Naive)
@@ -235,14 +256,28 @@ PYBIND11_MODULE(pyqmap, m) {
                      &Configuration::automaticLayerSplits)
       .def_readwrite("automatic_layer_splits_node_limit",
                      &Configuration::automaticLayerSplitsNodeLimit)
+      .def_readwrite("memory_bounded_search",
+                     &Configuration::memoryBoundedSearch)
+      .def_readwrite("memory_bounded_search_budget",
+                     &Configuration::memoryBoundedSearchBudget)
+      .def_readwrite("memory_bounded_search_beam_width",
+                     &Configuration::memoryBoundedSearchBeamWidth)
+      .def_readwrite("warm_start_search", &Configuration::warmStartSearch)
+      .def_readwrite("layer_window", &Configuration::layerWindow)
+      .def_readwrite("n_threads", &Configuration::nThreads)
+      .def_readwrite("search_engine", &Configuration::searchEngine)
       .def_readwrite("early_termination", &Configuration::earlyTermination)
       .def_readwrite("early_termination_limit",
                      &Configuration::earlyTerminationLimit)
       .def_readwrite("initial_layout", &Configuration::initialLayout)
+      .def_readwrite("initial_layout_timeout",
+                     &Configuration::initialLayoutTimeout)
       .def_readwrite("iterative_bidirectional_routing",
                      &Configuration::iterativeBidirectionalRouting)
       .def_readwrite("iterative_bidirectional_routing_passes",
                      &Configuration::iterativeBidirectionalRoutingPasses)
+      .def_readwrite("iterative_bidirectional_routing_chains",
+                     &Configuration::iterativeBidirectionalRoutingChains)
       .def_readwrite("lookahead_heuristic", &Configuration::lookaheadHeuristic)
       .def_readwrite("lookaheads", &Configuration::nrLookaheads)
       .def_readwrite("first_lookahead_factor",
@@ -254,6 +289,7 @@ PYBIND11_MODULE(pyqmap, m) {
       .def_readwrite("teleportation_seed", &Configuration::teleportationSeed)
       .def_readwrite("teleportation_fake", &Configuration::teleportationFake)
       .def_readwrite("timeout", &Configuration::timeout)
+      .def_readwrite("portfolio", &Configuration::portfolio)
       .def_readwrite("encoding", &Configuration::encoding)
       .def_readwrite("commander_grouping", &Configuration::commanderGrouping)
       .def_readwrite("use_subsets", &Configuration::useSubsets)
@@ -288,6 +324,8 @@ PYBIND11_MODULE(pyqmap, m) {
       .def_readwrite("layer_heuristic_benchmark",
                      &MappingResults::layerHeuristicBenchmark)
       .def_readwrite("wcnf", &MappingResults::wcnf)
+      .def_readwrite("portfolio", &MappingResults::portfolio)
+      .def_readwrite("degraded_layers", &MappingResults::degradedLayers)
       .def("json", &MappingResults::json)
       .def("csv", &MappingResults::csv)
       .def("__repr__", &MappingResults::toString);
@@ -329,8 +367,31 @@ PYBIND11_MODULE(pyqmap, m) {
       .def_readwrite(
           "effective_branching_factor",
           &MappingResults::HeuristicBenchmarkInfo::effectiveBranchingFactor)
+      .def_readwrite("peak_memory",
+                     &MappingResults::HeuristicBenchmarkInfo::peakMemory)
+      .def_readwrite("layers_per_second",
+                     &MappingResults::HeuristicBenchmarkInfo::layersPerSecond)
+      .def_readwrite("skipped_layers",
+                     &MappingResults::HeuristicBenchmarkInfo::skippedLayers)
       .def("json", &MappingResults::HeuristicBenchmarkInfo::json);
 
+  // Information on the individual runs of the portfolio mapper
+  py::class_<MappingResults::PortfolioInfo>(
+      m, "PortfolioInfo", "Information on a configuration of the portfolio")
+      .def(py::init<>())
+      .def_readwrite("status", &MappingResults::PortfolioInfo::status)
+      .def_readwrite("time", &MappingResults::PortfolioInfo::time)
+      .def_readwrite("selected", &MappingResults::PortfolioInfo::selected)
+      .def_readwrite("swaps", &MappingResults::PortfolioInfo::swaps)
+      .def_readwrite("teleportations",
+                     &MappingResults::PortfolioInfo::teleportations)
+      .def_readwrite("gates", &MappingResults::PortfolioInfo::gates)
+      .def_readwrite("total_log_fidelity",
+                     &MappingResults::PortfolioInfo::totalLogFidelity)
+      .def_readwrite("timeout", &MappingResults::PortfolioInfo::timeout)
+      .def_readwrite("error", &MappingResults::PortfolioInfo::error)
+      .def("json", &MappingResults::PortfolioInfo::json);
+
   // Heuristic benchmark information for individual layers
   py::class_<MappingResults::LayerHeuristicBenchmarkInfo>(
       m, "LayerHeuristicBenchmarkInfo", "Heuristic benchmark information")
@@ -368,6 +429,10 @@ PYBIND11_MODULE(pyqmap, m) {
       .def_readwrite(
           "early_termination",
           &MappingResults::LayerHeuristicBenchmarkInfo::earlyTermination)
+      .def_readwrite("peak_memory",
+                     &MappingResults::LayerHeuristicBenchmarkInfo::peakMemory)
+      .def_readwrite("prunings",
+                     &MappingResults::LayerHeuristicBenchmarkInfo::prunings)
       .def("json", &MappingResults::LayerHeuristicBenchmarkInfo::json);
 
   auto arch = py::class_<Architecture>(
@@ -490,7 +555,15 @@ PYBIND11_MODULE(pyqmap, m) {
            "properties"_a)
       .def("load_properties",
            py::overload_cast<const std::string&>(&Architecture::loadProperties),
-           "properties"_a);
+           "properties"_a)
+      .def("update_properties", &Architecture::updateProperties,
+           "properties"_a)
+      .def_static("set_table_cache_directory",
+                  &Architecture::setTableCacheDirectory, "directory"_a)
+      .def_static("get_table_cache_directory",
+                  &Architecture::getTableCacheDirectory)
+      .def_property("table_threads", &Architecture::getTableThreads,
+                    &Architecture::setTableThreads);
 
   // Main mapping function
   m.def("map", &map, "map a quantum circuit", "circ"_a, "arch"_a, "config"_a);
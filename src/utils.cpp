@@ -5,121 +5,259 @@
 
 #include "utils.hpp"
 
+#include <atomic>
 #include <cassert>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
 
 void Dijkstra::buildTable(const CouplingMap& couplingMap, Matrix& distanceTable,
-                          const Matrix& edgeWeights) {
+                          const Matrix& edgeWeights,
+                          const std::size_t nThreads) {
   // number of qubits
-  const auto n = static_cast<std::uint16_t>(edgeWeights.size());
+  const auto n         = static_cast<std::uint16_t>(edgeWeights.size());
+  const auto adjacency = buildAdjacency(couplingMap, n);
 
-  distanceTable.clear();
-  distanceTable.resize(n, std::vector<double>(n, -1.));
+  distanceTable.assign(n, n);
+  parallelFor(n, nThreads, [&](const std::size_t i) {
+    shortestPaths(adjacency, edgeWeights, i, distanceTable[i]);
+  });
+}
+
+void Dijkstra::shortestPaths(const Adjacency&   adjacency,
+                             const Matrix&      edgeWeights,
+                             const std::size_t  source,
+                             const Matrix::Row& costs) {
+  std::fill(costs.begin(), costs.end(), std::numeric_limits<double>::max());
+  costs[source] = 0.;
+  dijkstra(adjacency, edgeWeights, costs);
 
-  for (std::uint16_t i = 0; i < n; ++i) {
-    std::vector<Dijkstra::Node> nodes(n);
-    for (std::uint16_t j = 0; j < n; ++j) {
-      nodes.at(j).visited = false;
-      nodes.at(j).pos     = j;
-      nodes.at(j).cost    = -1.;
+  for (auto& cost : costs) {
+    if (cost == std::numeric_limits<double>::max()) {
+      cost = -1.;
     }
+  }
+}
 
-    nodes.at(i).cost = 0;
+void Dijkstra::edgeSkipShortestPaths(const Adjacency&        adjacency,
+                                     const Matrix&           edgeWeights,
+                                     const std::size_t       source,
+                                     const Matrix::ConstRow& previous,
+                                     const Matrix::Row&      costs) {
+  std::fill(costs.begin(), costs.end(), std::numeric_limits<double>::max());
+  for (std::size_t q = 0; q < costs.size(); ++q) {
+    // unreachable qubits have a distance of -1 in the first table
+    if (previous[q] < 0.) {
+      continue;
+    }
+    costs[q] = std::min(costs[q], previous[q]);
+    for (auto i = adjacency.offsets[q]; i < adjacency.offsets[q + 1U]; ++i) {
+      auto& cost = costs[adjacency.neighbors[i]];
+      cost       = std::min(cost, previous[q]);
+    }
+  }
+  costs[source] = 0.;
+  dijkstra(adjacency, edgeWeights, costs);
+}
 
-    dijkstra(couplingMap, nodes, i, edgeWeights);
+Dijkstra::Adjacency Dijkstra::buildAdjacency(const CouplingMap& couplingMap,
+                                             const std::uint16_t nqubits) {
+  Adjacency adjacency{};
+  adjacency.offsets.assign(static_cast<std::size_t>(nqubits) + 1U, 0U);
+  for (const auto& [q1, q2] : couplingMap) {
+    if (q1 >= nqubits || q2 >= nqubits) {
+      throw QMAPException("Edge (" + std::to_string(q1) + ", " +
+                          std::to_string(q2) + ") of the coupling map is "
+                          "outside of the architecture.");
+    }
+    // bidirectional edges are counted once (for the smaller direction)
+    if (q1 != q2 && (q1 < q2 || couplingMap.find({q2, q1}) ==
+                                    couplingMap.end())) {
+      ++adjacency.offsets[q1 + 1U];
+      ++adjacency.offsets[q2 + 1U];
+    }
+  }
+  std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(),
+                   adjacency.offsets.begin());
 
-    for (std::uint16_t j = 0; j < n; ++j) {
-      if (i == j) {
-        distanceTable.at(i).at(j) = 0;
-      } else {
-        distanceTable.at(i).at(j) = nodes.at(j).cost;
-      }
+  adjacency.neighbors.resize(adjacency.offsets.back());
+  std::vector<std::size_t> next(adjacency.offsets.begin(),
+                                adjacency.offsets.end() - 1);
+  for (const auto& [q1, q2] : couplingMap) {
+    if (q1 != q2 && (q1 < q2 || couplingMap.find({q2, q1}) ==
+                                    couplingMap.end())) {
+      adjacency.neighbors[next[q1]++] = q2;
+      adjacency.neighbors[next[q2]++] = q1;
     }
   }
+  return adjacency;
 }
 
-void Dijkstra::dijkstra(const CouplingMap& couplingMap,
-                        std::vector<Node>& nodes, const std::uint16_t start,
-                        const Matrix& edgeWeights) {
-  std::priority_queue<Node*, std::vector<Node*>, NodeComparator> queue{};
-  queue.push(&nodes.at(start));
+void Dijkstra::dijkstra(const Adjacency& adjacency, const Matrix& edgeWeights,
+                        const Matrix::Row& costs) {
+  const auto  n = costs.size();
+  IndexedHeap queue(n);
+  for (std::size_t q = 0; q < n; ++q) {
+    if (costs[q] != std::numeric_limits<double>::max()) {
+      queue.push(static_cast<std::uint16_t>(q), costs);
+    }
+  }
+
   while (!queue.empty()) {
-    auto* current    = queue.top();
-    current->visited = true;
-    queue.pop();
-    auto pos = current->pos;
-
-    for (const auto& edge : couplingMap) {
-      std::optional<std::uint16_t> to = std::nullopt;
-      if (pos == edge.first) { // forward edge
-        to = edge.second;
-      } else if (pos == edge.second) { // back edge
-        to = edge.first;
+    const auto  pos     = queue.pop(costs);
+    const auto& weights = edgeWeights[pos];
+    for (auto i = adjacency.offsets[pos]; i < adjacency.offsets[pos + 1U];
+         ++i) {
+      const auto to   = adjacency.neighbors[i];
+      const auto cost = costs[pos] + weights[to];
+      if (cost < costs[to]) {
+        costs[to] = cost;
+        queue.push(to, costs);
       }
-      if (to.has_value()) {
-        if (nodes.at(*to).visited) {
-          continue;
-        }
+    }
+  }
+}
+
+void Dijkstra::IndexedHeap::push(const std::uint16_t qubit,
+                                 const Matrix::Row&  costs) {
+  auto& position = positions[qubit];
+  if (position == POPPED) {
+    return;
+  }
+  if (position == NOT_CONTAINED) {
+    position = heap.size();
+    heap.emplace_back(qubit);
+  }
+  siftUp(position, costs);
+}
+
+std::uint16_t Dijkstra::IndexedHeap::pop(const Matrix::Row& costs) {
+  const auto top = heap.front();
+  positions[top] = POPPED;
+  heap.front()   = heap.back();
+  heap.pop_back();
+  if (!heap.empty()) {
+    positions[heap.front()] = 0;
+    siftDown(0, costs);
+  }
+  return top;
+}
+
+void Dijkstra::IndexedHeap::siftUp(std::size_t        index,
+                                   const Matrix::Row& costs) {
+  const auto qubit = heap[index];
+  while (index > 0) {
+    const auto parent = (index - 1) / 2;
+    if (costs[heap[parent]] <= costs[qubit]) {
+      break;
+    }
+    heap[index]            = heap[parent];
+    positions[heap[index]] = index;
+    index                  = parent;
+  }
+  heap[index]      = qubit;
+  positions[qubit] = index;
+}
+
+void Dijkstra::IndexedHeap::siftDown(std::size_t        index,
+                                     const Matrix::Row& costs) {
+  const auto qubit = heap[index];
+  while (true) {
+    auto child = 2 * index + 1;
+    if (child >= heap.size()) {
+      break;
+    }
+    if (child + 1 < heap.size() &&
+        costs[heap[child + 1]] < costs[heap[child]]) {
+      ++child;
+    }
+    if (costs[qubit] <= costs[heap[child]]) {
+      break;
+    }
+    heap[index]            = heap[child];
+    positions[heap[index]] = index;
+    index                  = child;
+  }
+  heap[index]      = qubit;
+  positions[qubit] = index;
+}
+
+void Dijkstra::parallelFor(const std::size_t n, const std::size_t nThreads,
+                           const std::function<void(std::size_t)>& func) {
+  const auto threads = n < PARALLEL_MIN_ROWS
+                           ? std::size_t{1}
+                           : std::min(nThreads, n / (PARALLEL_MIN_ROWS / 2));
+  if (threads <= 1) {
+    for (std::size_t i = 0; i < n; ++i) {
+      func(i);
+    }
+    return;
+  }
 
-        Node newNode;
-        newNode.cost = current->cost + edgeWeights.at(*pos).at(*to);
-        newNode.pos  = to;
-        if (nodes.at(*to).cost < 0 || newNode < nodes.at(*to)) {
-          nodes.at(*to) = newNode;
-          queue.push(&nodes.at(*to));
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr       exception = nullptr;
+  std::mutex               mutex;
+  const auto               work = [&]() {
+    for (auto i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+      try {
+        func(i);
+      } catch (...) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (!exception) {
+          exception = std::current_exception();
         }
+        // skip all remaining rows
+        next = n;
       }
     }
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (std::size_t t = 1; t < threads; ++t) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
   }
 }
 
 void Dijkstra::buildEdgeSkipTable(const CouplingMap&   couplingMap,
                                   std::vector<Matrix>& distanceTables,
-                                  const Matrix&        edgeWeights) {
-  /* to find the cheapest distance between 2 qubits skipping any 1 edge, we
-  iterate over all edges, for each assume the current edge to be the one skipped
-  and are thereby able to retrieve the distance by just adding the distances
-  from the source and target qubit to each of the qubits on the edge. Taking the
-  minimum over all edges gives us the cheapest distance skipping any 1 edge.
-
-  For skipping any 2 edges, we can use the same approach, but on one side of the
-  edge taking not the regular distance but the previously calculated distance
-  skipping 1 edge. The same approach can be used for skipping any 3 edges, etc.
+                                  const Matrix&        edgeWeights,
+                                  const std::size_t    nThreads) {
+  /* a path skipping up to k edges consists of a path skipping up to k-1 edges,
+  the k-th skipped edge, and a regular path. Hence, the distances skipping k
+  edges from some source qubit are those of a Dijkstra search, in which each
+  qubit starts with the cheapest distance skipping k-1 edges to itself or to
+  one of its neighbors (from which the edge to the qubit is skipped).
   */
   distanceTables.clear();
   distanceTables.emplace_back();
-  buildTable(couplingMap, distanceTables.back(), edgeWeights);
-  const std::size_t n = edgeWeights.size();
+  buildTable(couplingMap, distanceTables.back(), edgeWeights, nThreads);
+  const std::size_t n         = edgeWeights.size();
+  const auto        adjacency = buildAdjacency(couplingMap,
+                                               static_cast<std::uint16_t>(n));
   for (std::size_t k = 1; k <= n; ++k) {
     // k...number of edges to be skipped along each path
-    distanceTables.emplace_back(
-        n, std::vector<double>(n, std::numeric_limits<double>::max()));
-    Matrix* currentTable = &distanceTables.back();
-    for (std::size_t q = 0; q < n; ++q) {
-      currentTable->at(q).at(q) = 0.;
-    }
-    bool done = false;
-    for (const auto& [e1, e2] : couplingMap) { // edge to be skipped
-      for (std::size_t l = 0; l < k; ++l) {
-        done = true;
-        // l ... number of edges to skip before edge
-        for (std::size_t q1 = 0; q1 < n; ++q1) {        // q1 ... source qubit
-          for (std::size_t q2 = q1 + 1; q2 < n; ++q2) { // q2 ... target qubit
-            currentTable->at(q1).at(q2) =
-                std::min(currentTable->at(q1).at(q2),
-                         distanceTables.at(l).at(q1).at(e1) +
-                             distanceTables.at(k - l - 1).at(e2).at(q2));
-            currentTable->at(q1).at(q2) =
-                std::min(currentTable->at(q1).at(q2),
-                         distanceTables.at(l).at(q1).at(e2) +
-                             distanceTables.at(k - l - 1).at(e1).at(q2));
-            currentTable->at(q2).at(q1) = currentTable->at(q1).at(q2);
-            if (done && currentTable->at(q2).at(q1) > 0) {
-              done = false;
-            }
-          }
-        }
-      }
-    }
+    distanceTables.emplace_back(n, n);
+    const Matrix& previousTable = distanceTables.at(k - 1);
+    Matrix&       currentTable  = distanceTables.back();
+
+    parallelFor(n, nThreads, [&](const std::size_t q1) { // q1 ... source qubit
+      edgeSkipShortestPaths(adjacency, edgeWeights, q1, previousTable[q1],
+                            currentTable[q1]);
+    });
+
+    const bool done =
+        !couplingMap.empty() &&
+        std::all_of(currentTable.data(), currentTable.data() + n * n,
+                    [](const double d) { return d <= 0.; });
     if (done) {
       // all distances of the last matrix where 0
       distanceTables.pop_back();
@@ -128,39 +266,131 @@ void Dijkstra::buildEdgeSkipTable(const CouplingMap&   couplingMap,
   }
 }
 
+std::size_t Dijkstra::updateEdgeSkipTable(const CouplingMap&   couplingMap,
+                                          std::vector<Matrix>& distanceTables,
+                                          const Matrix& previousEdgeWeights,
+                                          const Matrix& edgeWeights,
+                                          const std::size_t nThreads) {
+  const std::size_t n         = edgeWeights.size();
+  const auto        adjacency = buildAdjacency(couplingMap,
+                                               static_cast<std::uint16_t>(n));
+
+  // changed edges in the direction of traversal with the lower of both weights
+  struct Change {
+    std::uint16_t from;
+    std::uint16_t to;
+    double        weight;
+  };
+  std::vector<Change> changes{};
+  bool                rebuild =
+      distanceTables.empty() || previousEdgeWeights.size() != n;
+  for (std::uint16_t q = 0; q < n && !rebuild; ++q) {
+    for (auto i = adjacency.offsets[q]; i < adjacency.offsets[q + 1U]; ++i) {
+      const auto to       = adjacency.neighbors[i];
+      const auto previous = previousEdgeWeights(q, to);
+      const auto current  = edgeWeights(q, to);
+      if (previous != current) {
+        // with edges of weight 0, further skip tables may become necessary
+        rebuild = rebuild || previous <= 0. || current <= 0.;
+        changes.push_back({q, to, std::min(previous, current)});
+      }
+    }
+  }
+  if (rebuild) {
+    buildEdgeSkipTable(couplingMap, distanceTables, edgeWeights, nThreads);
+    return n * distanceTables.size();
+  }
+  if (changes.empty()) {
+    return 0;
+  }
+
+  const auto affected = [&changes](const Matrix::ConstRow& row) {
+    for (const auto& [from, to, weight] : changes) {
+      const auto distance = row[from];
+      if (distance < 0. || distance == std::numeric_limits<double>::max()) {
+        // unreachable
+        continue;
+      }
+      // tolerate rounding errors, recomputing a row too many is harmless
+      if (distance + weight <= row[to] + 1e-9 * std::max(1., row[to])) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  std::size_t                recomputed = 0;
+  std::vector<bool>          recompute(n, false);
+  std::vector<std::uint16_t> rows{};
+  for (std::size_t k = 0; k < distanceTables.size(); ++k) {
+    auto& table = distanceTables[k];
+    rows.clear();
+    for (std::uint16_t q = 0; q < n; ++q) {
+      // rows which changed in the previous table have to be recomputed anyway
+      if (!recompute[q]) {
+        recompute[q] = affected(std::as_const(table)[q]);
+      }
+      if (recompute[q]) {
+        rows.emplace_back(q);
+      }
+    }
+
+    parallelFor(rows.size(), nThreads, [&](const std::size_t i) {
+      const auto q = rows[i];
+      if (k == 0) {
+        shortestPaths(adjacency, edgeWeights, q, table[q]);
+      } else {
+        const auto& previousTable = distanceTables[k - 1];
+        edgeSkipShortestPaths(adjacency, edgeWeights, q, previousTable[q],
+                              table[q]);
+      }
+    });
+    recomputed += rows.size();
+  }
+  return recomputed;
+}
+
 void Dijkstra::buildSingleEdgeSkipTable(const Matrix&      distanceTable,
                                         const CouplingMap& couplingMap,
                                         const double       reversalCost,
-                                        Matrix& edgeSkipDistanceTable) {
+                                        Matrix&            edgeSkipDistanceTable,
+                                        const std::size_t  nThreads) {
+  /* the cheapest path from q1 to q2 skipping the edge (e1, e2) is the
+  cheapest path from q1 to e1 followed by the cheapest path from e2 to q2.
+  Hence, the distances from q1 are obtained by first computing the cheapest
+  cost of reaching each qubit e2 from q1 by skipping any edge (e1, e2), and then
+  the cheapest continuation from any such qubit.
+  */
   const std::size_t n = distanceTable.size();
-  edgeSkipDistanceTable.clear();
-  edgeSkipDistanceTable.resize(
-      n, std::vector<double>(n, std::numeric_limits<double>::max()));
-  for (std::size_t q = 0; q < n; ++q) {
-    edgeSkipDistanceTable.at(q).at(q) = 0.;
-  }
-  for (const auto& [e1, e2] : couplingMap) {        // edge to be skipped
-    for (std::size_t q1 = 0; q1 < n; ++q1) {        // q1 ... source qubit
-      for (std::size_t q2 = q1 + 1; q2 < n; ++q2) { // q2 ... target qubit
-        edgeSkipDistanceTable.at(q1).at(q2) =
-            std::min(edgeSkipDistanceTable.at(q1).at(q2),
-                     distanceTable.at(q1).at(e1) + distanceTable.at(e2).at(q2));
-        edgeSkipDistanceTable.at(q1).at(q2) =
-            std::min(edgeSkipDistanceTable.at(q1).at(q2),
-                     distanceTable.at(q1).at(e2) + distanceTable.at(e1).at(q2) +
-                         reversalCost);
-        if (reversalCost == 0.) {
-          edgeSkipDistanceTable.at(q2).at(q1) =
-              edgeSkipDistanceTable.at(q1).at(q2);
-        } else {
-          edgeSkipDistanceTable.at(q2).at(q1) = std::min(
-              edgeSkipDistanceTable.at(q2).at(q1),
-              distanceTable.at(q2).at(e1) + distanceTable.at(e2).at(q1));
-          edgeSkipDistanceTable.at(q2).at(q1) =
-              std::min(edgeSkipDistanceTable.at(q2).at(q1),
-                       distanceTable.at(q2).at(e2) +
-                           distanceTable.at(e1).at(q1) + reversalCost);
-        }
+  edgeSkipDistanceTable.assign(n, n, std::numeric_limits<double>::max());
+
+  parallelFor(n, nThreads, [&](const std::size_t q1) { // q1 ... source qubit
+    const auto          distances = distanceTable.at(q1);
+    std::vector<double> skipped(n, std::numeric_limits<double>::max());
+    for (const auto& [e1, e2] : couplingMap) { // edge to be skipped
+      skipped.at(e2) = std::min(skipped.at(e2), distances.at(e1));
+      skipped.at(e1) =
+          std::min(skipped.at(e1), distances.at(e2) + reversalCost);
+    }
+
+    const auto row = edgeSkipDistanceTable[q1];
+    for (std::size_t q = 0; q < n; ++q) {
+      if (skipped[q] == std::numeric_limits<double>::max()) {
+        continue;
+      }
+      const auto continuation = distanceTable[q];
+      for (std::size_t q2 = 0; q2 < n; ++q2) { // q2 ... target qubit
+        row[q2] = std::min(row[q2], skipped[q] + continuation[q2]);
+      }
+    }
+    row[q1] = 0.;
+  });
+
+  if (reversalCost == 0.) {
+    // without reversal costs, the table is symmetric
+    for (std::size_t q1 = 0; q1 < n; ++q1) {
+      for (std::size_t q2 = q1 + 1; q2 < n; ++q2) {
+        edgeSkipDistanceTable(q2, q1) = edgeSkipDistanceTable(q1, q2);
       }
     }
   }
@@ -233,3 +233,15 @@ def test_parameters(example_circuit: QuantumCircuit) -> None:
     assert results.configuration.verbose is False
     assert results.configuration.debug is False
     assert not results.configuration.data_logging_path
+
+    _, results = compile(
+        example_circuit,
+        arch=arch,
+        method="heuristic",
+        heuristic="fidelity_best_location",
+        lookahead_heuristic="fidelity_best_location",
+        lookaheads=3,
+    )
+    assert results.configuration.heuristic == Heuristic.fidelity_best_location
+    assert results.configuration.lookahead_heuristic == LookaheadHeuristic.fidelity_best_location
+    assert results.configuration.lookaheads == 3
@@ -74,3 +74,64 @@ def test_heuristic_non_trivial_swaps(backend: GenericBackendV2) -> None:
     print(result)
 
     assert result.considered_equivalent() is True
+
+
+def test_portfolio(backend: GenericBackendV2) -> None:
+    """Verify that the portfolio mapper keeps the best result of the given configurations."""
+    qc = QuantumCircuit(3)
+    qc.h(0)
+    qc.cx(0, 1)
+    qc.cx(1, 2)
+    qc.cx(2, 0)
+    qc.measure_all()
+
+    portfolio = []
+    for heuristic in ["gate_count_max_distance", "gate_count_sum_distance_minus_shared_swaps"]:
+        config = qmap.Configuration()
+        config.heuristic = qmap.Heuristic(heuristic)
+        portfolio.append(config)
+
+    qc_mapped, results = qmap.compile(qc, arch=backend, method="portfolio", portfolio=portfolio)
+
+    assert results.timeout is False
+    assert results.output.swaps == 1
+    assert len(results.portfolio) == 2
+    assert sum(run.selected for run in results.portfolio) == 1
+
+    result = verify(qc, qc_mapped)
+    assert result.considered_equivalent() is True
+
+
+def test_sabre(backend: GenericBackendV2) -> None:
+    """Verify that the SABRE router produces an equivalent circuit."""
+    qc = QuantumCircuit(3)
+    qc.h(0)
+    qc.cx(0, 1)
+    qc.cx(1, 2)
+    qc.cx(2, 0)
+    qc.measure_all()
+
+    qc_mapped, results = qmap.compile(qc, arch=backend, method="sabre", iterative_bidirectional_routing_passes=1)
+
+    assert results.configuration.method == qmap.Method.sabre
+
+    result = verify(qc, qc_mapped)
+    assert result.considered_equivalent() is True
+
+
+def test_graph_isomorphism_initial_layout(backend: GenericBackendV2) -> None:
+    """Verify that the graph isomorphism initial layout produces an equivalent circuit."""
+    qc = QuantumCircuit(3)
+    qc.h(0)
+    qc.cx(0, 1)
+    qc.cx(1, 2)
+    qc.cx(0, 1)
+    qc.measure_all()
+
+    qc_mapped, results = qmap.compile(qc, arch=backend, initial_layout="graph_isomorphism")
+
+    assert results.configuration.initial_layout == qmap.InitialLayout.graph_isomorphism
+    assert results.output.swaps == 0
+
+    result = verify(qc, qc_mapped)
+    assert result.considered_equivalent() is True
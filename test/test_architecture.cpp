@@ -6,6 +6,8 @@
 #include "Architecture.hpp"
 
 #include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
 #include <random>
 
 ::testing::AssertionResult matrixNear(const Matrix& a, const Matrix& b,
@@ -186,6 +188,89 @@ TEST(TestArchitecture, TestCouplingLimitRing) {
   EXPECT_EQ(architecture.getCouplingLimit(), 2);
 }
 
+TEST(TestArchitecture, IncidentEdges) {
+  Architecture      architecture{};
+  const CouplingMap cm = {{0, 1}, {1, 0}, {1, 2}, {3, 1}, {4, 3}};
+  architecture.loadCouplingMap(6, cm);
+
+  const auto incident = [&architecture](const std::uint16_t q) {
+    const auto edges = architecture.getIncidentEdges(q);
+    return std::vector<Edge>(edges.begin(), edges.end());
+  };
+  EXPECT_EQ(incident(0), (std::vector<Edge>{{0, 1}, {1, 0}}));
+  EXPECT_EQ(incident(1), (std::vector<Edge>{{0, 1}, {1, 0}, {1, 2}, {3, 1}}));
+  EXPECT_EQ(incident(2), (std::vector<Edge>{{1, 2}}));
+  EXPECT_EQ(incident(3), (std::vector<Edge>{{3, 1}, {4, 3}}));
+  EXPECT_EQ(incident(4), (std::vector<Edge>{{4, 3}}));
+  EXPECT_TRUE(architecture.getIncidentEdges(5).empty());
+  EXPECT_TRUE(architecture.getIncidentEdges(6).empty());
+
+  architecture.setCouplingMap({{2, 4}});
+  EXPECT_TRUE(architecture.getIncidentEdges(0).empty());
+  EXPECT_EQ(incident(4), (std::vector<Edge>{{2, 4}}));
+}
+
+TEST(TestArchitecture, TeleportationDistances) {
+  Architecture      architecture{};
+  const CouplingMap cm = {{0, 1}, {1, 2}, {2, 3}, {3, 4}};
+  architecture.loadCouplingMap(5, cm);
+  const Matrix distances = architecture.getDistanceTable();
+
+  const auto teleportationDistances =
+      architecture.createTeleportationDistanceTable({{0, 3}});
+  EXPECT_DOUBLE_EQ(teleportationDistances(0, 0), 0.);
+  EXPECT_DOUBLE_EQ(teleportationDistances(0, 1), 0.);
+  EXPECT_DOUBLE_EQ(teleportationDistances(1, 0), 4.);
+  // adjacent only through the teleportation
+  EXPECT_DOUBLE_EQ(teleportationDistances(0, 3), 7.);
+  EXPECT_DOUBLE_EQ(teleportationDistances(3, 0), 7.);
+  // shortest paths using the teleportation
+  EXPECT_DOUBLE_EQ(teleportationDistances(0, 4), 7.);
+  EXPECT_DOUBLE_EQ(teleportationDistances(4, 0), 11.);
+  EXPECT_DOUBLE_EQ(teleportationDistances(0, 2), 7.);
+
+  // the architecture itself is not changed
+  for (std::uint16_t i = 0; i < 5; ++i) {
+    for (std::uint16_t j = 0; j < 5; ++j) {
+      EXPECT_DOUBLE_EQ(architecture.distance(i, j), distances.at(i).at(j));
+    }
+  }
+}
+
+TEST(TestArchitecture, SharedTables) {
+  const CouplingMap cm    = {{0, 1}, {1, 0}, {1, 2}, {2, 3}, {3, 2}};
+  auto              props = Architecture::Properties();
+  for (std::uint16_t i = 0; i < 4; ++i) {
+    props.setSingleQubitErrorRate(i, "x", 0.01);
+  }
+  for (const auto& [q1, q2] : cm) {
+    props.setTwoQubitErrorRate(q1, q2, 0.05);
+  }
+  const Architecture original(4, cm, props);
+
+  // copies share the tables of the original
+  Architecture copy = original;
+  EXPECT_EQ(&copy.getDistanceTable(), &original.getDistanceTable());
+  EXPECT_EQ(&copy.getDistanceTable(false), &original.getDistanceTable(false));
+  EXPECT_EQ(&copy.getFidelityDistanceTables(),
+            &original.getFidelityDistanceTables());
+  EXPECT_EQ(&copy.getSwapFidelityCosts(), &original.getSwapFidelityCosts());
+
+  // changes of the copy do not affect the original
+  const Matrix swapCosts = original.getSwapFidelityCosts();
+  auto         changes   = Architecture::Properties();
+  changes.setTwoQubitErrorRate(1, 2, 0.2);
+  copy.updateProperties(changes);
+  EXPECT_NE(&copy.getSwapFidelityCosts(), &original.getSwapFidelityCosts());
+  EXPECT_EQ(original.getSwapFidelityCosts(), swapCosts);
+  EXPECT_NE(copy.getSwapFidelityCosts(), swapCosts);
+
+  copy.setCouplingMap({{0, 1}, {1, 2}, {2, 3}});
+  EXPECT_NE(&copy.getDistanceTable(), &original.getDistanceTable());
+  EXPECT_DOUBLE_EQ(original.distance(1, 0), 0.);
+  EXPECT_GT(copy.distance(1, 0), 0.);
+}
+
 TEST(TestArchitecture, opTypeFromString) {
   Architecture arch{2, {{0, 1}}};
   auto&        props = arch.getProperties();
@@ -863,6 +948,136 @@ TEST(TestArchitecture, FidelityDistanceCheapestPathTest) {
               -3 * 3 * std::log2(1 - 0.1) - 2 * 2 * std::log2(1 - 0.1), 1e-6);
 }
 
+TEST(TestArchitecture, UpdateProperties) {
+  const CouplingMap cm = {{0, 1}, {1, 0}, {2, 1}, {2, 6}, {6, 2},
+                          {0, 5}, {5, 0}, {5, 6}, {6, 5}, {0, 3},
+                          {3, 0}, {3, 4}, {4, 3}, {4, 6}, {6, 4}};
+  auto              props = Architecture::Properties();
+  for (std::uint16_t i = 0; i < 7; ++i) {
+    props.setSingleQubitErrorRate(i, "x", 0.01 * (i + 1));
+  }
+  for (const auto& [q1, q2] : cm) {
+    props.setTwoQubitErrorRate(q1, q2, 0.02 * (q1 + q2 + 1));
+  }
+  Architecture architecture(7, cm, props);
+
+  // recalibrated qubit of the unidirectional edge 2 -> 1 and two edges
+  auto changes = Architecture::Properties();
+  changes.setSingleQubitErrorRate(2, "x", 0.2);
+  changes.setTwoQubitErrorRate(0, 5, 0.01);
+  changes.setTwoQubitErrorRate(5, 0, 0.01);
+  changes.setTwoQubitErrorRate(4, 6, 0.4);
+  architecture.updateProperties(changes);
+
+  props.setSingleQubitErrorRate(2, "x", 0.2);
+  props.setTwoQubitErrorRate(0, 5, 0.01);
+  props.setTwoQubitErrorRate(5, 0, 0.01);
+  props.setTwoQubitErrorRate(4, 6, 0.4);
+  const Architecture target(7, cm, props);
+
+  EXPECT_DOUBLE_EQ(architecture.getProperties().getTwoQubitErrorRate(0, 5),
+                   0.01);
+  EXPECT_EQ(architecture.getSingleQubitFidelityCosts(),
+            target.getSingleQubitFidelityCosts());
+  EXPECT_TRUE(matrixNear(architecture.getTwoQubitFidelityCosts(),
+                         target.getTwoQubitFidelityCosts(), 1e-9));
+  EXPECT_TRUE(matrixNear(architecture.getSwapFidelityCosts(),
+                         target.getSwapFidelityCosts(), 1e-9));
+  for (std::uint16_t k = 0; k < 7; ++k) {
+    EXPECT_TRUE(matrixNear(architecture.getFidelityDistanceTable(k),
+                           target.getFidelityDistanceTable(k), 1e-9));
+  }
+}
+
+TEST(TestArchitecture, TableCache) {
+  const auto cacheDirectory =
+      std::filesystem::temp_directory_path() / "qmap_table_cache_test";
+  std::filesystem::remove_all(cacheDirectory);
+
+  const CouplingMap cm    = {{0, 1}, {1, 0}, {1, 2}, {2, 3},
+                             {3, 2}, {3, 4}, {4, 0}};
+  auto              props = Architecture::Properties();
+  for (std::uint16_t i = 0; i < 5; ++i) {
+    props.setSingleQubitErrorRate(i, "x", 0.01 * (i + 1));
+  }
+  for (const auto& [q1, q2] : cm) {
+    props.setTwoQubitErrorRate(q1, q2, 0.02 * (q1 + q2 + 1));
+  }
+  const Architecture reference(5, cm, props);
+  const auto         referenceLimit = reference.getCouplingLimit();
+
+  Architecture::setTableCacheDirectory(cacheDirectory.string());
+  EXPECT_EQ(Architecture::getTableCacheDirectory(), cacheDirectory.string());
+  const Architecture cold(5, cm, props);
+  EXPECT_EQ(cold.getCouplingLimit(), referenceLimit);
+  // distances, fidelities and coupling limit
+  std::vector<std::filesystem::path> entries{};
+  for (const auto& entry :
+       std::filesystem::directory_iterator(cacheDirectory)) {
+    entries.emplace_back(entry.path());
+  }
+  EXPECT_EQ(entries.size(), 3);
+
+  const auto expectSameTables = [&reference](const Architecture& arch) {
+    EXPECT_EQ(arch.getDistanceTable(false), reference.getDistanceTable(false));
+    EXPECT_EQ(arch.getDistanceTable(true), reference.getDistanceTable(true));
+    EXPECT_EQ(arch.bidirectional(), reference.bidirectional());
+    EXPECT_EQ(arch.unidirectional(), reference.unidirectional());
+    EXPECT_EQ(arch.getFidelityTable(), reference.getFidelityTable());
+    EXPECT_EQ(arch.getSingleQubitFidelities(),
+              reference.getSingleQubitFidelities());
+    EXPECT_EQ(arch.getSingleQubitFidelityCosts(),
+              reference.getSingleQubitFidelityCosts());
+    EXPECT_EQ(arch.getTwoQubitFidelityCosts(),
+              reference.getTwoQubitFidelityCosts());
+    EXPECT_EQ(arch.getSwapFidelityCosts(), reference.getSwapFidelityCosts());
+    EXPECT_EQ(arch.getFidelityDistanceTables(),
+              reference.getFidelityDistanceTables());
+  };
+  expectSameTables(cold);
+  const Architecture warm(5, cm, props);
+  expectSameTables(warm);
+  EXPECT_EQ(warm.getCouplingLimit(), referenceLimit);
+
+  // the tables are really loaded from the cache (the last entry of the
+  // distances is the last entry of the table with reversals)
+  for (const auto& path : entries) {
+    if (path.filename().string().rfind("distances", 0) == 0) {
+      std::fstream fs(path, std::ios::in | std::ios::out | std::ios::binary);
+      fs.seekp(-static_cast<std::streamoff>(sizeof(double)), std::ios::end);
+      const double modified = 42.;
+      fs.write(reinterpret_cast<const char*>(&modified), sizeof(double));
+    }
+  }
+  const Architecture modified(5, cm, props);
+  EXPECT_EQ(modified.getDistanceTable(true)[4][4], 42.);
+
+  // entries of other error rates are not used
+  props.setTwoQubitErrorRate(1, 2, 0.5);
+  const Architecture recalibrated(5, cm, props);
+  const Architecture recalibratedReference = [&]() {
+    Architecture::setTableCacheDirectory("");
+    return Architecture(5, cm, props);
+  }();
+  Architecture::setTableCacheDirectory(cacheDirectory.string());
+  EXPECT_EQ(recalibrated.getSwapFidelityCosts(),
+            recalibratedReference.getSwapFidelityCosts());
+  EXPECT_EQ(recalibrated.getFidelityDistanceTables(),
+            recalibratedReference.getFidelityDistanceTables());
+
+  // incomplete entries are recomputed
+  props.setTwoQubitErrorRate(1, 2, 0.02 * 4);
+  for (const auto& path : entries) {
+    std::filesystem::resize_file(path, 40);
+  }
+  const Architecture recovered(5, cm, props);
+  expectSameTables(recovered);
+  EXPECT_EQ(recovered.getCouplingLimit(), referenceLimit);
+
+  Architecture::setTableCacheDirectory("");
+  std::filesystem::remove_all(cacheDirectory);
+}
+
 TEST(TestArchitecture, FidelityDistanceNoFidelity) {
   const Architecture architecture(4, {{0, 1}, {1, 2}, {1, 3}});
 
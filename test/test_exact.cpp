@@ -338,6 +338,7 @@ TEST_P(ExactTest, toStringMethods) {
   EXPECT_EQ(toString(InitialLayout::Identity), "identity");
   EXPECT_EQ(toString(InitialLayout::Static), "static");
   EXPECT_EQ(toString(InitialLayout::Dynamic), "dynamic");
+  EXPECT_EQ(toString(InitialLayout::GraphIsomorphism), "graph_isomorphism");
 
   EXPECT_EQ(toString(Layering::IndividualGates), "individual_gates");
   EXPECT_EQ(toString(Layering::DisjointQubits), "disjoint_qubits");
@@ -76,6 +76,121 @@ TEST(General, Dijkstra) {
   EXPECT_EQ(distanceTable, targetTable1);
 }
 
+TEST(General, DijkstraLateImprovement) {
+  /*
+  the cheapest path from 2 to 3 (2 -> 1 -> 0 -> 3) is only found after the
+  direct edge has been explored
+
+          (3)
+       1 ----- 2 -(9)- 4
+   (1) |     / |
+       0 (9)   | (9)
+   (4) |       |
+       3 ------'
+  */
+
+  const CouplingMap cm = {{0, 1}, {1, 0}, {0, 2}, {2, 0}, {0, 3}, {3, 0},
+                          {1, 2}, {2, 1}, {2, 3}, {3, 2}, {2, 4}, {4, 2}};
+
+  const Matrix edgeWeights = {{0, 1, 9, 4, 0},
+                              {1, 0, 3, 0, 0},
+                              {9, 3, 0, 9, 9},
+                              {4, 0, 9, 0, 0},
+                              {0, 0, 9, 0, 0}};
+
+  const Matrix targetTable = {{0, 1, 4, 4, 13},
+                              {1, 0, 3, 5, 12},
+                              {4, 3, 0, 8, 9},
+                              {4, 5, 8, 0, 17},
+                              {13, 12, 9, 17, 0}};
+  Matrix       distanceTable{};
+  Dijkstra::buildTable(cm, distanceTable, edgeWeights);
+  EXPECT_EQ(distanceTable, targetTable);
+}
+
+TEST(General, DijkstraParallelRows) {
+  // a ring large enough for the rows to be computed in parallel
+  const auto  n = static_cast<std::uint16_t>(2 * Dijkstra::PARALLEL_MIN_ROWS);
+  CouplingMap cm{};
+  Matrix      edgeWeights(n, n, 0.);
+  for (std::uint16_t i = 0; i < n; ++i) {
+    const auto j = static_cast<std::uint16_t>((i + 1) % n);
+    cm.emplace(i, j);
+    edgeWeights[i][j] = 1.;
+    edgeWeights[j][i] = 1.;
+  }
+
+  Matrix distanceTable{};
+  Dijkstra::buildTable(cm, distanceTable, edgeWeights, 4);
+  for (std::uint16_t i = 0; i < n; ++i) {
+    for (std::uint16_t j = 0; j < n; ++j) {
+      const auto d = i < j ? j - i : i - j;
+      EXPECT_EQ(distanceTable[i][j], std::min(d, n - d));
+    }
+  }
+
+  std::vector<Matrix> edgeSkipTables{};
+  Dijkstra::buildEdgeSkipTable(cm, edgeSkipTables, edgeWeights, 4);
+  // skipping k edges of the ring in each direction
+  EXPECT_EQ(edgeSkipTables.size(), n / 2);
+  EXPECT_EQ(edgeSkipTables[3][0][n / 2], n / 2 - 3);
+
+  // the same tables are computed sequentially
+  Matrix sequentialTable{};
+  Dijkstra::buildTable(cm, sequentialTable, edgeWeights);
+  EXPECT_EQ(sequentialTable, distanceTable);
+  std::vector<Matrix> sequentialTables{};
+  Dijkstra::buildEdgeSkipTable(cm, sequentialTables, edgeWeights);
+  EXPECT_EQ(sequentialTables, edgeSkipTables);
+}
+
+TEST(General, DijkstraUpdateEdgeSkipTable) {
+  // a ladder of two rails with rungs at every qubit pair
+  const auto  n = static_cast<std::uint16_t>(2 * Dijkstra::PARALLEL_MIN_ROWS);
+  CouplingMap cm{};
+  Matrix      edgeWeights(n, n, 0.);
+  const auto  connect = [&](std::uint16_t q1, std::uint16_t q2, double w) {
+    cm.emplace(q1, q2);
+    cm.emplace(q2, q1);
+    edgeWeights[q1][q2] = w;
+    edgeWeights[q2][q1] = w;
+  };
+  for (std::uint16_t i = 0; i < n / 2; ++i) {
+    connect(i, static_cast<std::uint16_t>(i + n / 2), 1. + i % 3);
+    if (i + 1 < n / 2) {
+      connect(i, static_cast<std::uint16_t>(i + 1), 2.);
+      connect(static_cast<std::uint16_t>(i + n / 2),
+              static_cast<std::uint16_t>(i + 1 + n / 2), 2. + i % 2);
+    }
+  }
+
+  std::vector<Matrix> edgeSkipTables{};
+  Dijkstra::buildEdgeSkipTable(cm, edgeSkipTables, edgeWeights);
+  const auto tables = edgeSkipTables.size();
+
+  // a more expensive and a cheaper rung
+  Matrix updatedWeights          = edgeWeights;
+  updatedWeights[5][5 + n / 2]   = 6.;
+  updatedWeights[5 + n / 2][5]   = 6.;
+  updatedWeights[50][50 + n / 2] = 2.5;
+  updatedWeights[50 + n / 2][50] = 2.5;
+  const auto recomputed = Dijkstra::updateEdgeSkipTable(
+      cm, edgeSkipTables, edgeWeights, updatedWeights, 4);
+  EXPECT_LT(recomputed, n * tables);
+
+  std::vector<Matrix> targetTables{};
+  Dijkstra::buildEdgeSkipTable(cm, targetTables, updatedWeights);
+  ASSERT_EQ(edgeSkipTables.size(), targetTables.size());
+  for (std::size_t k = 0; k < targetTables.size(); ++k) {
+    EXPECT_EQ(edgeSkipTables[k], targetTables[k]);
+  }
+
+  // nothing to do without changes
+  EXPECT_EQ(Dijkstra::updateEdgeSkipTable(cm, edgeSkipTables, updatedWeights,
+                                          updatedWeights),
+            0);
+}
+
 TEST(General, DijkstraCNOTReversal) {
   /*
   0 -> 1 <- 2 -> 3 -> 4
@@ -4,11 +4,14 @@
 //
 
 #include "heuristic/HeuristicMapper.hpp"
+#include "heuristic/PortfolioMapper.hpp"
+#include "heuristic/SabreMapper.hpp"
 #include "nlohmann/json.hpp"
 
 #include "gtest/gtest.h"
 #include <filesystem>
 #include <fstream>
+#include <map>
 #include <sstream>
 #include <stack>
 #include <string>
@@ -41,6 +44,110 @@ std::size_t getFinalNodeFromDatalog(std::string dataLoggingPath,
   return finalNodeId;
 }
 
+/**
+ * @brief re-imports the circuit mapped by `mapper` and checks that all CNOTs
+ * (in the given direction) and SWAPs act on connected qubits of `arch`
+ *
+ * @return the number of CNOTs and SWAPs in the mapped circuit
+ */
+std::pair<std::size_t, std::size_t>
+expectCnotsOnCouplingMap(Mapper& mapper, const Architecture& arch,
+                         const bool directed) {
+  std::stringstream qasm{};
+  mapper.dumpResult(qasm, qc::Format::OpenQASM3);
+  auto qcMapped = qc::QuantumComputation();
+  qcMapped.import(qasm, qc::Format::OpenQASM3);
+  std::size_t cnots = 0;
+  std::size_t swaps = 0;
+  for (const auto& op : qcMapped) {
+    if (op->getType() == SWAP) {
+      const Edge edge{static_cast<std::uint16_t>(op->getTargets().front()),
+                      static_cast<std::uint16_t>(op->getTargets().back())};
+      EXPECT_TRUE(arch.isEdgeConnected(edge, false));
+      ++swaps;
+    } else if (op->getType() == qc::X && op->getNcontrols() == 1) {
+      const Edge edge{
+          static_cast<std::uint16_t>(op->getControls().begin()->qubit),
+          static_cast<std::uint16_t>(op->getTargets().front())};
+      EXPECT_TRUE(arch.isEdgeConnected(edge, directed));
+      ++cnots;
+    }
+  }
+  return {cnots, swaps};
+}
+
+/**
+ * @brief circuit on `nqubits` qubits consisting of `repetitions` rounds of the
+ * given CNOTs (control, target), followed by a measurement of each qubit
+ */
+qc::QuantumComputation
+measuredCnots(const std::size_t                                   nqubits,
+              const std::vector<std::pair<qc::Qubit, qc::Qubit>>& cnots,
+              const std::size_t repetitions = 1) {
+  qc::QuantumComputation qc{nqubits, nqubits};
+  for (std::size_t i = 0; i < repetitions; ++i) {
+    for (const auto& [control, target] : cnots) {
+      qc.cx(control, target);
+    }
+  }
+  for (std::size_t i = 0; i < nqubits; ++i) {
+    qc.measure(static_cast<qc::Qubit>(i), i);
+  }
+  return qc;
+}
+
+/**
+ * @brief settings which isolate the search of the heuristic mapper on the
+ * given layering, i.e. with an identity initial layout and without lookahead,
+ * automatic layer splits or optimizations before and after mapping
+ */
+Configuration searchOnlySettings(const Layering layering) {
+  Configuration settings{};
+  settings.layering                 = layering;
+  settings.initialLayout            = InitialLayout::Identity;
+  settings.preMappingOptimizations  = false;
+  settings.postMappingOptimizations = false;
+  settings.lookaheadHeuristic       = LookaheadHeuristic::None;
+  settings.automaticLayerSplits     = false;
+  settings.debug                    = true;
+  return settings;
+}
+
+/**
+ * @brief three rounds of CNOTs between 7 qubits, most of which are far apart
+ * on IBM QX5
+ */
+qc::QuantumComputation farApartCnots() {
+  return measuredCnots(7, {{0, 6}, {1, 5}, {2, 4}, {3, 0}, {6, 2}}, 3);
+}
+
+/**
+ * @brief a single layer of CNOTs between the far apart qubits i and i + 8 of
+ * IBM QX5, for which the hash-distributed search does not finish within any
+ * reasonable time
+ */
+qc::QuantumComputation distantCnotLayer() {
+  std::vector<std::pair<qc::Qubit, qc::Qubit>> cnots{};
+  for (qc::Qubit i = 0; i < 8; ++i) {
+    cnots.emplace_back(i, i + 8);
+  }
+  return measuredCnots(16, cnots);
+}
+
+/**
+ * @brief rows of a matrix as nested vectors, i.e. in the format in which
+ * matrices are logged
+ */
+template <typename T>
+std::vector<std::vector<T>> nestedRows(const FlatMatrix<T>& matrix) {
+  std::vector<std::vector<T>> rows{};
+  rows.reserve(matrix.rows());
+  for (std::size_t i = 0; i < matrix.rows(); ++i) {
+    rows.emplace_back(matrix[i].begin(), matrix[i].end());
+  }
+  return rows;
+}
+
 /**
  * @brief parses all nodes in a given layer from a data log and enter them
  * into `nodes` with each node at the position corresponding to its id.
@@ -127,10 +234,12 @@ void parseNodesFromDatalog(std::string dataLoggingPath, std::size_t layer,
     if (std::getline(lineStream, col, ';')) {
       std::stringstream qubitMapBuffer(col);
       std::string       entry;
-      for (std::size_t i = 0; std::getline(qubitMapBuffer, entry, ','); ++i) {
-        auto qubit        = static_cast<std::int16_t>(std::stoi(entry));
-        node.qubits.at(i) = qubit;
-        if (qubit >= 0) {
+      while (std::getline(qubitMapBuffer, entry, ',')) {
+        node.qubits.emplace_back(static_cast<std::int16_t>(std::stoi(entry)));
+      }
+      node.locations.assign(node.qubits.size(), -1);
+      for (std::size_t i = 0; i < node.qubits.size(); ++i) {
+        if (const auto qubit = node.qubits.at(i); qubit >= 0) {
           node.locations.at(static_cast<std::size_t>(qubit)) =
               static_cast<std::int16_t>(i);
         }
@@ -204,7 +313,7 @@ TEST_F(InternalsTest, NodeCostCalculation) {
   results.config.lookaheadHeuristic = LookaheadHeuristic::None;
   results.config.layering           = Layering::Disjoint2qBlocks;
 
-  architecture->loadCouplingMap(5, {{0, 1}, {1, 2}, {3, 1}, {4, 3}});
+  defaultArch.loadCouplingMap(5, {{0, 1}, {1, 2}, {3, 1}, {4, 3}});
   qc = qc::QuantumComputation{5};
   // layer 0 distances:
   // 0-1: 2 swaps & 2 reversals
@@ -288,7 +397,7 @@ TEST_F(InternalsTest, NodeLookaheadCalculation) {
   results.config.lookaheadHeuristic = LookaheadHeuristic::None;
   results.config.layering           = Layering::Disjoint2qBlocks;
 
-  architecture->loadCouplingMap(5, {{0, 1}, {1, 2}, {3, 1}, {4, 3}});
+  defaultArch.loadCouplingMap(5, {{0, 1}, {1, 2}, {3, 1}, {4, 3}});
   qc = qc::QuantumComputation{5};
   // layer 0 distances:
   // 0-1: 2 swaps & 2 reversals
@@ -405,6 +514,325 @@ TEST_F(InternalsTest, NodeLookaheadCalculation) {
               FLOAT_TOLERANCE);
 }
 
+TEST_F(InternalsTest, NodeFidelityLookaheadCalculation) {
+  results.config.heuristic          = Heuristic::FidelityBestLocation;
+  results.config.lookaheadHeuristic = LookaheadHeuristic::None;
+  results.config.layering           = Layering::IndividualGates;
+
+  defaultArch.loadCouplingMap(
+      4, {{0, 1}, {1, 0}, {1, 2}, {2, 1}, {1, 3}, {3, 1}});
+  auto props = Architecture::Properties();
+  for (std::uint16_t q = 0; q < 4; ++q) {
+    props.setSingleQubitErrorRate(q, "x", 0.1);
+  }
+  props.setTwoQubitErrorRate(0, 1, 0.05);
+  props.setTwoQubitErrorRate(1, 0, 0.05);
+  props.setTwoQubitErrorRate(1, 2, 0.1);
+  props.setTwoQubitErrorRate(2, 1, 0.1);
+  props.setTwoQubitErrorRate(1, 3, 0.2);
+  props.setTwoQubitErrorRate(3, 1, 0.2);
+  defaultArch.loadProperties(props);
+
+  qc = qc::QuantumComputation{4};
+  qc.cx(0, 1);
+  qc.cx(3, 2);
+  qc.cx(3, 0);
+
+  createLayers();
+  ASSERT_EQ(layers.size(), 3);
+
+  // the best edge is 0-1 for all gates
+  const auto edgeCost = architecture->getTwoQubitFidelityCost(0, 1);
+  for (const auto& view : layerViews) {
+    EXPECT_EQ(view.bestEdgeCosts, std::vector<double>{edgeCost});
+  }
+
+  HeuristicMapper::Node node(0, 0, {0, 1, 2, 3}, {0, 1, 2, 3});
+  results.config.lookaheadHeuristic = LookaheadHeuristic::FidelityBestLocation;
+  results.config.firstLookaheadFactor = 0.75;
+  results.config.lookaheadFactor      = 0.5;
+  results.config.nrLookaheads         = 2;
+  updateLookaheadPenalty(0, node);
+  EXPECT_NEAR(node.lookaheadPenalty,
+              0.75 * (edgeCost + architecture->fidelityDistance(2, 3, 1)) +
+                  0.75 * 0.5 *
+                      (edgeCost + architecture->fidelityDistance(0, 3, 1)),
+              FLOAT_TOLERANCE);
+
+  // gates already mapped next to each other are executed where they are,
+  // unmapped qubits may still be placed at the best edge
+  node.qubits    = {-1, 2, 1, 3};
+  node.locations = {-1, 2, 1, 3};
+  updateLookaheadPenalty(0, node);
+  EXPECT_NEAR(node.lookaheadPenalty,
+              0.75 * architecture->getTwoQubitFidelityCost(3, 1) +
+                  0.75 * 0.5 * edgeCost,
+              FLOAT_TOLERANCE);
+}
+
+TEST_F(InternalsTest, FidelityCostMemo) {
+  results.config.heuristic          = Heuristic::FidelityBestLocation;
+  results.config.lookaheadHeuristic = LookaheadHeuristic::None;
+  results.config.layering           = Layering::Disjoint2qBlocks;
+
+  defaultArch.loadCouplingMap(
+      4, {{0, 1}, {1, 0}, {1, 2}, {2, 1}, {1, 3}, {3, 1}});
+  auto props = Architecture::Properties();
+  for (std::uint16_t q = 0; q < 4; ++q) {
+    props.setSingleQubitErrorRate(q, "x", 0.1 * (q + 1));
+  }
+  props.setTwoQubitErrorRate(0, 1, 0.05);
+  props.setTwoQubitErrorRate(1, 0, 0.05);
+  props.setTwoQubitErrorRate(1, 2, 0.1);
+  props.setTwoQubitErrorRate(2, 1, 0.1);
+  props.setTwoQubitErrorRate(1, 3, 0.2);
+  props.setTwoQubitErrorRate(3, 1, 0.2);
+  defaultArch.loadProperties(props);
+
+  qc = qc::QuantumComputation{4};
+  qc.cx(0, 1);
+  qc.cx(1, 0);
+  qc.cx(3, 2);
+  qc.x(2);
+  qc.x(2);
+
+  createLayers();
+  ASSERT_FALSE(layers.empty());
+  resetFidelityCostMemo();
+
+  // memoized costs are identical to the costs computed from scratch for all
+  // placements (each placement is evaluated twice to also hit the memo)
+  const auto skipEdges  = fidelitySkipEdges(0);
+  const auto singleMult = singleQubitMultiplicities.at(0).at(2);
+  for (std::uint16_t p0 = 0; p0 < 4; ++p0) {
+    for (std::uint16_t p2 = 0; p2 < 4; ++p2) {
+      if (p0 == p2) {
+        continue;
+      }
+      HeuristicMapper::Node node(0, 0, {-1, -1, -1, -1}, {-1, -1, -1, -1});
+      node.locations.at(0) = static_cast<std::int16_t>(p0);
+      node.locations.at(1) = static_cast<std::int16_t>(p2);
+      node.locations.at(2) = static_cast<std::int16_t>(p2);
+      for (int i = 0; i < 2; ++i) {
+        EXPECT_DOUBLE_EQ(
+            heuristicGateCost(0, {0, 1}, {1, 1}, node).cost,
+            bestEdgeCost({1, 1}, skipEdges, p0, p2));
+        EXPECT_DOUBLE_EQ(singleQubitSavings(0, 2, node),
+                         bestQubitSavings(singleMult, skipEdges, p2));
+      }
+    }
+  }
+  EXPECT_DOUBLE_EQ(bestEdgeCost({1, 1}, skipEdges, 0, 1),
+                   2 * architecture->getTwoQubitFidelityCost(0, 1));
+  EXPECT_DOUBLE_EQ(bestQubitSavings(singleMult, skipEdges, 0), 0.);
+}
+
+TEST_F(InternalsTest, IncrementalGateCosts) {
+  results.config.layering             = Layering::Disjoint2qBlocks;
+  results.config.nrLookaheads         = 3;
+  results.config.firstLookaheadFactor = 0.75;
+  results.config.lookaheadFactor      = 0.5;
+
+  defaultArch.loadCouplingMap(6, {{0, 1}, {1, 0}, {1, 2}, {2, 1}, {2, 3},
+                                  {3, 2}, {3, 4}, {4, 3}, {4, 5}, {5, 4},
+                                  {1, 4}, {4, 1}});
+  auto props = Architecture::Properties();
+  for (std::uint16_t q = 0; q < 6; ++q) {
+    props.setSingleQubitErrorRate(q, "x", 0.01 * (q + 1));
+  }
+  double errorRate = 0.01;
+  for (const auto& [q1, q2] : defaultArch.getCouplingMap()) {
+    props.setTwoQubitErrorRate(q1, q2, errorRate);
+    errorRate += 0.007;
+  }
+  defaultArch.loadProperties(props);
+
+  qc = qc::QuantumComputation{6};
+  qc.x(4);
+  qc.cx(0, 1);
+  qc.x(0);
+  qc.cx(2, 3);
+  qc.x(3);
+  qc.cx(1, 2);
+  qc.cx(0, 3);
+  qc.cx(3, 0);
+  qc.cx(5, 1);
+  qc.cx(4, 2);
+  createLayers();
+  ASSERT_EQ(layers.size(), 3);
+
+  // qubit 5 is not mapped yet, i.e. the costs of the last lookahead layer
+  // depend on the free physical qubits
+  const std::vector<std::int16_t> rootQubits{0, 3, 1, -1, 2, 4};
+  const std::vector<std::int16_t> rootLocations{0, 2, 4, 1, 5, -1};
+
+  // the costs of a child computed from the costs cached in its parent are
+  // identical to the costs computed from scratch
+  const auto expectIncrementalCosts = [this](Node& parent, const Edge& swap) {
+    cacheGateCosts(0, parent);
+    Node incremental = parent;
+    applySWAP(swap, 0, incremental);
+    Node fromScratch             = parent;
+    fromScratch.gateCosts.nSwaps = GateCostCache::INVALID;
+    applySWAP(swap, 0, fromScratch);
+    EXPECT_EQ(incremental.costHeur, fromScratch.costHeur);
+    EXPECT_EQ(incremental.lookaheadPenalty, fromScratch.lookaheadPenalty);
+    EXPECT_EQ(incremental.costFixed, fromScratch.costFixed);
+    EXPECT_EQ(incremental.validMapping, fromScratch.validMapping);
+    return incremental;
+  };
+
+  for (const auto heuristic :
+       {Heuristic::GateCountMaxDistance, Heuristic::GateCountSumDistance,
+        Heuristic::GateCountSumDistanceMinusSharedSwaps,
+        Heuristic::GateCountMaxDistanceOrSumDistanceMinusSharedSwaps,
+        Heuristic::FidelityBestLocation}) {
+    for (const auto lookahead : {LookaheadHeuristic::None,
+                                 LookaheadHeuristic::GateCountMaxDistance,
+                                 LookaheadHeuristic::GateCountSumDistance,
+                                 LookaheadHeuristic::FidelityBestLocation}) {
+      if (lookahead != LookaheadHeuristic::None &&
+          isFidelityAware(heuristic) != isFidelityAware(lookahead)) {
+        continue;
+      }
+      SCOPED_TRACE(toString(heuristic) + " / " + toString(lookahead));
+      results.config.heuristic          = heuristic;
+      results.config.lookaheadHeuristic = lookahead;
+      tightHeur                         = isTight(heuristic);
+      fidelityAwareHeur                 = isFidelityAware(heuristic);
+      if (fidelityAwareHeur) {
+        resetFidelityCostMemo();
+      }
+
+      Node root(0, 0, rootQubits, rootLocations);
+      recalculateFixedCost(0, root);
+      updateHeuristicCost(0, root);
+      updateLookaheadPenalty(0, root);
+
+      std::vector<Edge>     candidates{};
+      std::vector<QubitSet> usedSwaps{};
+      collectExpansionCandidates(root, 0, {}, candidates, usedSwaps);
+      ASSERT_FALSE(candidates.empty());
+      for (const auto& swap : candidates) {
+        // the children of the root, and their children (from a cache that has
+        // been built incrementally itself)
+        auto              child = expectIncrementalCosts(root, swap);
+        std::vector<Edge> grandchildCandidates{};
+        collectExpansionCandidates(child, 0, {}, grandchildCandidates,
+                                   usedSwaps);
+        for (const auto& nextSwap : grandchildCandidates) {
+          expectIncrementalCosts(child, nextSwap);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(InternalsTest, LayerViewsMatchMultiplicities) {
+  results.config.layering = Layering::Disjoint2qBlocks;
+
+  defaultArch.loadCouplingMap(5, {{0, 1}, {1, 2}, {3, 1}, {4, 3}});
+  qc = qc::QuantumComputation{5};
+  qc.cx(3, 2);
+  qc.cx(0, 1);
+  qc.cx(1, 0);
+  qc.x(4);
+  qc.cx(0, 4);
+
+  const auto expectViewsMatch = [this]() {
+    ASSERT_EQ(layerViews.size(), layers.size());
+    for (std::size_t i = 0; i < layers.size(); ++i) {
+      const auto& view = layerViews.at(i);
+      ASSERT_EQ(view.edges.size(), twoQubitMultiplicities.at(i).size());
+      ASSERT_EQ(view.multiplicities.size(), view.edges.size());
+      std::size_t j = 0;
+      for (const auto& [edge, multiplicity] : twoQubitMultiplicities.at(i)) {
+        EXPECT_EQ(view.edges.at(j), edge);
+        EXPECT_EQ(view.multiplicities.at(j), multiplicity);
+        ++j;
+      }
+      for (std::uint16_t q = 0; q < architecture->getNqubits(); ++q) {
+        EXPECT_EQ(view.activeQubits.test(q), activeQubits.at(i).count(q) > 0);
+        EXPECT_EQ(view.activeQubits1QGates.test(q),
+                  activeQubits1QGates.at(i).count(q) > 0);
+        EXPECT_EQ(view.activeQubits2QGates.test(q),
+                  activeQubits2QGates.at(i).count(q) > 0);
+      }
+    }
+  };
+
+  createLayers();
+  ASSERT_EQ(layers.size(), 2);
+  EXPECT_EQ(layerViews.at(0).edges, (std::vector<Edge>{{0, 1}, {2, 3}}));
+  expectViewsMatch();
+
+  ASSERT_TRUE(isLayerSplittable(0));
+  splitLayer(0, *architecture);
+  EXPECT_EQ(layers.size(), 3);
+  expectViewsMatch();
+}
+
+TEST_F(InternalsTest, LayerWindow) {
+  results.config.layering = Layering::IndividualGates;
+
+  defaultArch.loadCouplingMap(5, {{0, 1}, {1, 2}, {3, 1}, {4, 3}});
+  qc = qc::QuantumComputation{5};
+  for (std::uint16_t i = 0; i < 4; ++i) {
+    qc.cx(i, i + 1);
+    qc.x(i);
+  }
+
+  createLayers();
+  ASSERT_EQ(layers.size(), 8);
+  const auto fullViews                = layerViews;
+  const auto fullSingleMultiplicities = singleQubitMultiplicities;
+
+  // the data of the layers is only created for the requested window
+  results.config.layerWindow = 3;
+  layers.clear();
+  createLayers();
+  ASSERT_EQ(layers.size(), 8);
+  EXPECT_TRUE(layerViews.empty());
+
+  const auto expectWindow = [&](const std::size_t begin,
+                                const std::size_t size) {
+    EXPECT_EQ(layerWindowBegin, begin);
+    ASSERT_EQ(layerViews.size(), size);
+    for (std::size_t i = begin; i < begin + size; ++i) {
+      EXPECT_EQ(getLayerView(i).edges, fullViews.at(i).edges);
+      EXPECT_EQ(getLayerView(i).multiplicities,
+                fullViews.at(i).multiplicities);
+      EXPECT_EQ(getSingleQubitMultiplicity(i), fullSingleMultiplicities.at(i));
+    }
+  };
+  loadLayers(1, 2);
+  expectWindow(1, 3);
+  // layers in the window are not created again
+  loadLayers(2, 4);
+  expectWindow(1, 3);
+  loadLayers(3, 5);
+  expectWindow(3, 3);
+  // larger requests grow the window, which stays within the circuit
+  loadLayers(4, 8);
+  expectWindow(4, 4);
+  loadLayers(7, 12);
+  expectWindow(4, 4);
+  // backwards, the window ends at the requested layers
+  loadLayers(0, 2);
+  expectWindow(0, 3);
+  EXPECT_THROW(static_cast<void>(getLayerView(5)), std::out_of_range);
+
+  // split layers are inserted into the window
+  loadLayers(4, 6);
+  expectWindow(4, 3);
+  splitLayer(5, *architecture);
+  EXPECT_EQ(layers.size(), 9);
+  EXPECT_EQ(layerViews.size(), 4);
+  EXPECT_EQ(getLayerView(5).edges, std::vector<Edge>{});
+  EXPECT_EQ(getLayerView(6).edges, std::vector<Edge>{});
+  EXPECT_EQ(getLayerView(7).edges, fullViews.at(6).edges);
+}
+
 class TestHeuristics
     : public testing::TestWithParam<std::tuple<Heuristic, std::string>> {
 protected:
@@ -1022,6 +1450,673 @@ TEST(Functionality, HeuristicBenchmark) {
               HeuristicMapper::EFFECTIVE_BRANCH_RATE_TOLERANCE);
   EXPECT_NEAR(result.heuristicBenchmark.effectiveBranchingFactor, 1.,
               HeuristicMapper::EFFECTIVE_BRANCH_RATE_TOLERANCE);
+  EXPECT_GT(layerResults0.peakMemory, 0);
+  EXPECT_GT(layerResults1.peakMemory, 0);
+  EXPECT_EQ(result.heuristicBenchmark.peakMemory,
+            std::max(layerResults0.peakMemory, layerResults1.peakMemory));
+}
+
+TEST(Functionality, NodeArena) {
+  NodeArena arena{};
+  arena.reset(3);
+
+  const std::array<std::int16_t, 3> rootQubits{0, 1, -1};
+  NodeArena::Entry                  root{};
+  root.costHeur = 2.;
+  root.hash     = arena.hashMapping(rootQubits.data());
+  const auto rootIndex = arena.add(root, rootQubits.data());
+
+  const std::array<std::int16_t, 3> childQubits{1, 0, -1};
+  NodeArena::Entry                  child{};
+  child.swap      = Exchange(0, 1, qc::OpType::SWAP);
+  child.parent    = rootIndex;
+  child.costFixed = 1.;
+  child.hash      = root.hash ^ arena.hashExchange(0, 1, 0, 1);
+  const auto childIndex = arena.add(child, childQubits.data());
+
+  const std::array<std::int16_t, 3> grandchildQubits{1, -1, 0};
+  NodeArena::Entry                  grandchild{};
+  grandchild.swap   = Exchange(1, 2, qc::OpType::SWAP);
+  grandchild.parent = childIndex;
+  grandchild.hash   = child.hash ^ arena.hashExchange(1, 2, 0, -1);
+  const auto grandchildIndex = arena.add(grandchild, grandchildQubits.data());
+
+  EXPECT_EQ(arena.size(), 3);
+  EXPECT_EQ(arena.at(rootIndex).getTotalCost(), 2.);
+  EXPECT_EQ(arena.at(childIndex).getTotalFixedCost(), 1.);
+  EXPECT_TRUE(std::equal(grandchildQubits.begin(), grandchildQubits.end(),
+                         arena.mapping(grandchildIndex)));
+  // incrementally updated hashes match the ones computed from scratch
+  EXPECT_EQ(arena.at(childIndex).hash, arena.hashMapping(childQubits.data()));
+  EXPECT_EQ(arena.at(grandchildIndex).hash,
+            arena.hashMapping(grandchildQubits.data()));
+  EXPECT_NE(arena.at(rootIndex).hash, arena.at(childIndex).hash);
+  // exchanging the same qubits again restores the original hash
+  EXPECT_EQ(child.hash ^ arena.hashExchange(0, 1, 1, 0), root.hash);
+
+  std::vector<Exchange> swaps{};
+  arena.collectSwaps(grandchildIndex, swaps);
+  ASSERT_EQ(swaps.size(), 2);
+  EXPECT_EQ(swaps[0].first, 0);
+  EXPECT_EQ(swaps[0].second, 1);
+  EXPECT_EQ(swaps[1].first, 1);
+  EXPECT_EQ(swaps[1].second, 2);
+  arena.collectSwaps(rootIndex, swaps);
+  EXPECT_TRUE(swaps.empty());
+
+  // compacting keeps the ancestors of kept nodes
+  const auto newIndex = arena.compact({grandchildIndex});
+  EXPECT_EQ(arena.size(), 3);
+  EXPECT_EQ(newIndex[grandchildIndex], grandchildIndex);
+  const std::array<std::int16_t, 3> otherQubits{-1, 1, 0};
+  NodeArena::Entry                  other{};
+  other.swap   = Exchange(0, 2, qc::OpType::SWAP);
+  other.parent = rootIndex;
+  other.hash   = arena.hashMapping(otherQubits.data());
+  const auto otherIndex = arena.add(other, otherQubits.data());
+  const auto compacted  = arena.compact({rootIndex, otherIndex});
+  EXPECT_EQ(arena.size(), 2);
+  EXPECT_EQ(compacted[childIndex], NodeArena::NO_PARENT);
+  EXPECT_EQ(compacted[grandchildIndex], NodeArena::NO_PARENT);
+  ASSERT_EQ(compacted[otherIndex], 1);
+  EXPECT_EQ(arena.at(1).parent, compacted[rootIndex]);
+  EXPECT_TRUE(std::equal(otherQubits.begin(), otherQubits.end(),
+                         arena.mapping(1)));
+  arena.collectSwaps(1, swaps);
+  ASSERT_EQ(swaps.size(), 1);
+  EXPECT_EQ(swaps[0].first, 0);
+  EXPECT_EQ(swaps[0].second, 2);
+
+  arena.discardLast();
+  EXPECT_EQ(arena.size(), 1);
+
+  const auto memory = arena.memoryUsage();
+  arena.reset(3);
+  EXPECT_TRUE(arena.empty());
+  // memory is kept for the next search
+  EXPECT_EQ(arena.memoryUsage(), memory);
+}
+
+TEST(Functionality, MemoryBoundedSearch) {
+  const auto qc = measuredCnots(16, {{0, 8}, {3, 12}, {5, 14}, {1, 9}});
+  Architecture ibmQX5{};
+  ibmQX5.loadCouplingMap(AvailableArchitecture::IbmQx5);
+
+  auto settings = searchOnlySettings(Layering::IndividualGates);
+
+  auto mapper = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+  mapper->map(settings);
+  const auto unbounded = mapper->getResults();
+
+  // a budget that is never reached does not change the result
+  settings.memoryBoundedSearch       = true;
+  settings.memoryBoundedSearchBudget = std::numeric_limits<std::size_t>::max();
+  mapper = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+  mapper->map(settings);
+  const auto generous = mapper->getResults();
+  EXPECT_EQ(generous.output.swaps, unbounded.output.swaps);
+  EXPECT_EQ(generous.heuristicBenchmark.expandedNodes,
+            unbounded.heuristicBenchmark.expandedNodes);
+  for (const auto& layer : generous.layerHeuristicBenchmark) {
+    EXPECT_EQ(layer.prunings, 0);
+  }
+
+  // a budget that is always exceeded degrades the search to a greedy search
+  settings.memoryBoundedSearchBudget    = 1;
+  settings.memoryBoundedSearchBeamWidth = 1;
+  mapper = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+  mapper->map(settings);
+  const auto& bounded = mapper->getResults();
+  EXPECT_GE(bounded.output.swaps, unbounded.output.swaps);
+  std::size_t prunings = 0;
+  for (const auto& layer : bounded.layerHeuristicBenchmark) {
+    EXPECT_EQ(layer.prunings, layer.expandedNodes);
+    prunings += layer.prunings;
+  }
+  EXPECT_GT(prunings, 0);
+
+  // the mapped circuit only contains gates on connected qubits
+  expectCnotsOnCouplingMap(*mapper, ibmQX5, false);
+
+  settings.memoryBoundedSearchBeamWidth = 0;
+  mapper = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+  EXPECT_THROW(mapper->map(settings), QMAPException);
+}
+
+TEST(Functionality, HashDistributedSearch) {
+  const auto   qc = measuredCnots(16, {{0, 8}, {3, 12}});
+  Architecture ibmQX5{};
+  ibmQX5.loadCouplingMap(AvailableArchitecture::IbmQx5);
+
+  auto settings = searchOnlySettings(Layering::Disjoint2qBlocks);
+
+  auto mapper = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+  mapper->map(settings);
+  const auto sequential = mapper->getResults();
+  ASSERT_EQ(sequential.layerHeuristicBenchmark.size(), 1);
+
+  settings.searchEngine = SearchEngine::HashDistributedAStar;
+  for (const std::size_t nThreads : {1U, 4U}) {
+    settings.nThreads = nThreads;
+    mapper            = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+    mapper->map(settings);
+    const auto& distributed = mapper->getResults();
+
+    // the search is optimal w.r.t. the admissible heuristic, i.e. it finds a
+    // solution of the same cost (but not necessarily the same solution)
+    EXPECT_EQ(distributed.output.swaps, sequential.output.swaps);
+    ASSERT_EQ(distributed.layerHeuristicBenchmark.size(), 1);
+    EXPECT_EQ(distributed.layerHeuristicBenchmark.front().solutionDepth,
+              sequential.layerHeuristicBenchmark.front().solutionDepth);
+    EXPECT_GT(distributed.heuristicBenchmark.expandedNodes, 0);
+    expectCnotsOnCouplingMap(*mapper, ibmQX5, false);
+  }
+
+  settings.earlyTermination      = EarlyTermination::ExpandedNodes;
+  settings.earlyTerminationLimit = 10;
+  mapper = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+  EXPECT_THROW(mapper->map(settings), QMAPException);
+}
+
+TEST(Functionality, WarmStartSearch) {
+  qc::QuantumComputation qc{5, 5};
+  qc.cx(0, 1);
+  qc.cx(0, 1);
+  qc.cx(2, 3);
+  qc.cx(0, 4);
+  qc.cx(0, 4);
+  qc.cx(4, 1);
+  qc.cx(2, 3);
+  for (std::size_t i = 0; i < 5; ++i) {
+    qc.measure(static_cast<qc::Qubit>(i), i);
+  }
+  Architecture arch{5, {{0, 1},
+                        {1, 0},
+                        {1, 2},
+                        {2, 1},
+                        {2, 3},
+                        {3, 2},
+                        {3, 4},
+                        {4, 3}}};
+
+  Configuration settings{};
+  settings.layering                 = Layering::IndividualGates;
+  settings.initialLayout            = InitialLayout::Identity;
+  settings.preMappingOptimizations  = false;
+  settings.postMappingOptimizations = false;
+  settings.lookaheadHeuristic       = LookaheadHeuristic::None;
+  settings.swapOnFirstLayer         = true;
+  settings.debug                    = true;
+
+  auto mapper = std::make_unique<HeuristicMapper>(qc, arch);
+  mapper->map(settings);
+  const auto        cold = mapper->getResults();
+  std::stringstream coldQasm{};
+  mapper->dumpResult(coldQasm, qc::Format::OpenQASM3);
+  EXPECT_EQ(cold.heuristicBenchmark.skippedLayers, 0);
+  EXPECT_GT(cold.heuristicBenchmark.layersPerSecond, 0.);
+
+  // without lookahead on a bidirectional architecture, no swap can improve a
+  // layer which is already satisfied, i.e. the result does not change
+  settings.warmStartSearch = true;
+  mapper                   = std::make_unique<HeuristicMapper>(qc, arch);
+  mapper->map(settings);
+  const auto&       warm = mapper->getResults();
+  std::stringstream warmQasm{};
+  mapper->dumpResult(warmQasm, qc::Format::OpenQASM3);
+  EXPECT_EQ(warm.output.swaps, cold.output.swaps);
+  EXPECT_EQ(warmQasm.str(), coldQasm.str());
+  EXPECT_GT(warm.heuristicBenchmark.skippedLayers, 0);
+  EXPECT_EQ(warm.heuristicBenchmark.expandedNodes,
+            cold.heuristicBenchmark.expandedNodes);
+  EXPECT_EQ(warm.layerHeuristicBenchmark.size(),
+            cold.layerHeuristicBenchmark.size());
+  EXPECT_TRUE(warm.json()["config"]["settings"]["warm_start_search"]);
+}
+
+TEST(Functionality, LayerWindow) {
+  qc::QuantumComputation qc{7, 7};
+  for (std::size_t i = 0; i < 10; ++i) {
+    qc.cx(0, 6);
+    qc.h(3);
+    qc.cx(1, 5);
+    qc.cx(2, 4);
+    qc.x(6);
+    qc.cx(3, 0);
+    qc.cx(6, 2);
+  }
+  for (std::size_t i = 0; i < 7; ++i) {
+    qc.measure(static_cast<qc::Qubit>(i), i);
+  }
+  Architecture ibmQX5{};
+  ibmQX5.loadCouplingMap(AvailableArchitecture::IbmQx5);
+
+  Configuration settings{};
+  settings.layering                            = Layering::DisjointQubits;
+  settings.initialLayout                       = InitialLayout::Dynamic;
+  settings.iterativeBidirectionalRouting       = true;
+  settings.iterativeBidirectionalRoutingPasses = 2;
+  settings.nrLookaheads                        = 3;
+
+  // streaming the layers does not change the result, independent of the size
+  // of the window (even if it is smaller than the lookahead)
+  for (const auto method : {Method::Heuristic, Method::Sabre}) {
+    settings.method = method;
+    std::optional<std::string> reference{};
+    for (const std::size_t window : {0U, 1U, 5U}) {
+      settings.layerWindow = window;
+      std::unique_ptr<HeuristicMapper> mapper{};
+      if (method == Method::Sabre) {
+        mapper = std::make_unique<SabreMapper>(qc, ibmQX5);
+      } else {
+        mapper = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+      }
+      mapper->map(settings);
+      std::stringstream qasm{};
+      mapper->dumpResult(qasm, qc::Format::OpenQASM3);
+      if (!reference) {
+        reference = qasm.str();
+      } else {
+        EXPECT_EQ(qasm.str(), *reference);
+        EXPECT_EQ(mapper->json()["config"]["settings"]["layer_window"],
+                  window);
+      }
+    }
+  }
+
+  settings.method                              = Method::Heuristic;
+  settings.iterativeBidirectionalRoutingChains = 2;
+  auto mapper = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+  EXPECT_THROW(mapper->map(settings), QMAPException);
+}
+
+TEST(Functionality, IterativeBidirectionalRoutingChains) {
+  const auto   qc = farApartCnots();
+  Architecture ibmQX5{};
+  ibmQX5.loadCouplingMap(AvailableArchitecture::IbmQx5);
+
+  Configuration settings{};
+  settings.initialLayout                       = InitialLayout::Dynamic;
+  settings.iterativeBidirectionalRouting       = true;
+  settings.iterativeBidirectionalRoutingPasses = 3;
+  settings.iterativeBidirectionalRoutingChains = 4;
+
+  // the chains are independent of each other, i.e. the result does not depend
+  // on the number of threads
+  std::optional<std::string> reference{};
+  std::size_t                referenceSwaps = 0;
+  for (const std::size_t nThreads : {1U, 4U}) {
+    settings.nThreads = nThreads;
+    auto mapper       = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+    mapper->map(settings);
+    const auto&       results = mapper->getResults();
+    std::stringstream qasm{};
+    mapper->dumpResult(qasm, qc::Format::OpenQASM3);
+    if (!reference) {
+      reference      = qasm.str();
+      referenceSwaps = results.output.swaps;
+    } else {
+      EXPECT_EQ(qasm.str(), *reference);
+      EXPECT_EQ(results.output.swaps, referenceSwaps);
+    }
+    EXPECT_EQ(results.json()["config"]["settings"]
+                             ["iterative_bidirectional_routing"]["chains"],
+              4);
+    expectCnotsOnCouplingMap(*mapper, ibmQX5, true);
+  }
+
+  settings.teleportationQubits = 2;
+  auto mapper = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+  EXPECT_THROW(mapper->map(settings), QMAPException);
+}
+
+TEST(Functionality, Portfolio) {
+  const auto   qc = farApartCnots();
+  Architecture ibmQX5{};
+  ibmQX5.loadCouplingMap(AvailableArchitecture::IbmQx5);
+
+  Configuration settings{};
+  settings.method = Method::Portfolio;
+  auto mapper     = std::make_unique<PortfolioMapper>(qc, ibmQX5);
+  mapper->map(settings);
+  const auto& results = mapper->getResults();
+  const auto  members = PortfolioMapper::portfolioFor(settings);
+  ASSERT_EQ(results.portfolio.size(), members.size());
+  EXPECT_EQ(results.json()["statistics"]["portfolio"].size(), members.size());
+
+  // the best result is kept and runs are only cancelled if they are worse
+  std::size_t selected = 0;
+  for (std::size_t i = 0; i < members.size(); ++i) {
+    auto heuristicMapper = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+    heuristicMapper->map(members[i]);
+    const auto& output = heuristicMapper->getResults().output;
+    const auto& info   = results.portfolio[i];
+    if (info.status == "finished") {
+      EXPECT_EQ(info.swaps, output.swaps);
+    } else {
+      EXPECT_EQ(info.status, "cancelled");
+      EXPECT_GT(output.swaps, results.output.swaps);
+    }
+    EXPECT_GE(output.swaps, results.output.swaps);
+    if (info.selected) {
+      ++selected;
+      EXPECT_EQ(info.swaps, results.output.swaps);
+    }
+  }
+  EXPECT_EQ(selected, 1);
+  expectCnotsOnCouplingMap(*mapper, ibmQX5, true);
+
+  // failing configurations do not affect the others
+  Configuration invalid{};
+  invalid.layering   = Layering::OddGates;
+  settings.portfolio = {Configuration{}, invalid};
+  mapper->map(settings);
+  EXPECT_EQ(mapper->getResults().portfolio.at(0).status, "finished");
+  EXPECT_EQ(mapper->getResults().portfolio.at(1).status, "failed");
+  EXPECT_FALSE(mapper->getResults().portfolio.at(1).error.empty());
+
+  settings.portfolio = {invalid};
+  EXPECT_THROW(mapper->map(settings), QMAPException);
+
+  invalid.method     = Method::Exact;
+  settings.portfolio = {invalid};
+  EXPECT_THROW(mapper->map(settings), QMAPException);
+}
+
+TEST(Functionality, PortfolioDistributedSearchWithinBudget) {
+  const auto   qc = distantCnotLayer();
+  Architecture ibmQX5{};
+  ibmQX5.loadCouplingMap(AvailableArchitecture::IbmQx5);
+
+  auto distributed         = searchOnlySettings(Layering::Disjoint2qBlocks);
+  distributed.searchEngine = SearchEngine::HashDistributedAStar;
+  distributed.nThreads     = 2;
+
+  Configuration settings{};
+  settings.method    = Method::Portfolio;
+  settings.timeout   = 500;
+  settings.portfolio = {Configuration{}, distributed};
+  auto mapper        = std::make_unique<PortfolioMapper>(qc, ibmQX5);
+  mapper->map(settings);
+  const auto& results = mapper->getResults();
+  ASSERT_EQ(results.portfolio.size(), 2);
+  EXPECT_EQ(results.portfolio[0].status, "finished");
+  EXPECT_FALSE(results.portfolio[0].timeout);
+  EXPECT_TRUE(results.portfolio[0].selected);
+  // the distributed search cannot finish its layer within the budget, so it
+  // either returns a degraded result or stops once it is beaten
+  if (results.portfolio[1].status == "finished") {
+    EXPECT_TRUE(results.portfolio[1].timeout);
+  } else {
+    EXPECT_EQ(results.portfolio[1].status, "cancelled");
+  }
+  EXPECT_FALSE(results.timeout);
+  expectCnotsOnCouplingMap(*mapper, ibmQX5, true);
+
+  // a run that exhausts the budget still yields a result
+  settings.timeout   = 200;
+  settings.portfolio = {distributed};
+  mapper->map(settings);
+  ASSERT_EQ(results.portfolio.size(), 1);
+  EXPECT_EQ(results.portfolio[0].status, "finished");
+  EXPECT_TRUE(results.portfolio[0].timeout);
+  EXPECT_TRUE(results.timeout);
+  EXPECT_FALSE(results.degradedLayers.empty());
+  EXPECT_EQ(expectCnotsOnCouplingMap(*mapper, ibmQX5, true).first, 8);
+}
+
+TEST(Functionality, Deadline) {
+  const auto   qc = farApartCnots();
+  Architecture ibmQX5{};
+  ibmQX5.loadCouplingMap(AvailableArchitecture::IbmQx5);
+
+  Configuration settings{};
+  settings.swapOnFirstLayer = true;
+  for (const auto layering :
+       {Layering::IndividualGates, Layering::DisjointQubits}) {
+    settings.layering = layering;
+    settings.timeout  = 3600000;
+    auto mapper       = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+    mapper->map(settings);
+    EXPECT_TRUE(mapper->getResults().degradedLayers.empty());
+    EXPECT_FALSE(mapper->getResults().timeout);
+
+    // with an expired deadline, only layers which are not yet satisfied are
+    // routed greedily
+    settings.timeout = 0;
+    mapper->map(settings);
+    const auto& results = mapper->getResults();
+    EXPECT_EQ(results.timeout, !results.degradedLayers.empty());
+    EXPECT_TRUE(std::is_sorted(results.degradedLayers.begin(),
+                               results.degradedLayers.end()));
+    EXPECT_EQ(results.json()["statistics"]["degraded_layers"].size(),
+              results.degradedLayers.size());
+
+    const auto cnots = expectCnotsOnCouplingMap(*mapper, ibmQX5, true).first;
+    EXPECT_GE(cnots, qc.getNops() - 7);
+  }
+
+  // the gates of the first three layers are adjacent under the identity
+  // layout, so the expired deadline only affects the last layer
+  qc::QuantumComputation satisfied{9};
+  satisfied.cx(0, 1);
+  satisfied.cx(1, 2);
+  satisfied.cx(2, 3);
+  satisfied.cx(0, 8);
+  auto search = searchOnlySettings(Layering::IndividualGates);
+  for (const auto engine :
+       {SearchEngine::AStar, SearchEngine::HashDistributedAStar}) {
+    search.searchEngine = engine;
+    search.nThreads     = 2;
+    search.timeout      = 0;
+    auto mapper         = std::make_unique<HeuristicMapper>(satisfied, ibmQX5);
+    mapper->map(search);
+    const auto& results = mapper->getResults();
+    EXPECT_TRUE(results.timeout);
+    EXPECT_EQ(results.degradedLayers, std::vector<std::size_t>{3});
+    EXPECT_GT(results.output.swaps, 0);
+    expectCnotsOnCouplingMap(*mapper, ibmQX5, true);
+  }
+
+  // the distributed search stops within a layer, which it does not finish
+  auto distributed         = searchOnlySettings(Layering::Disjoint2qBlocks);
+  distributed.searchEngine = SearchEngine::HashDistributedAStar;
+  distributed.nThreads     = 2;
+  distributed.timeout      = 200;
+  auto mapper = std::make_unique<HeuristicMapper>(distantCnotLayer(), ibmQX5);
+  mapper->map(distributed);
+  const auto& results = mapper->getResults();
+  EXPECT_TRUE(results.timeout);
+  EXPECT_FALSE(results.degradedLayers.empty());
+  EXPECT_EQ(expectCnotsOnCouplingMap(*mapper, ibmQX5, true).first, 8);
+}
+
+TEST(Functionality, GraphIsomorphismInitialLayout) {
+  // the interaction graph is a ring of 6 qubits, which is a subgraph of the
+  // ladder of IBM QX5
+  qc::QuantumComputation qc{6, 6};
+  for (std::size_t i = 0; i < 2; ++i) {
+    qc.cx(0, 3);
+    qc.cx(3, 5);
+    qc.cx(5, 1);
+    qc.cx(1, 4);
+    qc.cx(4, 2);
+    qc.cx(2, 0);
+  }
+  for (std::size_t i = 0; i < 6; ++i) {
+    qc.measure(static_cast<qc::Qubit>(i), i);
+  }
+  Architecture ibmQX5{};
+  ibmQX5.loadCouplingMap(AvailableArchitecture::IbmQx5);
+
+  Configuration settings{};
+  settings.initialLayout      = InitialLayout::GraphIsomorphism;
+  settings.lookaheadHeuristic = LookaheadHeuristic::None;
+  auto mapper                 = std::make_unique<HeuristicMapper>(qc, ibmQX5);
+  mapper->map(settings);
+  EXPECT_EQ(mapper->getResults().output.swaps, 0);
+  EXPECT_EQ(mapper->getResults().json()["config"]["settings"]["initial_layout"],
+            "graph_isomorphism");
+
+  // a path whose heaviest qubit is placed greedily at the center of a star
+  // with one longer arm, which leaves no free neighbor for its last qubit
+  qc::QuantumComputation path{4};
+  for (std::size_t i = 0; i < 3; ++i) {
+    path.cx(0, 1);
+  }
+  path.cx(1, 2);
+  path.cx(1, 2);
+  path.cx(2, 3);
+  Architecture spider{
+      5, {{0, 1}, {1, 0}, {0, 2}, {2, 0}, {0, 3}, {3, 0}, {1, 4}, {4, 1}}};
+  auto search          = searchOnlySettings(Layering::IndividualGates);
+  search.initialLayout = InitialLayout::GraphIsomorphism;
+  mapper               = std::make_unique<HeuristicMapper>(path, spider);
+  mapper->map(search);
+  EXPECT_EQ(mapper->getResults().output.swaps, 0);
+
+  // without any budget, the greedy layout is used as it is
+  search.initialLayoutTimeout = 0;
+  mapper->map(search);
+  EXPECT_GT(mapper->getResults().output.swaps, 0);
+  EXPECT_TRUE(mapper->getResults().degradedLayers.empty());
+  EXPECT_EQ(mapper->getResults().json()["config"]["settings"]
+                                       ["initial_layout_timeout"],
+            0);
+  expectCnotsOnCouplingMap(*mapper, spider, true);
+}
+
+TEST(Functionality, GraphIsomorphismInitialLayoutFidelity) {
+  Architecture architecture{};
+  architecture.loadCouplingMap(
+      4, {{0, 1}, {1, 0}, {1, 2}, {2, 1}, {2, 3}, {3, 2}});
+  auto props = Architecture::Properties();
+  for (std::uint16_t q = 0; q < 4; ++q) {
+    props.setSingleQubitErrorRate(q, "x", 0.01);
+  }
+  props.setTwoQubitErrorRate(0, 1, 0.1);
+  props.setTwoQubitErrorRate(1, 0, 0.1);
+  props.setTwoQubitErrorRate(1, 2, 0.1);
+  props.setTwoQubitErrorRate(2, 1, 0.1);
+  props.setTwoQubitErrorRate(2, 3, 0.01);
+  props.setTwoQubitErrorRate(3, 2, 0.01);
+  architecture.loadProperties(props);
+
+  qc::QuantumComputation qc{2};
+  for (std::size_t i = 0; i < 3; ++i) {
+    qc.cx(0, 1);
+  }
+
+  Configuration settings{};
+  settings.heuristic          = Heuristic::FidelityBestLocation;
+  settings.lookaheadHeuristic = LookaheadHeuristic::None;
+  settings.initialLayout      = InitialLayout::GraphIsomorphism;
+  settings.preMappingOptimizations  = false;
+  settings.postMappingOptimizations = false;
+  auto mapper = std::make_unique<HeuristicMapper>(qc, architecture);
+  mapper->map(settings);
+  EXPECT_EQ(mapper->getResults().output.swaps, 0);
+
+  // all gates are executed on the most reliable edge right away
+  std::stringstream qasm{};
+  mapper->dumpResult(qasm, qc::Format::OpenQASM3);
+  auto qcMapped = qc::QuantumComputation();
+  qcMapped.import(qasm, qc::Format::OpenQASM3);
+  for (const auto& op : qcMapped) {
+    if (op->getType() == qc::X && op->getNcontrols() == 1) {
+      const auto control = op->getControls().begin()->qubit;
+      const auto target  = op->getTargets().front();
+      EXPECT_EQ(std::min(control, target), 2);
+      EXPECT_EQ(std::max(control, target), 3);
+    }
+  }
+}
+
+TEST(Functionality, SabreUnsupportedSettings) {
+  qc::QuantumComputation qc{3};
+  qc.h(1);
+  qc.cx(0, 2);
+  Architecture arch{3, {{0, 1}, {1, 0}, {1, 2}, {2, 1}}};
+  SabreMapper  mapper(qc, arch);
+
+  Configuration settings{};
+  settings.teleportationQubits = 2;
+  EXPECT_THROW(mapper.map(settings), QMAPException);
+
+  settings                                     = Configuration{};
+  settings.iterativeBidirectionalRouting       = true;
+  settings.iterativeBidirectionalRoutingChains = 2;
+  EXPECT_THROW(mapper.map(settings), QMAPException);
+
+  // the refined initial layout places qubits 0 and 2 next to each other
+  settings.iterativeBidirectionalRoutingChains = 1;
+  mapper.map(settings);
+  EXPECT_EQ(mapper.getResults().output.swaps, 0U);
+
+  settings.initialLayout                 = InitialLayout::Identity;
+  settings.iterativeBidirectionalRouting = false;
+  mapper.map(settings);
+  EXPECT_EQ(mapper.getResults().output.swaps, 1U);
+}
+
+TEST(Functionality, UniquePriorityQueue) {
+  // elements are (key, cost) pairs, unique by key, ordered by ascending cost
+  using Element = std::pair<int, int>;
+  struct CostCompare {
+    bool operator()(const Element& x, const Element& y) const {
+      return x.second > y.second;
+    }
+  };
+  struct KeyHash {
+    std::size_t operator()(const Element& x) const {
+      // deliberately bad hash to exercise collisions
+      return static_cast<std::size_t>(x.first % 2);
+    }
+  };
+  struct KeyEqual {
+    bool operator()(const Element& x, const Element& y) const {
+      return x.first == y.first;
+    }
+  };
+  UniquePriorityQueue<Element, CostCompare, KeyHash, KeyEqual> queue{};
+
+  EXPECT_TRUE(queue.empty());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(queue.push({i, 100 + i}));
+  }
+  EXPECT_EQ(queue.size(), 10);
+  EXPECT_EQ(queue.top(), Element(0, 100));
+
+  // duplicates with equal or higher cost are rejected
+  EXPECT_FALSE(queue.push({5, 105}));
+  EXPECT_FALSE(queue.push({5, 200}));
+  EXPECT_EQ(queue.size(), 10);
+
+  // duplicates with lower cost replace the queued element (decrease-key)
+  EXPECT_TRUE(queue.push({7, 50}));
+  EXPECT_TRUE(queue.push({3, 99}));
+  EXPECT_EQ(queue.size(), 10);
+  EXPECT_EQ(queue.top(), Element(7, 50));
+
+  std::vector<Element> order{};
+  while (!queue.empty()) {
+    order.emplace_back(queue.top());
+    queue.pop();
+  }
+  const std::vector<Element> expected{{7, 50},   {3, 99},  {0, 100}, {1, 101},
+                                      {2, 102}, {4, 104}, {5, 105}, {6, 106},
+                                      {8, 108}, {9, 109}};
+  ASSERT_EQ(order.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(order[i].first, expected[i].first);
+    EXPECT_EQ(order[i].second, expected[i].second);
+  }
+
+  // popped elements may be pushed again
+  EXPECT_TRUE(queue.push({7, 300}));
+  EXPECT_EQ(queue.size(), 1);
+  queue.deleteQueue();
+  EXPECT_TRUE(queue.empty());
 }
 
 TEST(Functionality, EmptyDump) {
@@ -1081,6 +2176,10 @@ TEST(Functionality, InvalidSettings) {
   config.layering = Layering::QubitTriangle;
   EXPECT_THROW(mapper.map(config), QMAPException);
   config.layering = Layering::IndividualGates;
+  // non-fidelity-aware heuristic with fidelity-aware lookahead heuristic
+  config.lookaheadHeuristic = LookaheadHeuristic::FidelityBestLocation;
+  EXPECT_THROW(mapper.map(config), QMAPException);
+  config.lookaheadHeuristic = LookaheadHeuristic::GateCountMaxDistance;
   // fidelity-aware heuristic with non-fidelity-aware lookahead heuristic
   config.heuristic = Heuristic::FidelityBestLocation;
   EXPECT_THROW(mapper.map(config), QMAPException);
@@ -1145,6 +2244,32 @@ TEST(Functionality, InvalidCircuits) {
   EXPECT_THROW(mapper3.map(config), QMAPException);
 }
 
+TEST(Functionality, LargeArchitecture) {
+  // architectures are not limited to a fixed maximum number of qubits
+  constexpr std::uint16_t nqubits = 150;
+  CouplingMap             cm{};
+  for (std::uint16_t i = 0; i + 1 < nqubits; ++i) {
+    cm.insert({i, static_cast<std::uint16_t>(i + 1)});
+    cm.insert({static_cast<std::uint16_t>(i + 1), i});
+  }
+  Architecture arch{nqubits, cm};
+
+  qc::QuantumComputation qc{nqubits};
+  qc.cx(130, 140);
+  qc.cx(149, 145);
+
+  HeuristicMapper mapper(qc, arch);
+  Configuration   config{};
+  config.initialLayout    = InitialLayout::Identity;
+  config.layering         = Layering::IndividualGates;
+  config.swapOnFirstLayer = true;
+  mapper.map(config);
+
+  const auto& results = mapper.getResults();
+  EXPECT_EQ(results.output.qubits, nqubits);
+  EXPECT_EQ(results.output.swaps, 12U);
+}
+
 TEST(Functionality, DataLoggerAfterClose) {
   const std::string      dataLoggingPath = "test_log/datalogger_after_close/";
   qc::QuantumComputation qc{3};
@@ -1242,15 +2367,22 @@ TEST(Functionality, DataLogger) {
   const auto archJson = nlohmann::json::parse(archFile);
   EXPECT_EQ(archJson["name"], architecture.getName());
   EXPECT_EQ(archJson["nqubits"], architecture.getNqubits());
-  EXPECT_EQ(archJson["distances"], architecture.getDistanceTable());
+  EXPECT_EQ(archJson["distances"],
+            nestedRows(architecture.getDistanceTable()));
   EXPECT_EQ(archJson["coupling_map"], architecture.getCouplingMap());
   const auto& fidelityJson = archJson["fidelity"];
-  EXPECT_EQ(fidelityJson["fidelity_distances"],
-            architecture.getFidelityDistanceTables());
+  const auto& fidelityDistanceTables =
+      architecture.getFidelityDistanceTables();
+  ASSERT_EQ(fidelityJson["fidelity_distances"].size(),
+            fidelityDistanceTables.size());
+  for (std::size_t i = 0; i < fidelityDistanceTables.size(); ++i) {
+    EXPECT_EQ(fidelityJson["fidelity_distances"][i],
+              nestedRows(fidelityDistanceTables[i]));
+  }
   EXPECT_EQ(fidelityJson["single_qubit_fidelities"],
             architecture.getSingleQubitFidelities());
   EXPECT_EQ(fidelityJson["two_qubit_fidelities"],
-            architecture.getFidelityTable());
+            nestedRows(architecture.getFidelityTable()));
   // json does not support inf values, instead nlohmann::json replaces inf
   // with null
   const auto& singleQubitFidelityCosts =
@@ -1682,6 +2814,54 @@ TEST(Functionality, InitialLayoutDump) {
   EXPECT_TRUE(foundPermutation) << "no initial layout found in mapped circuit";
 }
 
+TEST(Functionality, DeferredSingleQubitGates) {
+  // qubit 2 is acted on before it is placed (and after SWAPs have been
+  // inserted), qubit 4 is only acted on by single-qubit gates
+  qc::QuantumComputation qc{5U};
+  qc.h(2);
+  qc.x(4);
+  qc.cx(0, 1);
+  qc.cx(3, 0);
+  qc.cx(1, 3);
+  qc.h(2);
+  qc.cx(2, 0);
+  qc.h(2);
+  qc.x(4);
+
+  Architecture arch{5U, {{0, 1}, {1, 0}, {1, 2}, {2, 1}, {2, 3}, {3, 2},
+                         {3, 4}, {4, 3}}};
+
+  Configuration config{};
+  config.method                   = Method::Heuristic;
+  config.initialLayout            = InitialLayout::Dynamic;
+  config.layering                 = Layering::IndividualGates;
+  config.postMappingOptimizations = false;
+
+  HeuristicMapper mapper(qc, arch);
+  mapper.map(config);
+
+  // track the logical qubits through the SWAPs of the mapped circuit
+  const auto&                    qcMapped = mapper.getMappedCircuit();
+  std::map<qc::Qubit, qc::Qubit> layout(qcMapped.initialLayout.begin(),
+                                        qcMapped.initialLayout.end());
+  std::size_t                    hadamards = 0U;
+  std::size_t                    nots      = 0U;
+  for (const auto& op : qcMapped) {
+    const auto& targets = op->getTargets();
+    if (op->getType() == qc::SWAP) {
+      std::swap(layout.at(targets.at(0)), layout.at(targets.at(1)));
+    } else if (op->getType() == qc::H) {
+      EXPECT_EQ(layout.at(targets.at(0)), 2U);
+      ++hadamards;
+    } else if (op->getType() == qc::X && op->getControls().empty()) {
+      EXPECT_EQ(layout.at(targets.at(0)), 4U);
+      ++nots;
+    }
+  }
+  EXPECT_EQ(hadamards, 3U);
+  EXPECT_EQ(nots, 2U);
+}
+
 class LayeringTest : public testing::Test {
 protected:
   qc::QuantumComputation           qc{};
@@ -1825,6 +3005,52 @@ TEST_P(HeuristicTest5Q, Identity) {
   SUCCEED() << "Mapping successful";
 }
 
+TEST_P(HeuristicTest5Q, ParallelExpansion) {
+  settings.verbose       = false;
+  settings.initialLayout = InitialLayout::Dynamic;
+  for (auto* arch : {&ibmqYorktown, &ibmqLondon}) {
+    settings.nThreads = 1;
+    HeuristicMapper sequentialMapper(qc, *arch);
+    sequentialMapper.map(settings);
+    const auto&       sequential = sequentialMapper.getResults();
+    std::stringstream sequentialQasm{};
+    sequentialMapper.dumpResult(sequentialQasm, qc::Format::OpenQASM3);
+
+    settings.nThreads = 4;
+    HeuristicMapper parallelMapper(qc, *arch);
+    parallelMapper.map(settings);
+    const auto&       parallel = parallelMapper.getResults();
+    std::stringstream parallelQasm{};
+    parallelMapper.dumpResult(parallelQasm, qc::Format::OpenQASM3);
+
+    EXPECT_EQ(sequentialQasm.str(), parallelQasm.str());
+    EXPECT_EQ(sequential.output.swaps, parallel.output.swaps);
+    EXPECT_EQ(sequential.heuristicBenchmark.expandedNodes,
+              parallel.heuristicBenchmark.expandedNodes);
+    EXPECT_EQ(sequential.heuristicBenchmark.generatedNodes,
+              parallel.heuristicBenchmark.generatedNodes);
+  }
+}
+
+TEST_P(HeuristicTest5Q, Sabre) {
+  settings.verbose       = false;
+  settings.debug         = false;
+  settings.initialLayout = InitialLayout::Dynamic;
+  for (auto* arch : {&ibmqYorktown, &ibmqLondon}) {
+    HeuristicMapper heuristicMapper(qc, *arch);
+    heuristicMapper.map(settings);
+
+    SabreMapper sabreMapper(qc, *arch);
+    sabreMapper.map(settings);
+    const auto& results = sabreMapper.getResults();
+    EXPECT_EQ(results.input.gates, heuristicMapper.getResults().input.gates);
+
+    const auto swaps =
+        expectCnotsOnCouplingMap(sabreMapper, *arch, true).second;
+    EXPECT_EQ(swaps, results.output.swaps);
+  }
+}
+
 TEST_P(HeuristicTest5Q, Static) {
   settings.initialLayout = InitialLayout::Static;
   ibmqYorktownMapper->map(settings);
@@ -1936,6 +3162,29 @@ TEST_P(HeuristicTest20Q, Dynamic) {
   SUCCEED() << "Mapping successful";
 }
 
+TEST_P(HeuristicTest20Q, ParallelExpansion) {
+  // the nodes have enough children on IBMQ Tokyo to be expanded in parallel
+  Configuration settings{};
+  settings.initialLayout = InitialLayout::Dynamic;
+  settings.debug         = true;
+  tokyoMapper->map(settings);
+  const auto        sequential = tokyoMapper->getResults();
+  std::stringstream sequentialQasm{};
+  tokyoMapper->dumpResult(sequentialQasm, qc::Format::OpenQASM3);
+
+  settings.nThreads = 4;
+  HeuristicMapper parallelMapper(qc, arch);
+  parallelMapper.map(settings);
+  const auto&       parallel = parallelMapper.getResults();
+  std::stringstream parallelQasm{};
+  parallelMapper.dumpResult(parallelQasm, qc::Format::OpenQASM3);
+
+  EXPECT_EQ(sequentialQasm.str(), parallelQasm.str());
+  EXPECT_EQ(sequential.output.swaps, parallel.output.swaps);
+  EXPECT_EQ(sequential.heuristicBenchmark.generatedNodes,
+            parallel.heuristicBenchmark.generatedNodes);
+}
+
 class HeuristicTest20QTeleport
     : public testing::TestWithParam<std::tuple<std::uint64_t, std::string>> {
 protected:
@@ -2048,6 +3297,18 @@ TEST_P(HeuristicTestFidelity, Dynamic) {
   SUCCEED() << "Mapping successful";
 }
 
+TEST_P(HeuristicTestFidelity, Lookahead) {
+  Configuration settings{};
+  settings.layering           = Layering::DisjointQubits;
+  settings.initialLayout      = InitialLayout::Static;
+  settings.heuristic          = Heuristic::FidelityBestLocation;
+  settings.lookaheadHeuristic = LookaheadHeuristic::FidelityBestLocation;
+  mapper->map(settings);
+  mapper->dumpResult(GetParam() + "_heuristic_london_fidelity_lookahead.qasm");
+  mapper->printResult(std::cout);
+  expectCnotsOnCouplingMap(*mapper, arch, true);
+}
+
 TEST_P(HeuristicTestFidelity, NoFidelity) {
   Configuration settings{};
   settings.layering           = Layering::DisjointQubits;